@@ -0,0 +1,120 @@
+#include "Benchmarks.h"
+#include "cocoa/core/SizeClassAllocator.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace Cocoa
+{
+	namespace Benchmarks
+	{
+		// Internal Variables
+		// Every thread keeps this many blocks alive and replaces a random one per operation, so the allocator sees a steady
+		// mix of frees and allocations instead of one long run of each
+		static const int m_NumLiveBlocks = 4096;
+		static const int m_NumOperationsPerThread = 1000000;
+
+		// Forward Declarations
+		template<typename AllocateFunc, typename FreeFunc>
+		static void Churn(int numThreads, AllocateFunc allocate, FreeFunc free);
+		static size_t RandomSize(std::mt19937& rng);
+
+		// The same workload through malloc and through SizeClassAllocator, once per thread count. The size class allocator
+		// is meant to pull ahead as threads are added, since its thread caches skip the lock malloc may take. A machine
+		// with fewer cores than threads only measures the scheduler, so the table stops at the number of hardware threads
+		void AllocatorChurn()
+		{
+			int numHardwareThreads = (int)std::thread::hardware_concurrency();
+			numHardwareThreads = numHardwareThreads > 0 ? numHardwareThreads : 1;
+			printf("%d hardware threads, %d live blocks and %d operations per thread\n", numHardwareThreads, m_NumLiveBlocks, m_NumOperationsPerThread);
+			if (numHardwareThreads == 1)
+			{
+				printf("Only one hardware thread, the numbers below say nothing about contention\n");
+			}
+
+			// Exiting threads hand their cached blocks back and flush their counters, so whatever the engine itself has
+			// allocated through the size class allocator has to be all that's left afterwards
+			SizeClassAllocatorStats statsBefore = SizeClassAllocator::GetStats();
+
+			// Powers of two and then the number of hardware threads, in case that isn't one
+			printf("%8s %14s %18s %8s\n", "threads", "malloc (us)", "size class (us)", "speedup");
+			for (int numThreads = 1; numThreads <= numHardwareThreads;
+				numThreads = numThreads < numHardwareThreads && numThreads * 2 > numHardwareThreads ? numHardwareThreads : numThreads * 2)
+			{
+				double mallocTime = Time(3, [&]()
+					{
+						Churn(numThreads, [](size_t numBytes) { return malloc(numBytes); }, [](void* memory) { free(memory); });
+					});
+				double sizeClassTime = Time(3, [&]()
+					{
+						Churn(numThreads, SizeClassAllocator::Allocate, SizeClassAllocator::Free);
+					});
+				printf("%8d %14.1f %18.1f %7.2fx\n", numThreads, mallocTime, sizeClassTime, mallocTime / sizeClassTime);
+			}
+
+			SizeClassAllocatorStats statsAfter = SizeClassAllocator::GetStats();
+			Check(statsAfter.NumAllocations - statsBefore.NumAllocations == statsAfter.NumFrees - statsBefore.NumFrees,
+				"SizeClassAllocator: every allocation got freed.");
+			Check(statsAfter.UsedBlockBytes == statsBefore.UsedBlockBytes && statsAfter.LargeBytes == statsBefore.LargeBytes,
+				"SizeClassAllocator: no memory in use after the benchmark.");
+		}
+
+		// Internal Functions
+		template<typename AllocateFunc, typename FreeFunc>
+		static void Churn(int numThreads, AllocateFunc allocate, FreeFunc free)
+		{
+			std::vector<std::thread> threads;
+			for (int threadIndex = 0; threadIndex < numThreads; threadIndex++)
+			{
+				threads.emplace_back([threadIndex, allocate, free]()
+					{
+						std::mt19937 rng(1337 + threadIndex);
+						std::vector<void*> blocks(m_NumLiveBlocks);
+						for (void*& block : blocks)
+						{
+							block = allocate(RandomSize(rng));
+						}
+
+						for (int op = 0; op < m_NumOperationsPerThread; op++)
+						{
+							void*& block = blocks[rng() % m_NumLiveBlocks];
+							free(block);
+							size_t numBytes = RandomSize(rng);
+							block = allocate(numBytes);
+							// Touch the block, an allocator that hands out memory nobody writes to looks faster than it is
+							*(volatile uint8*)block = (uint8)numBytes;
+						}
+
+						for (void* block : blocks)
+						{
+							free(block);
+						}
+					});
+			}
+
+			for (std::thread& thread : threads)
+			{
+				thread.join();
+			}
+		}
+
+		// Mostly small, the way component arrays, strings and job data are. Now and then a few KB, rarely more than the
+		// largest size class
+		static size_t RandomSize(std::mt19937& rng)
+		{
+			uint32 roll = rng() % 1000;
+			if (roll < 900)
+			{
+				return 8 + rng() % 256;
+			}
+			else if (roll < 995)
+			{
+				return 256 + rng() % 4096;
+			}
+			return 64 * 1024 + rng() % (256 * 1024);
+		}
+	}
+}
@@ -0,0 +1,441 @@
+#include "Benchmarks.h"
+#include "cocoa/util/DynamicArray.h"
+#include "cocoa/util/SmallVector.h"
+#include "cocoa/util/RingBuffer.h"
+#include "cocoa/util/SlotMap.h"
+#include "cocoa/util/HashMap.h"
+
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace Cocoa
+{
+	namespace Benchmarks
+	{
+		// Internal Variables
+		// Every container gets the same number of random operations, with a fixed seed so a failure always reproduces
+		static const int m_NumOperations = 200000;
+		static const uint32 m_Seed = 1337;
+
+		// Forward Declarations
+		static void DynamicArrayMatchesVector();
+		static void SmallVectorMatchesVector();
+		static void RingBufferMatchesDeque();
+		static void SlotMapMatchesUnorderedMap();
+		static void HashMapMatchesUnorderedMap();
+		static void AddingOwnElements();
+
+		// Runs random sequences of operations on each container and on the std container that does the same thing, and
+		// checks after every operation that both still hold the same elements
+		void Containers()
+		{
+			int failedBefore = NumFailedChecks();
+			DynamicArrayMatchesVector();
+			SmallVectorMatchesVector();
+			RingBufferMatchesDeque();
+			SlotMapMatchesUnorderedMap();
+			HashMapMatchesUnorderedMap();
+			AddingOwnElements();
+			printf("%d random operations per container, %s\n", m_NumOperations, NumFailedChecks() == failedBefore ? "all passed" : "see failures above");
+		}
+
+		// Internal Functions
+		static void DynamicArrayMatchesVector()
+		{
+			std::mt19937 rng(m_Seed);
+			DynamicArray<int> array = NDynamicArray::Create<int>();
+			std::vector<int> expected;
+			for (int op = 0; op < m_NumOperations; op++)
+			{
+				int value = (int)rng();
+				int size = (int)expected.size();
+				switch (rng() % 6)
+				{
+				case 0:
+				case 1:
+					NDynamicArray::Add(array, value);
+					expected.push_back(value);
+					break;
+				case 2:
+				{
+					int index = (int)(rng() % (size + 1));
+					NDynamicArray::Insert(array, value, index);
+					expected.insert(expected.begin() + index, value);
+					break;
+				}
+				case 3:
+					if (size > 0)
+					{
+						// Const so it can't be taken for the element overload of Remove
+						const int index = (int)(rng() % size);
+						NDynamicArray::Remove(array, index);
+						expected.erase(expected.begin() + index);
+					}
+					break;
+				case 4:
+					if (size > 0)
+					{
+						int index = (int)(rng() % size);
+						NDynamicArray::RemoveSwap(array, index);
+						expected[index] = expected.back();
+						expected.pop_back();
+					}
+					break;
+				case 5:
+					if (size > 0)
+					{
+						Check(NDynamicArray::Pop(array) == expected.back(), "DynamicArray: Pop returns the last element.");
+						expected.pop_back();
+					}
+					break;
+				}
+
+				if (!Check(array.m_NumElements == (int)expected.size(), "DynamicArray: size matches std::vector.")
+					|| !Check(expected.empty() || memcmp(array.m_Data, expected.data(), sizeof(int) * expected.size()) == 0, "DynamicArray: elements match std::vector."))
+				{
+					break;
+				}
+			}
+			NDynamicArray::Free(array);
+		}
+
+		static void SmallVectorMatchesVector()
+		{
+			std::mt19937 rng(m_Seed);
+			SmallVector<int, 8> vector = NSmallVector::Create<int, 8>();
+			std::vector<int> expected;
+			for (int op = 0; op < m_NumOperations; op++)
+			{
+				int value = (int)rng();
+				int size = (int)expected.size();
+				// Clear now and then so the vector keeps crossing the inline capacity, not just growing on the heap
+				switch (rng() % 7)
+				{
+				case 0:
+				case 1:
+				case 2:
+					NSmallVector::Add(vector, value);
+					expected.push_back(value);
+					break;
+				case 3:
+					if (size > 0)
+					{
+						int index = (int)(rng() % size);
+						NSmallVector::Remove(vector, index);
+						expected.erase(expected.begin() + index);
+					}
+					break;
+				case 4:
+					if (size > 0)
+					{
+						int index = (int)(rng() % size);
+						NSmallVector::RemoveSwap(vector, index);
+						expected[index] = expected.back();
+						expected.pop_back();
+					}
+					break;
+				case 5:
+					if (size > 0)
+					{
+						Check(NSmallVector::Pop(vector) == expected.back(), "SmallVector: Pop returns the last element.");
+						expected.pop_back();
+					}
+					break;
+				case 6:
+					if (rng() % 64 == 0)
+					{
+						NSmallVector::Clear(vector);
+						expected.clear();
+					}
+					break;
+				}
+
+				if (!Check(vector.m_NumElements == (int)expected.size(), "SmallVector: size matches std::vector.")
+					|| !Check(expected.empty() || memcmp(NSmallVector::Data(vector), expected.data(), sizeof(int) * expected.size()) == 0, "SmallVector: elements match std::vector."))
+				{
+					break;
+				}
+			}
+			NSmallVector::Free(vector);
+		}
+
+		static void RingBufferMatchesDeque()
+		{
+			std::mt19937 rng(m_Seed);
+			RingBuffer<int> buffer = NRingBuffer::Create<int>();
+			std::deque<int> expected;
+			for (int op = 0; op < m_NumOperations; op++)
+			{
+				int value = (int)rng();
+				bool empty = expected.empty();
+				switch (rng() % 4)
+				{
+				case 0:
+					NRingBuffer::PushBack(buffer, value);
+					expected.push_back(value);
+					break;
+				case 1:
+					NRingBuffer::PushFront(buffer, value);
+					expected.push_front(value);
+					break;
+				case 2:
+					if (!empty)
+					{
+						Check(NRingBuffer::PopFront(buffer) == expected.front(), "RingBuffer: PopFront returns the front element.");
+						expected.pop_front();
+					}
+					break;
+				case 3:
+					if (!empty)
+					{
+						Check(NRingBuffer::PopBack(buffer) == expected.back(), "RingBuffer: PopBack returns the back element.");
+						expected.pop_back();
+					}
+					break;
+				}
+
+				if (!Check(NRingBuffer::Size(buffer) == (int)expected.size(), "RingBuffer: size matches std::deque."))
+				{
+					break;
+				}
+				// Comparing everything after every operation would make this quadratic, the ends and a random index catch
+				// wrap around bugs just as well
+				if (!expected.empty())
+				{
+					int index = (int)(rng() % expected.size());
+					if (!Check(NRingBuffer::Front(buffer) == expected.front() && NRingBuffer::Back(buffer) == expected.back()
+						&& NRingBuffer::Get(buffer, index) == expected[index], "RingBuffer: elements match std::deque."))
+					{
+						break;
+					}
+				}
+			}
+
+			for (int i = 0; i < (int)expected.size(); i++)
+			{
+				Check(NRingBuffer::Get(buffer, i) == expected[i], "RingBuffer: elements match std::deque at the end.");
+			}
+			NRingBuffer::Free(buffer);
+		}
+
+		static void SlotMapMatchesUnorderedMap()
+		{
+			std::mt19937 rng(m_Seed);
+			SlotMap<int> map = NSlotMap::Create<int>();
+			std::vector<SlotHandle> handles;
+			std::vector<SlotHandle> removedHandles;
+			std::unordered_map<uint64, int> expected;
+			auto key = [](SlotHandle handle) { return ((uint64)handle.Index << 32) | handle.Generation; };
+			for (int op = 0; op < m_NumOperations; op++)
+			{
+				int value = (int)rng();
+				switch (rng() % 4)
+				{
+				case 0:
+				case 1:
+				{
+					SlotHandle handle = NSlotMap::Insert(map, value);
+					Check(expected.find(key(handle)) == expected.end(), "SlotMap: Insert returns a handle that isn't in use.");
+					expected[key(handle)] = value;
+					handles.push_back(handle);
+					break;
+				}
+				case 2:
+					if (!handles.empty())
+					{
+						int index = (int)(rng() % handles.size());
+						SlotHandle handle = handles[index];
+						Check(NSlotMap::Remove(map, handle), "SlotMap: Remove finds a live handle.");
+						expected.erase(key(handle));
+						handles[index] = handles.back();
+						handles.pop_back();
+						removedHandles.push_back(handle);
+					}
+					break;
+				case 3:
+					if (!removedHandles.empty())
+					{
+						// Stale handles must stay dead, even once their slot got reused
+						SlotHandle handle = removedHandles[rng() % removedHandles.size()];
+						Check(!NSlotMap::Contains(map, handle) && NSlotMap::Get(map, handle) == nullptr && !NSlotMap::Remove(map, handle),
+							"SlotMap: removed handles stay invalid.");
+					}
+					break;
+				}
+
+				if (!Check(NSlotMap::Size(map) == (int)expected.size(), "SlotMap: size matches std::unordered_map."))
+				{
+					break;
+				}
+				if (!handles.empty())
+				{
+					SlotHandle handle = handles[rng() % handles.size()];
+					const int* element = NSlotMap::Get(map, handle);
+					if (!Check(element && *element == expected[key(handle)], "SlotMap: Get matches std::unordered_map."))
+					{
+						break;
+					}
+				}
+			}
+
+			// Begin/End walk the dense values, so together they have to hold exactly what's left
+			int64 expectedSum = 0;
+			int64 sum = 0;
+			for (const auto& [handleKey, value] : expected)
+			{
+				expectedSum += value;
+			}
+			for (int* it = NSlotMap::Begin(map); it != NSlotMap::End(map); it++)
+			{
+				sum += *it;
+			}
+			Check(sum == expectedSum, "SlotMap: dense values match std::unordered_map.");
+			NSlotMap::Free(map);
+		}
+
+		static void HashMapMatchesUnorderedMap()
+		{
+			std::mt19937 rng(m_Seed);
+			HashMap<int, int> map = NHashMap::Create<int, int>();
+			HashSet<int> set = NHashSet::Create<int>();
+			std::unordered_map<int, int> expected;
+			for (int op = 0; op < m_NumOperations; op++)
+			{
+				// A small key range so puts overwrite and removes hit, which is where the backward shift delete matters
+				int key = (int)(rng() % 4096);
+				int value = (int)rng();
+				switch (rng() % 5)
+				{
+				case 0:
+				case 1:
+					NHashMap::Put(map, key, value);
+					Check(NHashSet::Add(set, key) == (expected.find(key) == expected.end()), "HashSet: Add reports new keys.");
+					expected[key] = value;
+					break;
+				case 2:
+				{
+					bool removed = expected.erase(key) > 0;
+					Check(NHashMap::Remove(map, key) == removed && NHashSet::Remove(set, key) == removed, "HashMap: Remove matches std::unordered_map.");
+					break;
+				}
+				case 3:
+				{
+					auto it = expected.find(key);
+					const int* element = NHashMap::Get(map, key);
+					bool found = it != expected.end();
+					Check(found ? element && *element == it->second : element == nullptr, "HashMap: Get matches std::unordered_map.");
+					Check(NHashSet::Contains(set, key) == found, "HashSet: Contains matches std::unordered_map.");
+					break;
+				}
+				case 4:
+					if (rng() % 256 == 0)
+					{
+						NHashMap::Clear(map);
+						NHashSet::Clear(set);
+						expected.clear();
+					}
+					break;
+				}
+
+				if (!Check(NHashMap::Size(map) == (int)expected.size() && NHashSet::Size(set) == (int)expected.size(), "HashMap: size matches std::unordered_map."))
+				{
+					break;
+				}
+			}
+
+			int numVisited = 0;
+			NHashMap::ForEach(map, [&](const int& key, int& value)
+				{
+					auto it = expected.find(key);
+					Check(it != expected.end() && it->second == value, "HashMap: ForEach matches std::unordered_map.");
+					numVisited++;
+				});
+			Check(numVisited == (int)expected.size(), "HashMap: ForEach visits every element once.");
+			NHashSet::Free(set);
+			NHashMap::Free(map);
+		}
+
+		// The containers take const T&, which may point into their own storage. Fill each one to capacity so the add
+		// has to grow, then add an element of itself. A copy after the grow would read freed memory
+		static void AddingOwnElements()
+		{
+			for (int size = 1; size <= 1024; size *= 2)
+			{
+				DynamicArray<int> array = NDynamicArray::Create<int>(size);
+				while (array.m_NumElements < array.m_MaxSize)
+				{
+					NDynamicArray::Add(array, array.m_NumElements + 1);
+				}
+				NDynamicArray::Add(array, array.m_Data[0]);
+				Check(array.m_Data[array.m_NumElements - 1] == 1, "DynamicArray: Add copies an element of the array.");
+				while (array.m_NumElements < array.m_MaxSize)
+				{
+					NDynamicArray::Add(array, 0);
+				}
+				NDynamicArray::Insert(array, array.m_Data[array.m_NumElements - 1], 0);
+				Check(array.m_Data[0] == 0 && array.m_Data[1] == 1, "DynamicArray: Insert copies an element of the array.");
+				NDynamicArray::Free(array);
+
+				SmallVector<int, 4> vector = NSmallVector::Create<int, 4>();
+				for (int i = 0; i < size + 3; i++)
+				{
+					NSmallVector::Add(vector, i + 1);
+				}
+				while (vector.m_NumElements < vector.m_MaxSize)
+				{
+					NSmallVector::Add(vector, 0);
+				}
+				NSmallVector::Add(vector, NSmallVector::Get(vector, 0));
+				Check(NSmallVector::Get(vector, vector.m_NumElements - 1) == 1, "SmallVector: Add copies an element of the vector.");
+				NSmallVector::Free(vector);
+
+				RingBuffer<int> buffer = NRingBuffer::Create<int>(size);
+				int capacity = buffer.m_Capacity;
+				while (NRingBuffer::Size(buffer) < buffer.m_Capacity)
+				{
+					NRingBuffer::PushBack(buffer, NRingBuffer::Size(buffer) + 1);
+				}
+				NRingBuffer::PushFront(buffer, NRingBuffer::Back(buffer));
+				NRingBuffer::PushBack(buffer, NRingBuffer::Get(buffer, 1));
+				Check(NRingBuffer::Front(buffer) == capacity && NRingBuffer::Back(buffer) == 1, "RingBuffer: pushes copy an element of the buffer.");
+				NRingBuffer::Free(buffer);
+
+				SlotMap<int> slotMap = NSlotMap::Create<int>(size);
+				SlotHandle first = NSlotMap::Insert(slotMap, 1);
+				while (slotMap.m_Values.m_NumElements < slotMap.m_Values.m_MaxSize)
+				{
+					NSlotMap::Insert(slotMap, 0);
+				}
+				SlotHandle copied = NSlotMap::Insert(slotMap, *NSlotMap::Get(slotMap, first));
+				Check(*NSlotMap::Get(slotMap, copied) == 1, "SlotMap: Insert copies an element of the map.");
+				NSlotMap::Free(slotMap);
+
+				// Insert grows before it looks the key up, so putting a key of the map when it's at its load limit rehashes
+				// and frees the old keys. Alternate new keys with puts of a key that lives in the map to hit every limit
+				HashMap<int, int> hashMap = NHashMap::Create<int, int>();
+				NHashMap::Put(hashMap, 0, 0);
+				for (int i = 1; i <= size; i++)
+				{
+					NHashMap::Put(hashMap, i, i);
+					int slot = 0;
+					while (!hashMap.m_Occupied[slot])
+					{
+						slot++;
+					}
+					int key = hashMap.m_Keys[slot];
+					NHashMap::Put(hashMap, hashMap.m_Keys[slot], hashMap.m_Values[slot] + 1);
+					const int* value = NHashMap::Get(hashMap, key);
+					if (!Check(value && *value == key + 1 && NHashMap::Size(hashMap) == i + 1, "HashMap: Put copies a key of the map."))
+					{
+						break;
+					}
+					NHashMap::Put(hashMap, key, key);
+				}
+				NHashMap::Free(hashMap);
+			}
+		}
+	}
+}
@@ -0,0 +1,95 @@
+#include "Benchmarks.h"
+#include "cocoa/scenes/ComponentGroups.h"
+
+#include <cstdio>
+#include <random>
+
+namespace Cocoa
+{
+	namespace Benchmarks
+	{
+		// Internal Variables
+		// Keeps the compiler from optimizing the loops away
+		static volatile float m_Sink = 0.0f;
+
+		// Forward Declarations
+		static void Populate(entt::registry& registry, int numSprites, bool randomOrder);
+
+		// One pass over every sprite and its transform, once through a view like the render system did before the groups
+		// and once through ComponentGroups::Sprites, which owns both pools
+		void GroupIteration()
+		{
+			printf("%10s  %-14s %14s %14s %8s\n", "sprites", "sprite order", "view (us)", "group (us)", "speedup");
+			for (int numSprites : { 10000, 100000, 1000000 })
+			{
+				for (int randomOrder = 0; randomOrder < 2; randomOrder++)
+				{
+					SceneData viewScene;
+					Populate(viewScene.Registry, numSprites, randomOrder);
+
+					// The groups must exist before any component is added, just like Scene::Init creates them
+					SceneData groupScene;
+					ComponentGroups::Init(groupScene);
+					Populate(groupScene.Registry, numSprites, randomOrder);
+
+					float viewSum = 0.0f;
+					float groupSum = 0.0f;
+					int numRuns = numSprites >= 1000000 ? 10 : 50;
+					double viewTime = Time(numRuns, [&]()
+						{
+							viewSum = 0.0f;
+							viewScene.Registry.view<const SpriteRenderer, const TransformData>().each([&](auto entity, const auto& spriteRenderer, const auto& transform)
+								{
+									viewSum += transform.Position.x * spriteRenderer.m_Color.r + transform.Scale.y;
+								});
+							m_Sink = viewSum;
+						});
+					double groupTime = Time(numRuns, [&]()
+						{
+							groupSum = 0.0f;
+							ComponentGroups::Sprites(groupScene).each([&](auto entity, const auto& transform, const auto& spriteRenderer)
+								{
+									groupSum += transform.Position.x * spriteRenderer.m_Color.r + transform.Scale.y;
+								});
+							m_Sink = groupSum;
+						});
+
+					Check((int)ComponentGroups::Sprites(groupScene).size() == numSprites, "Sprite group holds every sprite.");
+					printf("%10d  %-14s %14.1f %14.1f %7.2fx\n", numSprites, randomOrder ? "random" : "creation", viewTime, groupTime, viewTime / groupTime);
+				}
+			}
+		}
+
+		// Internal Functions
+		static void Populate(entt::registry& registry, int numSprites, bool randomOrder)
+		{
+			// A quarter of the entities only have a transform, so the transform pool isn't just the sprites
+			int numEntities = numSprites + numSprites / 4;
+			std::vector<entt::entity> entities(numEntities);
+			for (int i = 0; i < numEntities; i++)
+			{
+				entities[i] = registry.create();
+				TransformData transform;
+				transform.Position = glm::vec3((float)i, 1.0f, 2.0f);
+				transform.Scale = glm::vec3(1.0f);
+				transform.EulerRotation = glm::vec3(0.0f);
+				registry.emplace<TransformData>(entities[i], transform);
+			}
+
+			// Same seed for both registries, so they end up with the same sprites in the same order
+			std::mt19937 rng(42);
+			std::shuffle(entities.begin(), entities.end(), rng);
+			entities.resize(numSprites);
+			if (!randomOrder)
+			{
+				// Like a freshly loaded scene, where sprites come in the same order as their transforms
+				std::sort(entities.begin(), entities.end());
+			}
+
+			for (entt::entity entity : entities)
+			{
+				registry.emplace<SpriteRenderer>(entity);
+			}
+		}
+	}
+}
@@ -0,0 +1,71 @@
+#include "Benchmarks.h"
+#include "cocoa/core/Memory.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace Cocoa;
+
+struct BenchmarkEntry
+{
+	const char* Name;
+	void (*Run)();
+};
+
+static const BenchmarkEntry m_Benchmarks[] = {
+	{ "Groups", Benchmarks::GroupIteration },
+	{ "Containers", Benchmarks::Containers },
+	{ "Allocator", Benchmarks::AllocatorChurn }
+};
+
+static int m_NumFailedChecks = 0;
+
+namespace Cocoa
+{
+	namespace Benchmarks
+	{
+		bool Check(bool condition, const char* description)
+		{
+			if (!condition)
+			{
+				printf("FAILED: %s\n", description);
+				m_NumFailedChecks++;
+			}
+			return condition;
+		}
+
+		int NumFailedChecks()
+		{
+			return m_NumFailedChecks;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	// Pass names to only run those benchmarks, for example CocoaBenchmarks Groups
+	Memory::Init();
+	for (const BenchmarkEntry& benchmark : m_Benchmarks)
+	{
+		bool selected = argc <= 1;
+		for (int i = 1; i < argc; i++)
+		{
+			selected |= strcmp(argv[i], benchmark.Name) == 0;
+		}
+
+		if (selected)
+		{
+			printf("== %s\n", benchmark.Name);
+			benchmark.Run();
+			printf("\n");
+		}
+	}
+	Memory::Destroy();
+
+	if (Benchmarks::NumFailedChecks() > 0)
+	{
+		printf("%d checks failed.\n", Benchmarks::NumFailedChecks());
+		return 1;
+	}
+	return 0;
+}
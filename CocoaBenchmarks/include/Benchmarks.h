@@ -0,0 +1,36 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include <chrono>
+
+namespace Cocoa
+{
+	// Timings only mean something in the Release or Dist configuration. Debug builds still run every check
+	namespace Benchmarks
+	{
+		// Every benchmark prints its own table
+		void GroupIteration();
+		void Containers();
+		void AllocatorChurn();
+
+		// Reports a failed check and makes the run exit with an error, the run keeps going so all failures show up
+		bool Check(bool condition, const char* description);
+		int NumFailedChecks();
+
+		// Best of numRuns in microseconds, the fastest run is the one the rest of the machine disturbed the least
+		template<typename Func>
+		double Time(int numRuns, Func func)
+		{
+			double best = 0.0;
+			for (int run = 0; run < numRuns; run++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				func();
+				double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+				best = run == 0 || elapsed < best ? elapsed : best;
+			}
+			return best;
+		}
+	}
+}
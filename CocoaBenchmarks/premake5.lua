@@ -0,0 +1,81 @@
+project "CocoaBenchmarks"
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++17"
+    staticruntime "off"
+
+    targetdir ("../bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("../bin-int/" .. outputdir .. "/%{prj.name}")
+
+    files {
+        "include/**.h",
+        "cpp/**.cpp"
+    }
+
+    disablewarnings { 
+        "4251",
+        "4131",
+        "4267"
+    }
+
+    includedirs {
+        "../CocoaEngine",
+        "../CocoaEngine/include",
+        "../CocoaEngine/vendor",
+        "../%{prj.name}/include",
+        "../%{IncludeDir.glm}",
+        "../%{IncludeDir.entt}",
+        "../%{IncludeDir.Box2D}",
+        "../%{IncludeDir.Json}",
+        "../%{IncludeDir.Freetype}",
+    }
+
+    links {
+        "CocoaEngine"
+    }
+
+    defines {
+        "_CRT_SECURE_NO_WARNINGS",
+        "NOMINMAX"
+    }
+
+    filter { "system:windows", "configurations:Debug" }
+        buildoptions "/MDd"        
+
+    filter { "system:windows", "configurations:Release" }
+        buildoptions "/MD"
+
+    filter "system:windows"
+        systemversion "latest"
+
+        postbuildcommands {
+            "copy /y \"$(OutDir)..\\CocoaEngine\\CocoaEngine.dll\" \"$(OutDir)CocoaEngine.dll\"",
+            "copy /y \"$(SolutionDir)CocoaEngine\\vendor\\GLFW\\bin\\%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}\\GLFW\\GLFW.dll\" \"$(OutDir)GLFW.dll\""
+        }
+
+        defines {
+            "_COCOA_PLATFORM_WINDOWS"
+        }
+
+    filter "options:engine-allocator"
+        defines "_COCOA_ENGINE_ALLOCATOR"
+
+    filter "configurations:Debug"
+        defines {
+			"_COCOA_DEBUG",
+			"_COCOA_ENABLE_ASSERTS"
+		}
+        runtime "Debug"
+        symbols "on"
+
+
+    filter "configurations:Release"
+        defines "_COCOA_RELEASE"
+        runtime "Release"
+        optimize "on"
+
+
+    filter "configurations:Dist"
+        defines "_COCOA_DIST"
+        runtime "Release"
+        optimize "on"
@@ -43,6 +43,13 @@ uniform uint uActiveEntityID;
 const float offset = 1.0 / 300.0;
 const float weight = 0.06;
 
+// Msdf atlases store a distance per channel, the median of the three is the real distance.
+// Single channel atlases are swizzled to (r, r, r), so the median is just the distance for them
+float median(float r, float g, float b)
+{
+    return max(min(r, g), min(max(r, g), b));
+}
+
 void main()
 {
     vec4 texColor = vec4(1, 1, 1, 1);
@@ -70,91 +77,91 @@ void main()
         case 1:
             texColor = texture(uTextures[1], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[1], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[1], fTexCoords + offsets[i]).r;
             }
             break;
         case 2:
             texColor = texture(uTextures[2], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[2], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[2], fTexCoords + offsets[i]).r;
             }
             break;
         case 3:
             texColor = texture(uTextures[3], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[3], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[3], fTexCoords + offsets[i]).r;
             }
             break;
         case 4:
             texColor = texture(uTextures[4], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[4], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[4], fTexCoords + offsets[i]).r;
             }
             break;
         case 5:
             texColor = texture(uTextures[5], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[5], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[5], fTexCoords + offsets[i]).r;
             }
             break;
         case 6:
             texColor = texture(uTextures[6], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[6], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[6], fTexCoords + offsets[i]).r;
             }
             break;
         case 7:
             texColor = texture(uTextures[7], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[7], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[7], fTexCoords + offsets[i]).r;
             }
             break;
         case 8:
             texColor = texture(uTextures[8], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[8], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[8], fTexCoords + offsets[i]).r;
             }
             break;
         case 9:
             texColor = texture(uTextures[9], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[9], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[9], fTexCoords + offsets[i]).r;
             }
             break;
         case 10:
             texColor = texture(uTextures[10], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[10], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[10], fTexCoords + offsets[i]).r;
             }
             break;
         case 11:
             texColor = texture(uTextures[11], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[11], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[11], fTexCoords + offsets[i]).r;
             }
             break;
         case 12:
             texColor = texture(uTextures[12], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[12], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[12], fTexCoords + offsets[i]).r;
             }
             break;
         case 13:
             texColor = texture(uTextures[13], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[13], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[13], fTexCoords + offsets[i]).r;
             }
             break;
         case 14:
             texColor = texture(uTextures[14], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[14], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[14], fTexCoords + offsets[i]).r;
             }
             break;
         case 15:
             texColor = texture(uTextures[15], fTexCoords);
             for (int i=0; i < 9; i++) {
-                sampleTex[i] = texture(uTextures[15], fTexCoords + offsets[i]).a;
+                sampleTex[i] = texture(uTextures[15], fTexCoords + offsets[i]).r;
             }
             break;
     }
@@ -169,7 +176,7 @@ void main()
     float aa = 0.49;
 
     if (fTexSlot > 0) {
-        float c = texColor.r;
+        float c = median(texColor.r, texColor.g, texColor.b);
         if (c > midpoint)
         {
             color = fColor;
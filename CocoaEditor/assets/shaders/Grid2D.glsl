@@ -0,0 +1,64 @@
+#type vertex
+#version 330 core
+
+out vec2 fWorldPos;
+
+uniform mat4 uInverseView;
+uniform mat4 uInverseProjection;
+
+void main()
+{
+    // Generate one triangle that covers the whole screen from the vertex id, so no vertex buffer is needed
+    vec2 ndcPos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+    fWorldPos = (uInverseView * uInverseProjection * vec4(ndcPos, 0.0, 1.0)).xy;
+
+    gl_Position = vec4(ndcPos, 0.0, 1.0);
+}
+
+#type fragment
+#version 330 core
+layout (location = 0) out vec4 color;
+layout (location = 1) out uint entityID;
+
+in vec2 fWorldPos;
+
+uniform vec2 uGridSize;
+uniform float uStrokeWidth;
+uniform vec3 uColor;
+uniform int uMajorLineEvery;
+
+// Minor lines start fading out once a cell is smaller than this many pixels on screen
+const float fadeStartPixels = 16.0;
+const float fadeEndPixels = 4.0;
+
+float lineCoverage(vec2 lineOrigin, vec2 cellSize, vec2 pixelSize)
+{
+    // Lines sit at lineOrigin + k * cellSize
+    vec2 distToLine = abs(fract((fWorldPos - lineOrigin) / cellSize + 0.5) - 0.5) * cellSize;
+
+    // Never let a line get thinner than a pixel, otherwise it would shimmer in and out when zoomed out
+    vec2 halfWidth = max(vec2(uStrokeWidth), pixelSize) * 0.5;
+    vec2 coverage = clamp((halfWidth - distToLine) / pixelSize + 0.5, 0.0, 1.0);
+    return max(coverage.x, coverage.y);
+}
+
+float fadeFor(vec2 cellSize, vec2 pixelSize)
+{
+    vec2 cellPixels = cellSize / pixelSize;
+    return smoothstep(fadeEndPixels, fadeStartPixels, min(cellPixels.x, cellPixels.y));
+}
+
+void main()
+{
+    vec2 pixelSize = max(fwidth(fWorldPos), vec2(0.00001));
+    vec2 majorCellSize = uGridSize * float(uMajorLineEvery);
+    // Both grids share one origin so every major line lands on a minor line. Lines sit halfway between cell
+    // centers, the same place the old line based grid drew them
+    vec2 lineOrigin = uGridSize * 0.5;
+
+    float minor = lineCoverage(lineOrigin, uGridSize, pixelSize) * fadeFor(uGridSize, pixelSize);
+    float major = lineCoverage(lineOrigin, majorCellSize, pixelSize) * fadeFor(majorCellSize, pixelSize);
+
+    color = vec4(uColor, max(minor, major));
+    entityID = 0xFFFFFFFFu;
+}
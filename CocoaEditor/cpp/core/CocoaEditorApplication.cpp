@@ -5,6 +5,7 @@
 #include "core/ImGuiLayer.h"
 #include "gui/ImGuiHeader.h"
 #include "editorWindows/InspectorWindow.h"
+#include "editorWindows/AssetWindow.h"
 #include "nativeScripting/SourceFileWatcher.h"
 #include "renderer/Gizmos.h"
 
@@ -12,7 +13,11 @@
 #include "cocoa/util/Settings.h"
 #include "cocoa/systems/RenderSystem.h"
 #include "cocoa/core/AssetManager.h"
+#include "cocoa/renderer/TextureStreamer.h"
+#include "cocoa/renderer/fonts/GlyphCache.h"
+#include "cocoa/core/JobSystem.h"
 #include "cocoa/core/Memory.h"
+#include "cocoa/file/PathId.h"
 
 #include <glad/glad.h>
 #include <nlohmann/json.hpp>
@@ -74,6 +79,12 @@ namespace Cocoa
 			File::CopyFile(defaultScriptCpp, cocoaEngine, "DefaultScript");
 		}
 
+		void Destroy()
+		{
+			// Stops the watcher thread, it reports changes through the path table
+			m_SourceFileWatcher.reset();
+		}
+
 		bool CreateProject(SceneData& scene, const CPath& projectPath, const char* filename)
 		{
 			Settings::General::s_CurrentProject = projectPath;
@@ -296,7 +307,10 @@ namespace Cocoa
 		}
 
 		// Engine initialization
+		Cocoa::JobSystem::Init();
 		Cocoa::AssetManager::Init(0);
+		Cocoa::TextureStreamer::Init();
+		Cocoa::GlyphCache::Init();
 		Cocoa::ProjectWizard::Init();
 		Cocoa::Input::Init();
 
@@ -323,6 +337,19 @@ namespace Cocoa
 		DebugDraw::Destroy();
 		Scene::FreeResources(m_CurrentScene);
 #endif
+
+		// Worker threads have to be joined even in release builds, otherwise they terminate the process on exit
+		EditorLayer::Destroy();
+		AssetWindow::Destroy();
+		TextureStreamer::Destroy();
+		GlyphCache::Destroy();
+		JobSystem::Destroy();
+
+#if _COCOA_DEBUG
+		// Nothing touches assets or paths anymore once every thread is stopped
+		AssetManager::Destroy();
+		NPathId::Destroy();
+#endif
 		
 		// This won't really do anything in release builds
 		Cocoa::Memory::Destroy();
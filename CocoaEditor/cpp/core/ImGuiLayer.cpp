@@ -2,6 +2,8 @@
 #include "core/CocoaEditorApplication.h"
 #include "editorWindows/InspectorWindow.h"
 #include "editorWindows/SceneHeirarchyWindow.h"
+#include "editorWindows/SystemProfilerWindow.h"
+#include "editorWindows/MemoryProfilerWindow.h"
 #include "gui/ImGuiExtended.h"
 #include "gui/FontAwesome.h"
 #include "util/Settings.h"
@@ -127,6 +129,14 @@ namespace Cocoa
 				{
 					ImGui::ShowDemoWindow(&Settings::Editor::ShowDemoWindow);
 				}
+				if (Settings::Editor::ShowSystemProfiler)
+				{
+					SystemProfilerWindow::ImGui(&Settings::Editor::ShowSystemProfiler);
+				}
+				if (Settings::Editor::ShowMemoryProfiler)
+				{
+					MemoryProfilerWindow::ImGui(&Settings::Editor::ShowMemoryProfiler);
+				}
 			}
 			else
 			{
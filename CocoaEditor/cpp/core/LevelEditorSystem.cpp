@@ -74,6 +74,7 @@ namespace Cocoa
 		static void InitComponentIds(SceneData& scene)
 		{
 			NEntity::RegisterComponentType<TransformData>();
+			NEntity::RegisterComponentType<TransformHierarchy>();
 			NEntity::RegisterComponentType<Tag>();
 			NEntity::RegisterComponentType<SpriteRenderer>();
 			NEntity::RegisterComponentType<FontRenderer>();
@@ -135,39 +136,7 @@ namespace Cocoa
 			// Draw grid lines
 			if (Settings::Editor::DrawGrid)
 			{
-				TransformData& cameraTransform = scene.SceneCamera.Transform;
-				float cameraZoom = scene.SceneCamera.Zoom;
-				float gridWidth = Settings::Editor::GridSize.x;
-				float gridHeight = Settings::Editor::GridSize.y;
-				float projectionWidth = scene.SceneCamera.ProjectionSize.x;
-				float projectionHeight = scene.SceneCamera.ProjectionSize.y;
-
-				float firstX = (float)(((int)(cameraTransform.Position.x - cameraZoom * projectionWidth / 2.0f) / gridWidth) - 1) * (float)gridWidth;
-				float firstY = (float)(((int)(cameraTransform.Position.y - cameraZoom * projectionHeight / 2.0f) / gridHeight) - 1) * (float)gridHeight;
-
-				int yLinesNeeded = (int)((cameraZoom * projectionWidth + gridWidth) / gridWidth);
-				int xLinesNeeded = (int)((cameraZoom * projectionHeight + gridHeight) / gridHeight);
-
-				for (int i = 0; i < yLinesNeeded; i++)
-				{
-					float x = (i * gridWidth) + firstX + (gridWidth / 2.0f);
-					float y = (i * gridHeight) + firstY + (gridHeight / 2.0f);
-
-					float y0 = firstY - gridHeight;
-					float y1 = firstY + projectionHeight + gridHeight;
-					glm::vec2 from(x, y0);
-					glm::vec2 to(x, y1);
-					DebugDraw::AddLine2D(from, to, Settings::Editor::GridStrokeWidth, Settings::Editor::GridColor, 1, false);
-
-					if (i <= xLinesNeeded)
-					{
-						float x0 = firstX - gridWidth;
-						float x1 = firstX + projectionWidth + gridWidth;
-						glm::vec2 from2(x0, y);
-						glm::vec2 to2(x1, y);
-						DebugDraw::AddLine2D(from2, to2, Settings::Editor::GridStrokeWidth, Settings::Editor::GridColor, 1, false);
-					}
-				}
+				DebugDraw::AddGrid2D(Settings::Editor::GridSize, Settings::Editor::GridStrokeWidth, Settings::Editor::GridColor);
 			}
 		}
 
@@ -13,13 +13,27 @@
 #include "cocoa/scenes/Scene.h"
 #include "cocoa/renderer/fonts/FontUtil.h"
 
+#include <thread>
+#include <atomic>
+
 namespace Cocoa
 {
 	namespace AssetWindow
 	{
+		struct FontImport
+		{
+			std::thread Worker;
+			std::atomic<int> GlyphsCompleted;
+			std::atomic<bool> Finished;
+			int NumGlyphs;
+			Font GeneratedFont;
+			CPath OutputTexture;
+		};
+
 		// Internal Variables
 		static glm::vec2 m_ButtonSize{ 128, 128 };
 		static AssetView m_CurrentView = AssetView::TextureBrowser;
+		static FontImport m_FontImport;
 
 		// Forward declarations
 		static void ShowMenuBar();
@@ -29,9 +43,12 @@ namespace Cocoa
 		static void ShowFontBrowser();
 		static bool IconButton(const char* icon, const char* label, const glm::vec2& size);
 		static bool ImageButton(const Texture& texture, const char* label, const glm::vec2& size);
+		static void UpdateFontImport();
 
 		void ImGui(SceneData& scene)
 		{
+			UpdateFontImport();
+
 			ImGui::Begin("Assets");
 			ShowMenuBar();
 
@@ -143,7 +160,7 @@ namespace Cocoa
 					Texture texSpec;
 					texSpec.IsDefault = false;
 					texSpec.MagFilter = FilterMode::Nearest;
-					texSpec.MinFilter = FilterMode::Nearest;
+					texSpec.MinFilter = FilterMode::NearestMipmapNearest;
 					texSpec.WrapS = WrapMode::Repeat;
 					texSpec.WrapT = WrapMode::Repeat;
 					AssetManager::LoadTextureFromFile(texSpec, NCPath::CreatePath(result.filepath));
@@ -231,16 +248,58 @@ namespace Cocoa
 				static int upscaleResolution = 4096;
 				CImGui::UndoableDragInt("Upscale Resolution: ", upscaleResolution);
 
+				// Msdf keeps corners sharp, so it looks as good as a plain sdf generated at a much larger font size
+				static bool multiChannel = false;
+				CImGui::Checkbox("Multi-channel (MSDF): ", &multiChannel);
+
 				ImGui::NewLine();
-				if (CImGui::Button("Generate Font", { 0, 0 }, false))
+				if (m_FontImport.Worker.joinable())
 				{
-					AssetManager::LoadFontFromTtfFile(NCPath::CreatePath(fontPath), fontSize, outputTexture, glyphRangeStart, glyphRangeEnd, padding, upscaleResolution);
-					ImGui::CloseCurrentPopup();
+					int glyphsCompleted = m_FontImport.GlyphsCompleted.load();
+					float progress = m_FontImport.NumGlyphs > 0 ? (float)glyphsCompleted / (float)m_FontImport.NumGlyphs : 1.0f;
+					std::string progressText = std::to_string(glyphsCompleted) + "/" + std::to_string(m_FontImport.NumGlyphs) + " glyphs";
+					ImGui::ProgressBar(progress, ImVec2(-1, 0), progressText.c_str());
+				}
+				else if (CImGui::Button("Generate Font", { 0, 0 }, false))
+				{
+					CPath fontFile = NCPath::CreatePath(fontPath);
+					CPath absPath = File::GetAbsolutePath(fontFile);
+					m_FontImport.GlyphsCompleted = 0;
+					m_FontImport.Finished = false;
+					m_FontImport.NumGlyphs = glyphRangeEnd - glyphRangeStart;
+					m_FontImport.GeneratedFont = Font{ absPath, false };
+					m_FontImport.OutputTexture = outputTexture;
+
+					// The glyphs are generated on the job system, this thread just waits on them so the editor keeps drawing
+					m_FontImport.Worker = std::thread([fontFile, outputTexture, size = fontSize, start = glyphRangeStart, end = glyphRangeEnd, pad = padding, upscale = upscaleResolution,
+						fieldType = multiChannel ? DistanceFieldType::Msdf : DistanceFieldType::Sdf]()
+						{
+							m_FontImport.GeneratedFont.GenerateSdf(fontFile, size, outputTexture, start, end, pad, upscale, &m_FontImport.GlyphsCompleted, fieldType);
+							m_FontImport.Finished = true;
+						});
 				}
 				ImGui::EndPopup();
 			}
 		}
 
+		static void UpdateFontImport()
+		{
+			if (m_FontImport.Worker.joinable() && m_FontImport.Finished)
+			{
+				m_FontImport.Worker.join();
+				AssetManager::LoadGeneratedFont(m_FontImport.GeneratedFont, m_FontImport.OutputTexture);
+			}
+		}
+
+		void Destroy()
+		{
+			if (m_FontImport.Worker.joinable())
+			{
+				m_FontImport.Worker.join();
+				m_FontImport.GeneratedFont.Free();
+			}
+		}
+
 		static void ShowSceneBrowser(SceneData& scene)
 		{
 			CPath scenesPath = Settings::General::s_WorkingDirectory;
@@ -33,18 +33,18 @@ namespace Cocoa
 		// Basic components
 		// =====================================================================
 		static void ImGuiTag(Tag& tag);
-		static void ImGuiTransform(TransformData& transform);
+		static void ImGuiTransform(Entity entity);
 
 		// =====================================================================
 		// Renderer components
 		// =====================================================================
-		static void ImGuiSpriteRenderer(SpriteRenderer& spr);
-		static void ImGuiFontRenderer(FontRenderer& fontRenderer);
+		static void ImGuiSpriteRenderer(Entity entity);
+		static void ImGuiFontRenderer(Entity entity);
 
 		// =====================================================================
 		// Physics components
 		// =====================================================================
-		static void ImGuiRigidbody2D(Rigidbody2D& rb);
+		static void ImGuiRigidbody2D(Entity entity);
 		static void ImGuiAABB(AABB& box);
 		static void ImGuiBox2D(Box2D& box);
 		static void ImGuiCircle(Circle& circle);
@@ -85,13 +85,13 @@ namespace Cocoa
 			if (doTag)
 				ImGuiTag(NEntity::GetComponent<Tag>(ActiveEntities[0]));
 			if (doTransform)
-				ImGuiTransform(NEntity::GetComponent<TransformData>(ActiveEntities[0]));
+				ImGuiTransform(ActiveEntities[0]);
 			if (doSpriteRenderer)
-				ImGuiSpriteRenderer(NEntity::GetComponent<SpriteRenderer>(ActiveEntities[0]));
+				ImGuiSpriteRenderer(ActiveEntities[0]);
 			if (doFontRenderer)
-				ImGuiFontRenderer(NEntity::GetComponent<FontRenderer>(ActiveEntities[0]));
+				ImGuiFontRenderer(ActiveEntities[0]);
 			if (doRigidbody2D)
-				ImGuiRigidbody2D(NEntity::GetComponent<Rigidbody2D>(ActiveEntities[0]));
+				ImGuiRigidbody2D(ActiveEntities[0]);
 			if (doBox2D)
 				ImGuiBox2D(NEntity::GetComponent<Box2D>(ActiveEntities[0]));
 			if (doAABB)
@@ -191,36 +191,23 @@ namespace Cocoa
 				strcpy(StringBuffer, tag.Name);
 				if (CImGui::InputText("Entity Name: ", StringBuffer, sizeof(StringBuffer)))
 				{
-					int newTextSize = strlen(StringBuffer);
-					int newTextSizeWithNullChar = newTextSize + 1;
-					// We keep it as char* until we the new string over the pointer, then we assign a new immutable 
-					// const char* to the tag
-					char* newTagName = nullptr;
-					if (tag.IsHeapAllocated)
-					{
-						newTagName = (char*)ReallocMem((void*)tag.Name, sizeof(char) * newTextSizeWithNullChar);
-					}
-					else
-					{
-						newTagName = (char*)AllocMem(sizeof(char) * newTextSizeWithNullChar);
-						tag.IsHeapAllocated = true;
-					}
-					strcpy(newTagName, StringBuffer);
-					tag.Name = newTagName;
+					NTag::SetName(tag, StringBuffer);
 				}
 				CImGui::EndCollapsingHeaderGroup();
 			}
 		}
 
-		static void ImGuiTransform(TransformData& transform)
+		// Transforms, sprites, fonts and rigidbodies sit in entt groups that reorder their pools, so their undoable fields
+		// are edited through the entity instead of a reference
+		static void ImGuiTransform(Entity entity)
 		{
 			static bool collapsingHeaderOpen = true;
 			if (ImGui::CollapsingHeader(ICON_FA_STAMP " Transform"))
 			{
 				CImGui::BeginCollapsingHeaderGroup();
-				CImGui::UndoableDragFloat3("Position: ", transform.Position);
-				CImGui::UndoableDragFloat3("Scale: ", transform.Scale);
-				CImGui::UndoableDragFloat3("Rotation: ", transform.EulerRotation);
+				CImGui::UndoableDragFloat3("Position: ", entity, &TransformData::Position);
+				CImGui::UndoableDragFloat3("Scale: ", entity, &TransformData::Scale);
+				CImGui::UndoableDragFloat3("Rotation: ", entity, &TransformData::EulerRotation);
 				CImGui::EndCollapsingHeaderGroup();
 			}
 		}
@@ -229,20 +216,22 @@ namespace Cocoa
 		// =====================================================================
 		// Renderer components
 		// =====================================================================
-		static void ImGuiSpriteRenderer(SpriteRenderer& spr)
+		static void ImGuiSpriteRenderer(Entity entity)
 		{
 			static bool collapsingHeaderOpen = true;
 			if (ImGui::CollapsingHeader("Sprite Renderer"))
 			{
 				CImGui::BeginCollapsingHeaderGroup();
-				CImGui::UndoableDragInt("Z-Index: ", spr.m_ZIndex);
-				CImGui::UndoableColorEdit4("Sprite Color: ", spr.m_Color);
+				CImGui::UndoableDragInt("Z-Index: ", entity, &SpriteRenderer::m_ZIndex);
+				CImGui::UndoableColorEdit4("Sprite Color: ", entity, &SpriteRenderer::m_Color);
+
+				SpriteRenderer& spr = NEntity::GetComponent<SpriteRenderer>(entity);
 
 				if (spr.m_Sprite.m_Texture)
 				{
-					const Texture& tex = AssetManager::GetTexture(spr.m_Sprite.m_Texture.m_AssetId);
-					CImGui::InputText("##SpriteRendererTexture", (char*)NCPath::Filename(tex.Path),
-						NCPath::FilenameSize(tex.Path), ImGuiInputTextFlags_ReadOnly);
+					const CPath& texPath = AssetManager::GetTexturePath(spr.m_Sprite.m_Texture.m_AssetId);
+					CImGui::InputText("##SpriteRendererTexture", (char*)NCPath::Filename(texPath),
+						NCPath::FilenameSize(texPath), ImGuiInputTextFlags_ReadOnly);
 				}
 				else
 				{
@@ -263,15 +252,22 @@ namespace Cocoa
 			}
 		}
 
-		static void ImGuiFontRenderer(FontRenderer& fontRenderer)
+		static void ImGuiFontRenderer(Entity entity)
 		{
 			static bool collapsingHeaderOpen = true;
 			if (ImGui::CollapsingHeader("Font Renderer"))
 			{
 				CImGui::BeginCollapsingHeaderGroup();
-				CImGui::UndoableDragInt("Z-Index: ##fonts", fontRenderer.m_ZIndex);
-				CImGui::UndoableColorEdit4("Font Color: ", fontRenderer.m_Color);
-				CImGui::UndoableDragInt("Font Size: ", fontRenderer.fontSize);
+				CImGui::UndoableDragInt("Z-Index: ##fonts", entity, &FontRenderer::m_ZIndex);
+				CImGui::UndoableColorEdit4("Font Color: ", entity, &FontRenderer::m_Color);
+				CImGui::UndoableDragInt("Font Size: ", entity, &FontRenderer::fontSize);
+				CImGui::UndoableDragFloat("Wrap Width: ", entity, &FontRenderer::m_WrapWidth);
+				CImGui::UndoableDragFloat("Line Spacing: ", entity, &FontRenderer::m_LineSpacing);
+
+				std::array<const char*, 3> alignments = { "Left", "Center", "Right" };
+				CImGui::UndoableCombo<TextAlignment>(entity, &FontRenderer::m_Alignment, "Alignment: ", &alignments[0], (int)alignments.size());
+
+				FontRenderer& fontRenderer = NEntity::GetComponent<FontRenderer>(entity);
 
 				Log::Assert(fontRenderer.text.size() < STRING_BUFFER_MAX, "Font Renderer only supports text sizes up to 100 characters.");
 				strcpy(StringBuffer, fontRenderer.text.c_str());
@@ -309,7 +305,7 @@ namespace Cocoa
 		// =====================================================================
 		// Physics components
 		// =====================================================================
-		static void ImGuiRigidbody2D(Rigidbody2D& rb)
+		static void ImGuiRigidbody2D(Entity entity)
 		{
 			static bool treeNodeOpen = true;
 			ImGui::SetNextTreeNodeOpen(treeNodeOpen);
@@ -317,16 +313,16 @@ namespace Cocoa
 			{
 				CImGui::BeginCollapsingHeaderGroup();
 
-				int currentItem = static_cast<int>(rb.m_BodyType);
 				std::array<const char*, 3> items = { "Dynamic", "Kinematic", "Static" };
-				CImGui::UndoableCombo<BodyType2D>(rb.m_BodyType, "Body Type:", &items[0], (int)items.size());
+				CImGui::UndoableCombo<BodyType2D>(entity, &Rigidbody2D::m_BodyType, "Body Type:", &items[0], (int)items.size());
 
+				Rigidbody2D& rb = NEntity::GetComponent<Rigidbody2D>(entity);
 				CImGui::Checkbox("Continous: ##0", &rb.m_ContinuousCollision);
 				CImGui::Checkbox("Fixed Rotation##1", &rb.m_FixedRotation);
-				CImGui::UndoableDragFloat("Linear Damping: ##2", rb.m_LinearDamping);
-				CImGui::UndoableDragFloat("Angular Damping: ##3", rb.m_AngularDamping);
-				CImGui::UndoableDragFloat("Mass: ##4", rb.m_Mass);
-				CImGui::UndoableDragFloat2("Velocity: ##5", rb.m_Velocity);
+				CImGui::UndoableDragFloat("Linear Damping: ##2", entity, &Rigidbody2D::m_LinearDamping);
+				CImGui::UndoableDragFloat("Angular Damping: ##3", entity, &Rigidbody2D::m_AngularDamping);
+				CImGui::UndoableDragFloat("Mass: ##4", entity, &Rigidbody2D::m_Mass);
+				CImGui::UndoableDragFloat2("Velocity: ##5", entity, &Rigidbody2D::m_Velocity);
 
 				CImGui::EndCollapsingHeaderGroup();
 			}
@@ -0,0 +1,191 @@
+#include "editorWindows/MemoryProfilerWindow.h"
+#include "gui/ImGuiHeader.h"
+#include "gui/ImGuiExtended.h"
+
+#include "cocoa/core/Memory.h"
+#include "cocoa/core/SizeClassAllocator.h"
+#include "cocoa/file/File.h"
+#include "cocoa/file/CPath.h"
+#include "cocoa/util/Settings.h"
+#include "cocoa/util/CMath.h"
+#include "cocoa/util/Log.h"
+
+namespace Cocoa
+{
+	namespace MemoryProfilerWindow
+	{
+		// Internal Variables
+		static const int m_MaxCallsitesShown = 50;
+		static std::vector<AllocationCallsite> m_Callsites;
+
+		// Forward Declarations
+		static void ArenaStatsImGui(const char* name, const ArenaStats& stats);
+		static void AllocatorStatsImGui(const SizeClassAllocatorStats& stats);
+		static void DumpJson(const CPath& outputPath);
+		static const char* ShortFilename(const char* filename);
+
+		void ImGui(bool* open)
+		{
+			if (!ImGui::Begin("Memory Profiler", open))
+			{
+				ImGui::End();
+				return;
+			}
+
+			ArenaStatsImGui("Frame Arena", Memory::GetFrameArenaStats());
+			ArenaStatsImGui("Double Buffered Arenas", Memory::GetDoubleBufferedArenaStats());
+			ArenaStatsImGui("Scratch Stacks", Memory::GetScratchStats());
+			AllocatorStatsImGui(SizeClassAllocator::GetStats());
+			ImGui::Separator();
+
+#if _COCOA_DEBUG
+			Memory::GetAllocationCallsites(m_Callsites);
+			if (CImGui::Button("Dump to Json"))
+			{
+				CPath outputPath = Settings::General::s_WorkingDirectory;
+				NCPath::Join(outputPath, NCPath::CreatePath("memoryStats.json"));
+				DumpJson(outputPath);
+			}
+
+			size_t totalLiveBytes = 0;
+			for (const AllocationCallsite& callsite : m_Callsites)
+			{
+				totalLiveBytes += callsite.LiveBytes;
+			}
+			ImGui::Text("Live: %.2f KB in %d callsites", totalLiveBytes / 1024.0f, (int)m_Callsites.size());
+
+			ImGui::Columns(5);
+			ImGui::Text("Callsite");
+			ImGui::NextColumn();
+			ImGui::Text("Live (KB)");
+			ImGui::NextColumn();
+			ImGui::Text("Peak (KB)");
+			ImGui::NextColumn();
+			ImGui::Text("Blocks (live/total)");
+			ImGui::NextColumn();
+			ImGui::Text("Churn (allocs/frees per frame)");
+			ImGui::NextColumn();
+			ImGui::Separator();
+			int numShown = CMath::Min((int)m_Callsites.size(), m_MaxCallsitesShown);
+			for (int i = 0; i < numShown; i++)
+			{
+				const AllocationCallsite& callsite = m_Callsites[i];
+				ImGui::Text("%s:%d", ShortFilename(callsite.Filename), callsite.Line);
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("%s", callsite.Filename);
+				}
+				ImGui::NextColumn();
+				ImGui::Text("%.2f", callsite.LiveBytes / 1024.0f);
+				ImGui::NextColumn();
+				ImGui::Text("%.2f", callsite.PeakBytes / 1024.0f);
+				ImGui::NextColumn();
+				ImGui::Text("%d/%llu", callsite.LiveAllocations, (unsigned long long)callsite.TotalAllocations);
+				ImGui::NextColumn();
+				ImGui::Text("%d/%d", callsite.AllocationsLastFrame, callsite.FreesLastFrame);
+				ImGui::NextColumn();
+			}
+			ImGui::Columns(1);
+#else
+			ImGui::Text("Allocation tracking is only available in debug builds.");
+#endif
+
+			ImGui::End();
+		}
+
+		// Internal Functions
+		static void ArenaStatsImGui(const char* name, const ArenaStats& stats)
+		{
+			ImGui::Text("%s: %.2f / %.2f KB used, high water mark %.2f KB", name,
+				stats.Used / 1024.0f, stats.Capacity / 1024.0f, stats.HighWaterMark / 1024.0f);
+		}
+
+		static void AllocatorStatsImGui(const SizeClassAllocatorStats& stats)
+		{
+			if (stats.NumAllocations == 0 && stats.NumLargeAllocations == 0)
+			{
+				ImGui::Text("Size Class Allocator: not in use, build with --engine-allocator to enable it");
+				return;
+			}
+
+			// Free space inside the slabs and rounding up to a size class are both memory nobody asked for
+			float slabUsage = stats.SlabBytes > 0 ? (float)stats.UsedBlockBytes / (float)stats.SlabBytes : 0.0f;
+			float roundingWaste = stats.TotalBlockBytes > 0 ? 1.0f - (float)stats.TotalRequestedBytes / (float)stats.TotalBlockBytes : 0.0f;
+			ImGui::Text("Size Class Allocator: %.2f / %.2f KB of slabs used (%.1f%%), %.1f%% lost to rounding",
+				stats.UsedBlockBytes / 1024.0f, stats.SlabBytes / 1024.0f, slabUsage * 100.0f, roundingWaste * 100.0f);
+			ImGui::Text("    %.2f KB in large allocations, %.2f KB cached for reuse",
+				stats.LargeBytes / 1024.0f, stats.CachedSpanBytes / 1024.0f);
+			ImGui::Text("    %llu allocations, %llu frees, %llu large allocations, %llu batch transfers",
+				(unsigned long long)stats.NumAllocations, (unsigned long long)stats.NumFrees,
+				(unsigned long long)stats.NumLargeAllocations, (unsigned long long)stats.NumBatchTransfers);
+		}
+
+		static void DumpJson(const CPath& outputPath)
+		{
+			json callsites = json::array();
+			for (const AllocationCallsite& callsite : m_Callsites)
+			{
+				callsites.push_back({
+					{ "Filename", callsite.Filename },
+					{ "Line", callsite.Line },
+					{ "LiveBytes", callsite.LiveBytes },
+					{ "PeakBytes", callsite.PeakBytes },
+					{ "LiveAllocations", callsite.LiveAllocations },
+					{ "TotalAllocations", callsite.TotalAllocations },
+					{ "AllocationsLastFrame", callsite.AllocationsLastFrame },
+					{ "FreesLastFrame", callsite.FreesLastFrame }
+				});
+			}
+
+			json arenas = json::object();
+			const std::pair<const char*, ArenaStats> arenaStats[] = {
+				{ "FrameArena", Memory::GetFrameArenaStats() },
+				{ "DoubleBufferedArenas", Memory::GetDoubleBufferedArenaStats() },
+				{ "ScratchStacks", Memory::GetScratchStats() }
+			};
+			for (const auto& [name, stats] : arenaStats)
+			{
+				arenas[name] = {
+					{ "Capacity", stats.Capacity },
+					{ "Used", stats.Used },
+					{ "HighWaterMark", stats.HighWaterMark }
+				};
+			}
+
+			SizeClassAllocatorStats allocatorStats = SizeClassAllocator::GetStats();
+			json allocator = {
+				{ "SlabBytes", allocatorStats.SlabBytes },
+				{ "LargeBytes", allocatorStats.LargeBytes },
+				{ "CachedSpanBytes", allocatorStats.CachedSpanBytes },
+				{ "UsedBlockBytes", allocatorStats.UsedBlockBytes },
+				{ "TotalRequestedBytes", allocatorStats.TotalRequestedBytes },
+				{ "TotalBlockBytes", allocatorStats.TotalBlockBytes },
+				{ "NumAllocations", allocatorStats.NumAllocations },
+				{ "NumFrees", allocatorStats.NumFrees },
+				{ "NumLargeAllocations", allocatorStats.NumLargeAllocations },
+				{ "NumBatchTransfers", allocatorStats.NumBatchTransfers }
+			};
+
+			json memoryStats = {
+				{ "Callsites", callsites },
+				{ "Arenas", arenas },
+				{ "SizeClassAllocator", allocator }
+			};
+			File::WriteFile(memoryStats.dump(4).c_str(), outputPath);
+			Log::Info("Wrote memory stats to '%s'", outputPath.Path.c_str());
+		}
+
+		static const char* ShortFilename(const char* filename)
+		{
+			const char* shortFilename = filename;
+			for (const char* c = filename; *c != '\0'; c++)
+			{
+				if (*c == '/' || *c == '\\')
+				{
+					shortFilename = c + 1;
+				}
+			}
+			return shortFilename;
+		}
+	}
+}
@@ -159,6 +159,16 @@ namespace Cocoa
 						Settings::Editor::ShowDemoWindow = true;
 					}
 
+					if (CImGui::MenuButton("Show System Profiler"))
+					{
+						Settings::Editor::ShowSystemProfiler = true;
+					}
+
+					if (CImGui::MenuButton("Show Memory Profiler"))
+					{
+						Settings::Editor::ShowMemoryProfiler = true;
+					}
+
 					ImGui::EndMenu();
 				}
 
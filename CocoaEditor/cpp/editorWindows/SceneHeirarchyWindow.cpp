@@ -42,7 +42,7 @@ namespace Cocoa
 
 		// Private functions
 		static bool DoTreeNode(SceneTreeMetadata& element, TransformData& transform, Tag& entityTag, SceneData& scene, SceneTreeMetadata& nextElement);
-		static bool IsDescendantOf(Entity childEntity, Entity parentEntity);
+		static void AddSubtree(Entity entity, int level);
 		static bool ImGuiSceneHeirarchyWindow(SceneData& scene, int* inBetweenIndex);
 		static void AddElementAsChild(int parentIndex, int newChildIndex);
 		static void MoveTreeTo(int treeToMoveIndex, int placeToMoveToIndex, bool reparent = true);
@@ -66,9 +66,8 @@ namespace Cocoa
 		void AddNewEntity(Entity entity)
 		{
 			// TODO: Consider making entity creation a message then subscribing to this message type
-			int newIndex = orderedEntities.m_NumElements;
-			NDynamicArray::Add<SceneTreeMetadata>(orderedEntities, SceneTreeMetadata{ entity, 0, newIndex, false });
-			NDynamicArray::Add<SceneTreeMetadata>(orderedEntitiesCopy, SceneTreeMetadata{ entity, 0, newIndex, false });
+			// Duplicated entities come with their children, the tree needs them right below the entity
+			AddSubtree(entity, 0);
 		}
 
 		void ImGui(SceneData& scene)
@@ -146,13 +145,12 @@ namespace Cocoa
 
 		static bool DoTreeNode(SceneTreeMetadata& element, TransformData& parentTransform, Tag& parentTag, SceneData& scene, SceneTreeMetadata& nextElement)
 		{
-			TransformData& nextTransform = NEntity::GetComponent<TransformData>(nextElement.entity);
 			ImGui::PushID(element.index);
 			ImGui::SetNextItemOpen(element.isOpen);
 			bool open = ImGui::TreeNodeEx(parentTag.Name,
 				ImGuiTreeNodeFlags_FramePadding |
 				(element.selected ? ImGuiTreeNodeFlags_Selected : 0) |
-				(nextTransform.Parent == element.entity ? 0 : ImGuiTreeNodeFlags_Leaf) |
+				(Transform::GetParent(nextElement.entity) == element.entity ? 0 : ImGuiTreeNodeFlags_Leaf) |
 				ImGuiTreeNodeFlags_OpenOnArrow |
 				ImGuiTreeNodeFlags_SpanFullWidth,
 				"%s", parentTag.Name);
@@ -192,7 +190,7 @@ namespace Cocoa
 					int childIndex = *(int*)payload->Data;
 					Log::Assert(childIndex >= 0 && childIndex < orderedEntities.m_NumElements, "Invalid payload.");
 					SceneTreeMetadata& childMetadata = orderedEntitiesCopy.m_Data[childIndex];
-					if (!NEntity::IsNull(childMetadata.entity) && !IsDescendantOf(element.entity, childMetadata.entity))
+					if (!NEntity::IsNull(childMetadata.entity) && !Transform::IsDescendantOf(element.entity, childMetadata.entity))
 					{
 						AddElementAsChild(element.index, childIndex);
 					}
@@ -216,11 +214,7 @@ namespace Cocoa
 
 			SceneTreeMetadata& parent = orderedEntitiesCopy.m_Data[parentIndex];
 			SceneTreeMetadata& newChild = orderedEntitiesCopy.m_Data[newChildIndex];
-			TransformData& childTransform = NEntity::GetComponent<TransformData>(newChild.entity);
-			TransformData& parentTransform = NEntity::GetComponent<TransformData>(parent.entity);
-
-			childTransform.Parent = parent.entity;
-			childTransform.LocalPosition = childTransform.Position - parentTransform.Position;
+			Transform::SetParent(newChild.entity, parent.entity);
 			UpdateLevel(newChildIndex, parent.level + 1);
 			int placeToMoveToIndex = parent.index < newChild.index ?
 				parent.index + 1 :
@@ -239,7 +233,7 @@ namespace Cocoa
 
 			SceneTreeMetadata& placeToMoveTo = orderedEntitiesCopy.m_Data[placeToMoveToIndex];
 			SceneTreeMetadata& treeToMove = orderedEntitiesCopy.m_Data[treeToMoveIndex];
-			if (IsDescendantOf(placeToMoveTo.entity, treeToMove.entity))
+			if (Transform::IsDescendantOf(placeToMoveTo.entity, treeToMove.entity))
 			{
 				return;
 			}
@@ -251,22 +245,17 @@ namespace Cocoa
 
 			if (reparent)
 			{
-				TransformData& treeToMoveTransform = NEntity::GetComponent<TransformData>(treeToMove.entity);
-				TransformData& placeToMoveToTransform = NEntity::GetComponent<TransformData>(placeToMoveTo.entity);
-				TransformData& newParentTransform = !NEntity::IsNull(placeToMoveToTransform.Parent) ?
-					NEntity::GetComponent<TransformData>(placeToMoveToTransform.Parent) :
-					Transform::CreateTransform();
+				Entity newParent = Transform::GetParent(placeToMoveTo.entity);
 
 				// Check if parent is open or closed, if they are closed then we want to use their parent and level
-				if (!NEntity::IsNull(placeToMoveToTransform.Parent))
+				if (!NEntity::IsNull(newParent))
 				{
 					// Need to start at the root and go down until you find a closed parent and thats the correct new parent
 					// TODO: Not sure if this is the actual root of the problem
 				}
 
 				UpdateLevel(treeToMove.index, placeToMoveTo.level);
-				treeToMoveTransform.Parent = placeToMoveToTransform.Parent;
-				treeToMoveTransform.LocalPosition = treeToMoveTransform.Position - newParentTransform.Position;
+				Transform::SetParent(treeToMove.entity, newParent);
 			}
 
 			// Temporarily copy the tree we are about to move
@@ -295,7 +284,7 @@ namespace Cocoa
 				// then we have to move that whole tree up to compensate...
 				if (placeToMoveToIndex + 1 < orderedEntitiesCopy.m_NumElements)
 				{
-					if (IsDescendantOf(
+					if (Transform::IsDescendantOf(
 						orderedEntitiesCopy.m_Data[placeToMoveToIndex + 1].entity,
 						orderedEntitiesCopy.m_Data[placeToMoveToIndex].entity))
 					{
@@ -468,19 +457,15 @@ namespace Cocoa
 			return numChildren;
 		}
 
-		static bool IsDescendantOf(Entity childEntity, Entity parentEntity)
+		static void AddSubtree(Entity entity, int level)
 		{
-			TransformData& childTransform = NEntity::GetComponent<TransformData>(childEntity);
-			Tag& childTag = NEntity::GetComponent<Tag>(childEntity);
-			if (childTransform.Parent == parentEntity || childEntity == parentEntity)
-			{
-				return true;
-			}
-			else if (!NEntity::IsNull(childTransform.Parent))
+			int newIndex = orderedEntities.m_NumElements;
+			NDynamicArray::Add<SceneTreeMetadata>(orderedEntities, SceneTreeMetadata{ entity, level, newIndex, false });
+			NDynamicArray::Add<SceneTreeMetadata>(orderedEntitiesCopy, SceneTreeMetadata{ entity, level, newIndex, false });
+			for (Entity child = Transform::GetFirstChild(entity); !NEntity::IsNull(child); child = Transform::GetNextSibling(child))
 			{
-				return IsDescendantOf(childTransform.Parent, parentEntity);
+				AddSubtree(child, level + 1);
 			}
-			return false;
 		}
 
 		static bool ImGuiSceneHeirarchyWindow(SceneData& scene, int* inBetweenIndex)
@@ -0,0 +1,53 @@
+#include "editorWindows/SystemProfilerWindow.h"
+#include "gui/ImGuiHeader.h"
+
+#include "cocoa/systems/SystemScheduler.h"
+
+namespace Cocoa
+{
+	namespace SystemProfilerWindow
+	{
+		void ImGui(bool* open)
+		{
+			if (!ImGui::Begin("System Profiler", open))
+			{
+				ImGui::End();
+				return;
+			}
+
+			const std::vector<SystemTiming>& timings = SystemScheduler::GetTimings();
+			float totalMilliseconds = 0.0f;
+			ImGui::Columns(3);
+			ImGui::Text("System");
+			ImGui::NextColumn();
+			ImGui::Text("Last (ms)");
+			ImGui::NextColumn();
+			ImGui::Text("Average (ms)");
+			ImGui::NextColumn();
+			ImGui::Separator();
+			for (const SystemTiming& timing : timings)
+			{
+				// Exclusive systems stall every worker, so they're worth pointing out
+				if (timing.Exclusive)
+				{
+					ImGui::Text("%s (exclusive)", timing.Name.c_str());
+				}
+				else
+				{
+					ImGui::Text("%s", timing.Name.c_str());
+				}
+				ImGui::NextColumn();
+				ImGui::Text("%.3f", timing.Milliseconds);
+				ImGui::NextColumn();
+				ImGui::Text("%.3f", timing.AverageMilliseconds);
+				ImGui::NextColumn();
+				totalMilliseconds += timing.Milliseconds;
+			}
+			ImGui::Columns(1);
+			ImGui::Separator();
+			ImGui::Text("Sum of all systems: %.3f ms", totalMilliseconds);
+
+			ImGui::End();
+		}
+	}
+}
@@ -9,9 +9,8 @@
 namespace CImGui
 {
 	static float textPadding = 0;
-	bool UndoableColorEdit4(const char* label, glm::vec4& color)
+	static void Label(const char* label)
 	{
-		glm::vec4 tmp = glm::vec4(color);
 		ImGui::Text(label);
 
 		if (ImGui::GetItemRectSize().x > textPadding)
@@ -20,7 +19,81 @@ namespace CImGui
 		}
 
 		ImGui::SameLine(textPadding);
-		bool result = ImGui::ColorEdit4((std::string("##") + std::string(label)).c_str(), glm::value_ptr(tmp));
+	}
+
+	bool ColorEdit4(const char* label, glm::vec4& color)
+	{
+		Label(label);
+		return ImGui::ColorEdit4((std::string("##") + std::string(label)).c_str(), glm::value_ptr(color));
+	}
+
+	bool DragFloat3(const char* label, glm::vec3& vector)
+	{
+		Label(label);
+		return ImGui::DragFloat3((std::string("##") + std::string(label)).c_str(), glm::value_ptr(vector));
+	}
+
+	bool DragFloat2(const char* label, glm::vec2& vector)
+	{
+		Label(label);
+		return ImGui::DragFloat2((std::string("##") + std::string(label)).c_str(), glm::value_ptr(vector));
+	}
+
+	bool DragFloat(const char* label, float& val)
+	{
+		Label(label);
+		return ImGui::DragFloat((std::string("##") + std::string(label)).c_str(), &val);
+	}
+
+	bool DragInt(const char* label, int& val)
+	{
+		Label(label);
+		return ImGui::DragInt((std::string("##") + std::string(label)).c_str(), &val);
+	}
+
+	bool Combo(const char* label, int& currentItem, const char* const items[], int itemsCount)
+	{
+		ImGui::Text(label);
+		ImGui::SameLine();
+
+		ImGui::PushStyleColor(ImGuiCol_FrameBg, ImGui::GetStyleColorVec4(ImGuiCol_Button));
+		ImGui::PushStyleColor(ImGuiCol_FrameBgHovered, ImGui::GetStyleColorVec4(ImGuiCol_ButtonHovered));
+		ImGui::PushStyleColor(ImGuiCol_FrameBgActive, ImGui::GetStyleColorVec4(ImGuiCol_ButtonActive));
+		ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextInverted));
+		if (!ImGui::BeginCombo((std::string("##") + std::string(label)).c_str(), items[currentItem], ImGuiComboFlags_None))
+		{
+			ImGui::PopStyleColor(4);
+			return false;
+		}
+		ImGui::PopStyleColor(4);
+
+		// Display items
+		bool value_changed = false;
+		for (int i = 0; i < itemsCount; i++)
+		{
+			ImGui::PushID((void*)(intptr_t)i);
+			const bool item_selected = (i == currentItem);
+			const char* item_text = items[i];
+			if (!item_text)
+				item_text = "*Unknown item*";
+			if (ImGui::Selectable(item_text, item_selected))
+			{
+				value_changed = true;
+				currentItem = i;
+			}
+			if (item_selected)
+				ImGui::SetItemDefaultFocus();
+			ImGui::PopID();
+		}
+
+		ImGui::EndCombo();
+		return value_changed;
+	}
+
+	bool UndoableColorEdit4(const char* label, glm::vec4& color)
+	{
+		glm::vec4 tmp = glm::vec4(color);
+		bool result = ColorEdit4(label, tmp);
 		if (result)
 		{
 			Cocoa::CommandHistory::AddCommand(new Cocoa::ChangeVec4Command(color, tmp));
@@ -156,17 +229,8 @@ namespace CImGui
 
 	bool UndoableDragFloat3(const char* label, glm::vec3& vector)
 	{
-		static int uid = 0;
 		glm::vec3 tmp = glm::vec3(vector);
-		ImGui::Text(label);
-
-		if (ImGui::GetItemRectSize().x > textPadding)
-		{
-			textPadding = ImGui::GetItemRectSize().x;
-		}
-
-		ImGui::SameLine(textPadding);
-		bool result = ImGui::DragFloat3((std::string("##") + std::string(label)).c_str(), glm::value_ptr(tmp));
+		bool result = DragFloat3(label, tmp);
 		if (result)
 		{
 			Cocoa::CommandHistory::AddCommand(new Cocoa::ChangeVec3Command(vector, tmp));
@@ -181,15 +245,7 @@ namespace CImGui
 	bool UndoableDragFloat2(const char* label, glm::vec2& vector)
 	{
 		glm::vec2 tmp = glm::vec2(vector);
-		ImGui::Text(label);
-
-		if (ImGui::GetItemRectSize().x > textPadding)
-		{
-			textPadding = ImGui::GetItemRectSize().x;
-		}
-
-		ImGui::SameLine(textPadding);
-		bool result = ImGui::DragFloat2((std::string("##") + std::string(label)).c_str(), glm::value_ptr(tmp));
+		bool result = DragFloat2(label, tmp);
 		if (result)
 		{
 			Cocoa::CommandHistory::AddCommand(new Cocoa::ChangeVec2Command(vector, tmp));
@@ -204,15 +260,7 @@ namespace CImGui
 	bool UndoableDragFloat(const char* label, float& val)
 	{
 		float tmp = val;
-		ImGui::Text(label);
-
-		if (ImGui::GetItemRectSize().x > textPadding)
-		{
-			textPadding = ImGui::GetItemRectSize().x;
-		}
-
-		ImGui::SameLine(textPadding);
-		bool result = ImGui::DragFloat((std::string("##") + std::string(label)).c_str(), &tmp);
+		bool result = DragFloat(label, tmp);
 		if (result)
 		{
 			Cocoa::CommandHistory::AddCommand(new Cocoa::ChangeFloatCommand(val, tmp));
@@ -250,15 +298,7 @@ namespace CImGui
 	bool UndoableDragInt(const char* label, int& val)
 	{
 		int tmp = val;
-		ImGui::Text(label);
-
-		if (ImGui::GetItemRectSize().x > textPadding)
-		{
-			textPadding = ImGui::GetItemRectSize().x;
-		}
-
-		ImGui::SameLine(textPadding);
-		bool result = ImGui::DragInt((std::string("##") + std::string(label)).c_str(), &tmp);
+		bool result = DragInt(label, tmp);
 		if (result)
 		{
 			Cocoa::CommandHistory::AddCommand(new Cocoa::ChangeIntCommand(val, tmp));
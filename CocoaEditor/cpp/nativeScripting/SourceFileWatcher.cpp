@@ -150,14 +150,12 @@ namespace Cocoa
 		}
 	}
 
-	static void FileChanged(const CPath& file)
+	static void FileChanged(PathId file)
 	{
-		CPath generatedDirPath = NCPath::CreatePath(NCPath::GetDirectory(file, -1) + "generated");
-		CPath filePath = generatedDirPath;
-		NCPath::Join(filePath, file);
-		CPath generatedFilePath = rootDir;
-		NCPath::Join(rootDir, generatedDirPath);
-		if (ProcessFile(filePath, generatedFilePath))
+		// Generated headers go into a 'generated' folder next to the source file, same as GenerateInitialClassInformation
+		PathId generatedDir = NPathId::Join(NPathId::Parent(file), "generated");
+		CPath filePath = NPathId::ToCPath(file);
+		if (ProcessFile(filePath, NPathId::ToCPath(generatedDir)))
 		{
 			RunPremake();
 		}
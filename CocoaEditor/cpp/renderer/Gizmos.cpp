@@ -12,6 +12,7 @@
 #include "cocoa/util/CMath.h"
 #include "cocoa/util/Settings.h"
 #include "cocoa/commands/ICommand.h"
+#include "cocoa/commands/ChangeComponentCommand.h"
 #include "cocoa/systems/RenderSystem.h"
 #include "cocoa/components/Spritesheet.h"
 
@@ -153,14 +154,18 @@ namespace Cocoa
 				newPos = startToMouse + originalDragClickPos - mouseOffset;
 			}
 
-			if (NEntity::IsNull(transform.Parent))
+			// Roots with children have a hierarchy component too, but only children get their position from LocalPosition.
+			// Reparenting moves hierarchy components around, so the commands keep the entity instead of a reference
+			Entity entity = NEntity::FromComponent<TransformData>(transform);
+			if (NEntity::IsNull(Transform::GetParent(entity)))
 			{
-				CommandHistory::AddCommand(new ChangeVec3Command(transform.Position, newPos));
+				CommandHistory::AddCommand(new ChangeComponentCommand<TransformData, glm::vec3>(entity, &TransformData::Position, newPos));
 			}
 			else
 			{
-				glm::vec3 newRelPos = (newPos - transform.Position) + transform.LocalPosition;
-				CommandHistory::AddCommand(new ChangeVec3Command(transform.LocalPosition, newRelPos));
+				const TransformHierarchy& hierarchy = NEntity::GetComponent<TransformHierarchy>(entity);
+				glm::vec3 newRelPos = (newPos - transform.Position) + hierarchy.LocalPosition;
+				CommandHistory::AddCommand(new ChangeComponentCommand<TransformHierarchy, glm::vec3>(entity, &TransformHierarchy::LocalPosition, newRelPos));
 			}
 		}
 
@@ -185,7 +190,8 @@ namespace Cocoa
 				delta = glm::vec3(delta.x, 0, 0);
 			}
 
-			CommandHistory::AddCommand(new ChangeVec3Command(transform.Scale, originalScale + delta));
+			Entity entity = NEntity::FromComponent<TransformData>(transform);
+			CommandHistory::AddCommand(new ChangeComponentCommand<TransformData, glm::vec3>(entity, &TransformData::Scale, originalScale + delta));
 		}
 	}
 
@@ -387,7 +393,7 @@ namespace Cocoa
 
 				glm::vec2 normalizedMousePos = Input::NormalizedMousePos();
 				const Framebuffer& mainFramebuffer = RenderSystem::GetMainFramebuffer();
-				uint32 pixel = NFramebuffer::ReadPixelUint32(mainFramebuffer, 1, (uint32)(normalizedMousePos.x * 3840), (uint32)(normalizedMousePos.y * 2160));
+				uint32 pixel = RenderSystem::PickEntityId(scene, (int)(normalizedMousePos.x * mainFramebuffer.Width), (int)(normalizedMousePos.y * mainFramebuffer.Height));
 
 				Entity entity = Scene::GetEntity(scene, pixel);
 				Entity selectedEntity = m_HotGizmo == -1 ? entity : InspectorWindow::GetActiveEntity();
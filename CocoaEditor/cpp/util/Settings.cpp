@@ -11,6 +11,8 @@ namespace Cocoa
 			bool ShowDemoWindow = false;
 			bool ShowSettingsWindow = false;
 			bool ShowStyleSelect = false;
+			bool ShowSystemProfiler = false;
+			bool ShowMemoryProfiler = false;
 
 			// Grid stuff
 			bool SnapToGrid = false;
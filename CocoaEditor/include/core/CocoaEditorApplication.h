@@ -17,6 +17,7 @@ namespace Cocoa
 	namespace EditorLayer
 	{
 		void Init();
+		void Destroy();
 		void OnAttach(SceneData& scene);
 		void OnUpdate(SceneData& scene, float dt);
 		void OnRender(SceneData& scene);
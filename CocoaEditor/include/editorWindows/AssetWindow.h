@@ -18,5 +18,8 @@ namespace Cocoa
 	namespace AssetWindow
 	{
 		void ImGui(SceneData& scene);
+
+		// Waits for any font import that is still running in the background
+		void Destroy();
 	};
 }
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+#include "cocoa/core/Core.h"
+#include "externalLibs.h"
+
+namespace Cocoa
+{
+	namespace MemoryProfilerWindow
+	{
+		void ImGui(bool* open);
+	};
+}
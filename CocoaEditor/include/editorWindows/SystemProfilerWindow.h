@@ -0,0 +1,11 @@
+#pragma once
+#include "cocoa/core/Core.h"
+#include "externalLibs.h"
+
+namespace Cocoa
+{
+	namespace SystemProfilerWindow
+	{
+		void ImGui(bool* open);
+	};
+}
@@ -10,6 +10,7 @@
 
 #include "cocoa/util/Settings.h"
 #include "cocoa/commands/ICommand.h"
+#include "cocoa/commands/ChangeComponentCommand.h"
 #include "cocoa/renderer/Texture.h"
 
 #include <imgui.h>
@@ -25,6 +26,14 @@ namespace CImGui
 		ImGuiInputTextCallback callback = (ImGuiInputTextCallback)0, void* user_data = (void*)0);
 	bool Checkbox(const char* label, bool* checked);
 
+	// Labeled widgets without undo, the value gets edited in place
+	bool ColorEdit4(const char* label, glm::vec4& color);
+	bool DragFloat3(const char* label, glm::vec3& vector);
+	bool DragFloat2(const char* label, glm::vec2& vector);
+	bool DragFloat(const char* label, float& val);
+	bool DragInt(const char* label, int& val);
+	bool Combo(const char* label, int& currentItem, const char* const items[], int itemsCount);
+
 	bool UndoableColorEdit4(const char* label, glm::vec4& color);
 	bool UndoableColorEdit3(const char* label, glm::vec3& color);
 	bool UndoableDragFloat4(const char* label, glm::vec4& vector);
@@ -40,44 +49,74 @@ namespace CImGui
 	bool UndoableCombo(T& enumVal, const char* label, const char* const items[], int items_count)
 	{
 		int current_item = static_cast<int>(enumVal);
-		ImGui::Text(label);
-		ImGui::SameLine();
-
-		ImGui::PushStyleColor(ImGuiCol_FrameBg, ImGui::GetStyleColorVec4(ImGuiCol_Button));
-		ImGui::PushStyleColor(ImGuiCol_FrameBgHovered, ImGui::GetStyleColorVec4(ImGuiCol_ButtonHovered));
-		ImGui::PushStyleColor(ImGuiCol_FrameBgActive, ImGui::GetStyleColorVec4(ImGuiCol_ButtonActive));
-		ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextInverted));
-		if (!ImGui::BeginCombo((std::string("##") + std::string(label)).c_str(), items[current_item], ImGuiComboFlags_None))
+		bool value_changed = Combo(label, current_item, items, items_count);
+		if (value_changed)
 		{
-			ImGui::PopStyleColor(4);
-			return false;
+			Cocoa::CommandHistory::AddCommand(new Cocoa::ChangeEnumCommand<T>(enumVal, static_cast<T>(current_item)));
+			Cocoa::CommandHistory::SetNoMergeMostRecent();
 		}
-		ImGui::PopStyleColor(4);
+		return value_changed;
+	}
 
-		// Display items
-		bool value_changed = false;
-		for (int i = 0; i < items_count; i++)
+	// Same widgets for a field of an entity's component. The undo command looks the component up through the entity,
+	// so it keeps working after entt moved the component around in its pool
+	template<typename Component, typename T>
+	bool AddComponentEdit(bool edited, Cocoa::Entity entity, T Component::* field, const T& newValue)
+	{
+		if (edited)
 		{
-			ImGui::PushID((void*)(intptr_t)i);
-			const bool item_selected = (i == current_item);
-			const char* item_text = items[i];
-			if (!item_text)
-				item_text = "*Unknown item*";
-			if (ImGui::Selectable(item_text, item_selected))
-			{
-				value_changed = true;
-				current_item = i;
-			}
-			if (item_selected)
-				ImGui::SetItemDefaultFocus();
-			ImGui::PopID();
+			Cocoa::CommandHistory::AddCommand(new Cocoa::ChangeComponentCommand<Component, T>(entity, field, newValue));
 		}
+		if (ImGui::IsItemDeactivatedAfterEdit())
+		{
+			Cocoa::CommandHistory::SetNoMergeMostRecent();
+		}
+		return edited;
+	}
 
-		ImGui::EndCombo();
+	template<typename Component>
+	bool UndoableColorEdit4(const char* label, Cocoa::Entity entity, glm::vec4 Component::* field)
+	{
+		glm::vec4 tmp = Cocoa::NEntity::GetComponent<Component>(entity).*field;
+		return AddComponentEdit(ColorEdit4(label, tmp), entity, field, tmp);
+	}
 
+	template<typename Component>
+	bool UndoableDragFloat3(const char* label, Cocoa::Entity entity, glm::vec3 Component::* field)
+	{
+		glm::vec3 tmp = Cocoa::NEntity::GetComponent<Component>(entity).*field;
+		return AddComponentEdit(DragFloat3(label, tmp), entity, field, tmp);
+	}
+
+	template<typename Component>
+	bool UndoableDragFloat2(const char* label, Cocoa::Entity entity, glm::vec2 Component::* field)
+	{
+		glm::vec2 tmp = Cocoa::NEntity::GetComponent<Component>(entity).*field;
+		return AddComponentEdit(DragFloat2(label, tmp), entity, field, tmp);
+	}
+
+	template<typename Component>
+	bool UndoableDragFloat(const char* label, Cocoa::Entity entity, float Component::* field)
+	{
+		float tmp = Cocoa::NEntity::GetComponent<Component>(entity).*field;
+		return AddComponentEdit(DragFloat(label, tmp), entity, field, tmp);
+	}
+
+	template<typename Component>
+	bool UndoableDragInt(const char* label, Cocoa::Entity entity, int Component::* field)
+	{
+		int tmp = Cocoa::NEntity::GetComponent<Component>(entity).*field;
+		return AddComponentEdit(DragInt(label, tmp), entity, field, tmp);
+	}
+
+	template<typename T, typename Component>
+	bool UndoableCombo(Cocoa::Entity entity, T Component::* field, const char* label, const char* const items[], int items_count)
+	{
+		int current_item = static_cast<int>(Cocoa::NEntity::GetComponent<Component>(entity).*field);
+		bool value_changed = Combo(label, current_item, items, items_count);
 		if (value_changed)
 		{
-			Cocoa::CommandHistory::AddCommand(new Cocoa::ChangeEnumCommand<T>(enumVal, static_cast<T>(current_item)));
+			Cocoa::CommandHistory::AddCommand(new Cocoa::ChangeComponentCommand<Component, T>(entity, field, static_cast<T>(current_item)));
 			Cocoa::CommandHistory::SetNoMergeMostRecent();
 		}
 		return value_changed;
@@ -39,6 +39,7 @@ namespace Cocoa
 			source << "#include \"cocoa/util/Log.h\"\n";
 			source << "#include \"cocoa/core/Entity.h\"\n";
 			source << "#include \"cocoa/core/EntityStruct.h\"\n";
+			source << "#include \"cocoa/systems/SystemScheduler.h\"\n";
 
 			const std::filesystem::path base = NCPath::GetDirectory(filepath, -1);
 			for (auto clazz : classes)
@@ -74,6 +75,7 @@ namespace Cocoa
 			source << "\t\tstatic void InitComponentIds(SceneData & scene)\n";
 			source << "\t\t{\n";
 			source << "\t\t\tNEntity::RegisterComponentType<TransformData>();\n";
+			source << "\t\t\tNEntity::RegisterComponentType<TransformHierarchy>();\n";
 			source << "\t\t\tNEntity::RegisterComponentType<Tag>();\n";
 			source << "\t\t\tNEntity::RegisterComponentType<SpriteRenderer>();\n";
 			source << "\t\t\tNEntity::RegisterComponentType<FontRenderer>();\n";
@@ -149,6 +151,45 @@ namespace Cocoa
 			}
 			source << "\t\t}\n";
 
+			// Generate a system for every script class, so scripts that declare what they access can run in parallel
+			for (int i = 0; i < classes.size(); i++)
+			{
+				const char* className = classes[i].m_ClassName.c_str();
+				source << "\n";
+				source << "\t\tstatic void UpdateScriptSystem" << i << "(SceneData& scene, float dt)\n";
+				source << "\t\t{\n";
+				source << "\t\t\tauto view = scene.Registry.view<" << className << ">();\n";
+				source << "\t\t\tfor (auto entity : view)\n";
+				source << "\t\t\t{\n";
+				source << "\t\t\t\tauto& comp = scene.Registry.get<" << className << ">(entity);\n";
+				source << "\t\t\t\tcomp.Update(NEntity::CreateEntity(entity), dt);\n";
+				source << "\t\t\t}\n";
+				source << "\t\t}\n";
+
+				source << "\n";
+				source << "\t\tstatic void EditorUpdateScriptSystem" << i << "(SceneData& scene, float dt)\n";
+				source << "\t\t{\n";
+				source << "\t\t\tauto view = scene.Registry.view<" << className << ">();\n";
+				source << "\t\t\tfor (auto entity : view)\n";
+				source << "\t\t\t{\n";
+				source << "\t\t\t\tauto& comp = scene.Registry.get<" << className << ">(entity);\n";
+				source << "\t\t\t\tcomp.EditorUpdate(NEntity::CreateEntity(entity), dt);\n";
+				source << "\t\t\t}\n";
+				source << "\t\t}\n";
+			}
+
+			// Generate RegisterScriptSystems function
+			source << "\n";
+			source << "\t\textern \"C\" COCOA_SCRIPT void RegisterScriptSystems(std::vector<SystemDefinition>& systems)\n";
+			source << "\t\t{\n";
+			for (int i = 0; i < classes.size(); i++)
+			{
+				const char* className = classes[i].m_ClassName.c_str();
+				source << "\t\t\tsystems.push_back({ \"" << className << "\", SystemOrder::Scripts, UpdateScriptSystem" << i << ", EditorUpdateScriptSystem" << i
+					<< ", SystemScheduler::GetScriptAccess<" << className << ">() });\n";
+			}
+			source << "\t\t}\n";
+
 			// Generate SaveScript function
 			source << "\n";
 			source << "\t\textern \"C\" COCOA_SCRIPT void SaveScripts(entt::registry& registryRef, json& j, SceneData* sceneData)\n";
@@ -16,6 +16,8 @@ namespace Cocoa
             extern bool ShowDemoWindow;
             extern bool ShowSettingsWindow;
             extern bool ShowStyleSelect;
+            extern bool ShowSystemProfiler;
+            extern bool ShowMemoryProfiler;
 
             // Grid stuff
             extern bool SnapToGrid;
@@ -1,4 +1,6 @@
 #include "cocoa/commands/CommandHistory.h"
+#include "cocoa/core/Memory.h"
+#include "cocoa/core/Pool.h"
 
 namespace Cocoa
 {
@@ -6,6 +8,37 @@ namespace Cocoa
 	int CommandHistory::m_CommandSize = 0;
 	int CommandHistory::m_CommandPtr = 0;
 
+	// Commands are small, one pool per 32 bytes of size covers all of them. Bigger ones fall back to the heap
+	static const int m_NumCommandPools = 4;
+	static const size_t m_CommandPoolStep = 32;
+	static BlockPool m_CommandPools[m_NumCommandPools] = {
+		NBlockPool::Create(m_CommandPoolStep * 1),
+		NBlockPool::Create(m_CommandPoolStep * 2),
+		NBlockPool::Create(m_CommandPoolStep * 3),
+		NBlockPool::Create(m_CommandPoolStep * 4)
+	};
+
+	void* ICommand::operator new(size_t size)
+	{
+		int poolIndex = (int)((size + m_CommandPoolStep - 1) / m_CommandPoolStep) - 1;
+		if (poolIndex < m_NumCommandPools)
+		{
+			return NBlockPool::AllocateBlock(m_CommandPools[poolIndex]);
+		}
+		return AllocMem(size);
+	}
+
+	void ICommand::operator delete(void* memory, size_t size)
+	{
+		int poolIndex = (int)((size + m_CommandPoolStep - 1) / m_CommandPoolStep) - 1;
+		if (poolIndex < m_NumCommandPools)
+		{
+			NBlockPool::FreeBlock(m_CommandPools[poolIndex], memory);
+			return;
+		}
+		FreeMem(memory);
+	}
+
 	void CommandHistory::AddCommand(ICommand* cmd)
 	{
 		cmd->execute();
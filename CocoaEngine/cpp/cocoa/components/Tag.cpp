@@ -1,27 +1,42 @@
 #include "cocoa/components/Tag.h"
 #include "cocoa/util/JsonExtended.h"
-#include "cocoa/core/Memory.h"
+#include "cocoa/core/StringBlockAllocator.h"
 
 namespace Cocoa
 {
 	namespace NTag
 	{
-		Tag CreateTag(const char* name, bool isHeapAllocated)
+		// Internal Variables
+		static StringBlockAllocator m_Names = NStringBlockAllocator::Create();
+
+		Tag CreateTag(const char* name, bool copyName)
 		{
 			Tag res;
-			res.Name = name;
 			res.Size = strlen(name);
-			res.IsHeapAllocated = isHeapAllocated;
+			res.Name = copyName ? NStringBlockAllocator::CopyString(m_Names, name, res.Size) : name;
+			res.IsHeapAllocated = copyName;
 			return res;
 		}
 
+		void SetName(Tag& tag, const char* name)
+		{
+			// Copy first, name could be pointing at the current name
+			int size = strlen(name);
+			const char* newName = NStringBlockAllocator::CopyString(m_Names, name, size);
+			Destroy(tag);
+			tag.Name = newName;
+			tag.Size = size;
+			tag.IsHeapAllocated = true;
+		}
+
 		void Destroy(Tag& tag)
 		{
 			if (tag.IsHeapAllocated)
 			{
-				FreeMem((void*)tag.Name);
+				NStringBlockAllocator::FreeString(m_Names, tag.Name, tag.Size);
 				tag.Size = 0;
 				tag.Name = nullptr;
+				tag.IsHeapAllocated = false;
 			}
 		}
 
@@ -42,18 +57,8 @@ namespace Cocoa
 		}
 		void Deserialize(json& j, Entity entity)
 		{
-			Tag tag = { "", false, false };
 			std::string tagName = j["Tag"]["Name"];
-
-			int tagNameSize = tagName.length();
-			if (tagNameSize > 0)
-			{
-				tag.Name = (char*)AllocMem(sizeof(char) * (tagNameSize + 1));
-				memcpy((void*)tag.Name, tagName.c_str(), sizeof(char) * (tagNameSize + 1));
-				tag.IsHeapAllocated = true;
-				tag.Size = tagNameSize;
-			}
-
+			Tag tag = tagName.length() > 0 ? CreateTag(tagName.c_str(), true) : CreateTag("");
 			NEntity::AddComponent<Tag>(entity, tag);
 		}
 	}
@@ -5,20 +5,98 @@ namespace Cocoa
 {
 	namespace Transform
 	{
+		// Internal Variables
+		static uint32 m_HierarchyVersion = 0;
+
 		// Internal Functions
-		static TransformData Init(glm::vec3 position, glm::vec3 scale, glm::vec3 eulerRotation, Entity parent = NEntity::CreateNull())
+		static TransformData Init(glm::vec3 position, glm::vec3 scale, glm::vec3 eulerRotation)
 		{
 			TransformData data;
 			data.Position = position;
 			data.Scale = scale;
 			data.EulerRotation = eulerRotation;
-			data.Orientation = glm::toQuat(glm::orientate3(data.EulerRotation));
-			data.Parent = parent;
-			data.LocalPosition = glm::vec3();
 
 			return data;
 		}
 
+		static TransformHierarchy& GetOrAddHierarchy(Entity entity)
+		{
+			if (NEntity::HasComponent<TransformHierarchy>(entity))
+			{
+				return NEntity::GetComponent<TransformHierarchy>(entity);
+			}
+
+			TransformHierarchy hierarchy;
+			hierarchy.Parent = NEntity::CreateNull();
+			hierarchy.FirstChild = NEntity::CreateNull();
+			hierarchy.NextSibling = NEntity::CreateNull();
+			hierarchy.PrevSibling = NEntity::CreateNull();
+			hierarchy.LocalPosition = glm::vec3(0.0f);
+			return NEntity::AddComponent<TransformHierarchy>(entity, hierarchy);
+		}
+
+		// Entities without a parent or children drop the component, so the hierarchy pool only holds actual hierarchies.
+		// Removing it moves other hierarchy components around, don't hold on to references across this
+		static void RemoveIfUnused(Entity entity)
+		{
+			const TransformHierarchy& hierarchy = NEntity::GetComponent<TransformHierarchy>(entity);
+			if (NEntity::IsNull(hierarchy.Parent) && NEntity::IsNull(hierarchy.FirstChild))
+			{
+				NEntity::RemoveComponent<TransformHierarchy>(entity);
+			}
+		}
+
+		static void Unlink(Entity entity)
+		{
+			TransformHierarchy& hierarchy = NEntity::GetComponent<TransformHierarchy>(entity);
+			Entity parent = hierarchy.Parent;
+			if (NEntity::IsNull(parent))
+			{
+				return;
+			}
+
+			if (!NEntity::IsNull(hierarchy.PrevSibling))
+			{
+				NEntity::GetComponent<TransformHierarchy>(hierarchy.PrevSibling).NextSibling = hierarchy.NextSibling;
+			}
+			else
+			{
+				NEntity::GetComponent<TransformHierarchy>(parent).FirstChild = hierarchy.NextSibling;
+			}
+
+			if (!NEntity::IsNull(hierarchy.NextSibling))
+			{
+				NEntity::GetComponent<TransformHierarchy>(hierarchy.NextSibling).PrevSibling = hierarchy.PrevSibling;
+			}
+
+			hierarchy.Parent = NEntity::CreateNull();
+			hierarchy.NextSibling = NEntity::CreateNull();
+			hierarchy.PrevSibling = NEntity::CreateNull();
+			RemoveIfUnused(parent);
+			m_HierarchyVersion++;
+		}
+
+		// Makes entity the first child of parent, entity must not have a parent at this point
+		static void Link(Entity entity, Entity parent, const glm::vec3& localPosition)
+		{
+			// Adding the components first, adding one may move the other one
+			GetOrAddHierarchy(entity);
+			GetOrAddHierarchy(parent);
+			TransformHierarchy& hierarchy = NEntity::GetComponent<TransformHierarchy>(entity);
+			TransformHierarchy& parentHierarchy = NEntity::GetComponent<TransformHierarchy>(parent);
+
+			hierarchy.Parent = parent;
+			hierarchy.LocalPosition = localPosition;
+			hierarchy.PrevSibling = NEntity::CreateNull();
+			hierarchy.NextSibling = parentHierarchy.FirstChild;
+			if (!NEntity::IsNull(parentHierarchy.FirstChild))
+			{
+				NEntity::GetComponent<TransformHierarchy>(parentHierarchy.FirstChild).PrevSibling = entity;
+			}
+			parentHierarchy.FirstChild = entity;
+			m_HierarchyVersion++;
+		}
+
 		TransformData CreateTransform()
 		{
 			return Init(glm::vec3(0), glm::vec3(1), glm::vec3(0));
@@ -29,26 +107,114 @@ namespace Cocoa
 			return Init(position, scale, eulerRotation);
 		}
 
-		void Update(TransformData& data, float dt)
+		glm::quat GetOrientation(const TransformData& data)
+		{
+			return glm::toQuat(glm::orientate3(data.EulerRotation));
+		}
+
+		glm::mat4 GetModelMatrix(const TransformData& data)
 		{
-			if (!NEntity::IsNull(data.Parent))
+			glm::mat4 modelMatrix = glm::translate(glm::mat4(1.0f), data.Position);
+			modelMatrix = modelMatrix * glm::toMat4(GetOrientation(data));
+			return glm::scale(modelMatrix, data.Scale);
+		}
+
+		glm::mat4 GetInverseModelMatrix(const TransformData& data)
+		{
+			return glm::inverse(GetModelMatrix(data));
+		}
+
+		Entity GetParent(Entity entity)
+		{
+			return NEntity::HasComponent<TransformHierarchy>(entity)
+				? NEntity::GetComponent<TransformHierarchy>(entity).Parent
+				: NEntity::CreateNull();
+		}
+
+		void SetParent(Entity entity, Entity parent)
+		{
+			if (GetParent(entity) == parent)
+			{
+				return;
+			}
+
+			if (!NEntity::IsNull(parent) && IsDescendantOf(parent, entity))
+			{
+				Log::Warning("Tried to parent entity %d to one of its own descendants.", NEntity::GetID(entity));
+				return;
+			}
+
+			if (NEntity::HasComponent<TransformHierarchy>(entity))
+			{
+				Unlink(entity);
+				RemoveIfUnused(entity);
+			}
+
+			if (!NEntity::IsNull(parent))
+			{
+				const TransformData& transform = NEntity::GetComponent<TransformData>(entity);
+				const TransformData& parentTransform = NEntity::GetComponent<TransformData>(parent);
+				Link(entity, parent, transform.Position - parentTransform.Position);
+			}
+		}
+
+		Entity GetFirstChild(Entity entity)
+		{
+			return NEntity::HasComponent<TransformHierarchy>(entity)
+				? NEntity::GetComponent<TransformHierarchy>(entity).FirstChild
+				: NEntity::CreateNull();
+		}
+
+		Entity GetNextSibling(Entity entity)
+		{
+			return NEntity::HasComponent<TransformHierarchy>(entity)
+				? NEntity::GetComponent<TransformHierarchy>(entity).NextSibling
+				: NEntity::CreateNull();
+		}
+
+		bool IsDescendantOf(Entity entity, Entity ancestor)
+		{
+			for (Entity current = entity; !NEntity::IsNull(current); current = GetParent(current))
 			{
-				// TODO: This logic is probably flawed because it assumes that the parent is updated before the child
-				const TransformData& parentPos = NEntity::GetComponent<TransformData>(data.Parent);
-				data.Position = parentPos.Position + data.LocalPosition;
+				if (current == ancestor)
+				{
+					return true;
+				}
 			}
 
-			data.ModelMatrix = glm::translate(glm::mat4(1.0f), data.Position);
-			data.ModelMatrix = data.ModelMatrix * glm::toMat4(data.Orientation);
-			data.ModelMatrix = glm::scale(data.ModelMatrix, data.Scale);
+			return false;
+		}
+
+		void GetSubtree(Entity root, std::vector<Entity>& outEntities)
+		{
+			int start = (int)outEntities.size();
+			outEntities.push_back(root);
+			for (int i = start; i < outEntities.size(); i++)
+			{
+				for (Entity child = GetFirstChild(outEntities[i]); !NEntity::IsNull(child); child = GetNextSibling(child))
+				{
+					outEntities.push_back(child);
+				}
+			}
+		}
+
+		uint32 GetHierarchyVersion()
+		{
+			return m_HierarchyVersion;
 		}
 
 		void Serialize(json& j, Entity entity, const TransformData& transform)
 		{
+			// Parent and LocalPosition stay part of the transform in the scene file, so older scenes keep loading
+			Entity parent = GetParent(entity);
+			glm::vec3 localPosition = !NEntity::IsNull(parent)
+				? NEntity::GetComponent<TransformHierarchy>(entity).LocalPosition
+				: glm::vec3(0.0f);
+
 			json position = CMath::Serialize("Position", transform.Position);
 			json scale = CMath::Serialize("Scale", transform.Scale);
 			json rotation = CMath::Serialize("Rotation", transform.EulerRotation);
-			json localPos = CMath::Serialize("LocalPosition", transform.LocalPosition);
+			json localPos = CMath::Serialize("LocalPosition", localPosition);
 			int size = j["Components"].size();
 			j["Components"][size] = {
 				{"Transform", {
@@ -56,7 +222,7 @@ namespace Cocoa
 					position,
 					scale,
 					rotation,
-					{"Parent", NEntity::GetID(transform.Parent)},
+					{"Parent", NEntity::GetID(parent)},
 					localPos
 				}}
 			};
@@ -68,9 +234,13 @@ namespace Cocoa
 			transform.Position = CMath::DeserializeVec3(j["Transform"]["Position"]);
 			transform.Scale = CMath::DeserializeVec3(j["Transform"]["Scale"]);
 			transform.EulerRotation = CMath::DeserializeVec3(j["Transform"]["Rotation"]);
-			transform.Parent = parent;
-			transform.LocalPosition = CMath::DeserializeVec3(j["Transform"]["LocalPosition"]);
 			NEntity::AddComponent<TransformData>(entity, transform);
+
+			// The parent may not be loaded yet, linking only needs the entity to exist
+			if (!NEntity::IsNull(parent))
+			{
+				Link(entity, parent, CMath::DeserializeVec3(j["Transform"]["LocalPosition"]));
+			}
 		}
 
 		void Serialize(json& j, const TransformData& transform)
@@ -78,14 +248,10 @@ namespace Cocoa
 			json position = CMath::Serialize("Position", transform.Position);
 			json scale = CMath::Serialize("Scale", transform.Scale);
 			json rotation = CMath::Serialize("Rotation", transform.EulerRotation);
-			json localPos = CMath::Serialize("LocalPosition", transform.LocalPosition);
-			int size = j["Components"].size();
 			j["Transform"] = {
 				position,
 				scale,
-				rotation,
-				{"Parent", NEntity::GetID(transform.Parent)},
-				localPos
+				rotation
 			};
 		}
 
@@ -94,7 +260,6 @@ namespace Cocoa
 			transform.Position = CMath::DeserializeVec3(j["Transform"]["Position"]);
 			transform.Scale = CMath::DeserializeVec3(j["Transform"]["Scale"]);
 			transform.EulerRotation = CMath::DeserializeVec3(j["Transform"]["Rotation"]);
-			transform.LocalPosition = CMath::DeserializeVec3(j["Transform"]["LocalPosition"]);
 		}
 	}
 }
\ No newline at end of file
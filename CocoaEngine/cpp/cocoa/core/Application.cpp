@@ -4,6 +4,7 @@
 #include "cocoa/core/Application.h"
 #include "cocoa/renderer/DebugDraw.h"
 #include "cocoa/core/Entity.h"
+#include "cocoa/core/Memory.h"
 
 namespace Cocoa
 {
@@ -49,6 +50,8 @@ namespace Cocoa
 			m_AppData.AppOnUpdate(m_CurrentScene, dt);
 			m_AppData.AppOnRender(m_CurrentScene);
 			EndFrame();
+			// Nothing may hold on to frame allocations past this point
+			Memory::EndFrame();
 
 			m_Window->OnUpdate();
 			m_Window->Render();
@@ -1,8 +1,12 @@
 #include "cocoa/core/AssetManager.h"
 #include "cocoa/util/Log.h"
 #include "cocoa/renderer/Texture.h"
-#include "cocoa/file/File.h"
+#include "cocoa/renderer/TextureStreamer.h"
+#include "cocoa/renderer/fonts/GlyphCache.h"
+#include "cocoa/renderer/fonts/TextLayout.h"
+#include "cocoa/file/PathId.h"
 #include "cocoa/util/JsonExtended.h"
+#include "cocoa/util/HashMap.h"
 
 namespace Cocoa
 {
@@ -12,6 +16,17 @@ namespace Cocoa
 	uint32 AssetManager::s_CurrentScene = 0;
 	uint32 AssetManager::s_ResourceCount = 0;
 
+	// Internal Variables
+	// Resource ids keyed by the interned path of the asset. Comparing CPaths resolves both sides to absolute paths,
+	// so scanning the asset lists made every lookup (and every load, which checks for duplicates) cost two of those per asset
+	static HashMap<PathId, uint32> m_TextureIndex = NHashMap::Create<PathId, uint32>();
+	static HashMap<PathId, uint32> m_FontIndex = NHashMap::Create<PathId, uint32>();
+	static HashMap<PathId, uint32> m_ShaderIndex = NHashMap::Create<PathId, uint32>();
+
+	// Forward Declarations
+	template<typename T>
+	static Handle<T> FindInIndex(const HashMap<PathId, uint32>& index, PathId path, size_t numAssets);
+
 	void AssetManager::Init(uint32 scene)
 	{
 		s_CurrentScene = scene;
@@ -31,29 +46,20 @@ namespace Cocoa
 
 	Handle<Shader> AssetManager::GetShader(const CPath& path)
 	{
-		int i = 0;
-		for (auto& shader : s_Shaders)
-		{
-			if (shader.Filepath == path)
-			{
-				return Handle<Shader>(i);
-			}
-			i++;
-		}
-
-		return Handle<Shader>();
+		return FindInIndex<Shader>(m_ShaderIndex, NPathId::Find(path), s_Shaders.size());
 	}
 
 	Handle<Shader> AssetManager::LoadShaderFromFile(const CPath& path, bool isDefault, int id)
 	{
-		Handle<Shader> shader = GetShader(path);
+		PathId pathId = NPathId::Intern(path);
+		CPath absPath = NPathId::ToCPath(pathId);
+		Handle<Shader> shader = FindInIndex<Shader>(m_ShaderIndex, pathId, s_Shaders.size());
 		if (!shader.IsNull())
 		{
 			Log::Warning("Tried to load asset that has already been loaded '%s'", path.Path.c_str());
 			return shader;
 		}
 
-		CPath absPath = File::GetAbsolutePath(path);
 		int index = id;
 
 		// If id is -1, we don't care where you place the texture so long as it gets loaded
@@ -61,6 +67,7 @@ namespace Cocoa
 		{
 			index = s_Shaders.size();
 			s_Shaders.emplace_back(NShader::CreateShader(absPath, isDefault));
+			NHashMap::Put(m_ShaderIndex, pathId, (uint32)index);
 		}
 		// Otherwise, place the texture in the id location specified, and report error if a texture is already located there for some reason
 		else
@@ -70,6 +77,7 @@ namespace Cocoa
 			if (NShader::IsNull(s_Shaders[index]))
 			{
 				s_Shaders[index] = NShader::CreateShader(absPath, isDefault);
+				NHashMap::Put(m_ShaderIndex, pathId, (uint32)index);
 			}
 			else
 			{
@@ -84,25 +92,35 @@ namespace Cocoa
 	{
 		if (resourceId < s_Textures.size())
 		{
-			return s_Textures[resourceId];
+			// Textures that haven't finished streaming in resolve to the placeholder
+			const Texture& texture = s_Textures[resourceId];
+			return texture.IsStreaming ? TextureStreamer::GetPlaceholder() : texture;
 		}
 
 		return TextureUtil::NullTexture;
 	}
 
-	Handle<Texture> AssetManager::GetTexture(const CPath& path)
+	const CPath& AssetManager::GetTexturePath(uint32 resourceId)
 	{
-		int i = 0;
-		for (auto& tex : s_Textures)
+		if (resourceId < s_Textures.size())
 		{
-			if (tex.Path == path)
-			{
-				return Handle<Texture>(i);
-			}
-			i++;
+			return s_Textures[resourceId].Path;
 		}
 
-		return Handle<Texture>();
+		return TextureUtil::NullTexture.Path;
+	}
+
+	Handle<Texture> AssetManager::AddRuntimeTexture(Texture& texture)
+	{
+		texture.IsDefault = true;
+		uint32 index = (uint32)s_Textures.size();
+		s_Textures.push_back(texture);
+		return Handle<Texture>(index);
+	}
+
+	Handle<Texture> AssetManager::GetTexture(const CPath& path)
+	{
+		return FindInIndex<Texture>(m_TextureIndex, NPathId::Find(path), s_Textures.size());
 	}
 
 	Handle<Texture> AssetManager::LoadTextureFromJson(const json& j, bool isDefault, int id)
@@ -110,24 +128,27 @@ namespace Cocoa
 		Texture texture = TextureUtil::Deserialize(j);
 		texture.IsDefault = isDefault;
 
-		Handle<Texture> textureHandle = GetTexture(texture.Path);
+		PathId pathId = NPathId::Intern(texture.Path);
+		CPath absPath = NPathId::ToCPath(pathId);
+		Handle<Texture> textureHandle = FindInIndex<Texture>(m_TextureIndex, pathId, s_Textures.size());
 		if (!textureHandle.IsNull())
 		{
 			Log::Warning("Tried to load asset that has already been loaded '%s'.", texture.Path.Path.c_str());
 			return textureHandle;
 		}
 
-		CPath absPath = File::GetAbsolutePath(texture.Path);
 		int index = id;
 
-		// Make sure to generate texture *before* pushing back since we are pushing back a copy
-		TextureUtil::Generate(texture, texture.Path);
+		// The pixels get decoded and uploaded in the background, see TextureStreamer::Update
+		texture.IsStreaming = true;
 
 		// If id is -1, we don't care where you place the font so long as it gets loaded
 		if (index == -1)
 		{
 			index = s_Textures.size();
 			s_Textures.push_back(texture);
+			NHashMap::Put(m_TextureIndex, pathId, (uint32)index);
+			TextureStreamer::Queue(index, absPath);
 		}
 		// Otherwise, place the font in the id location specified, and report error if a font is already located there for some reason
 		else
@@ -137,6 +158,8 @@ namespace Cocoa
 			if (TextureUtil::IsNull(s_Textures[index]))
 			{
 				s_Textures[index] = texture;
+				NHashMap::Put(m_TextureIndex, pathId, (uint32)index);
+				TextureStreamer::Queue(index, absPath);
 			}
 			else
 			{
@@ -149,14 +172,15 @@ namespace Cocoa
 
 	Handle<Texture> AssetManager::LoadTextureFromFile(Texture& texture, const CPath& path, int id)
 	{
-		Handle<Texture> textureHandle = GetTexture(path);
+		PathId pathId = NPathId::Intern(path);
+		CPath absPath = NPathId::ToCPath(pathId);
+		Handle<Texture> textureHandle = FindInIndex<Texture>(m_TextureIndex, pathId, s_Textures.size());
 		if (!textureHandle.IsNull())
 		{
 			Log::Warning("Tried to load asset that has already been loaded '%s'", path.Path.c_str());
 			return textureHandle;
 		}
 
-		CPath absPath = File::GetAbsolutePath(path);
 		int index = id;
 		texture.Path = path;
 		TextureUtil::Generate(texture, path);
@@ -166,6 +190,7 @@ namespace Cocoa
 		{
 			index = s_Textures.size();
 			s_Textures.push_back(texture);
+			NHashMap::Put(m_TextureIndex, pathId, (uint32)index);
 		}
 		// Otherwise, place the texture in the id location specified, and report error if a texture is already located there for some reason
 		else
@@ -175,6 +200,7 @@ namespace Cocoa
 			if (TextureUtil::IsNull(s_Textures[index]))
 			{
 				s_Textures[index] = texture;
+				NHashMap::Put(m_TextureIndex, pathId, (uint32)index);
 			}
 			else
 			{
@@ -197,29 +223,20 @@ namespace Cocoa
 
 	Handle<Font> AssetManager::GetFont(const CPath& path)
 	{
-		int i = 0;
-		for (auto& font : s_Fonts)
-		{
-			if (font.m_Path == path)
-			{
-				return Handle<Font>(i);
-			}
-			i++;
-		}
-
-		return Handle<Font>();
+		return FindInIndex<Font>(m_FontIndex, NPathId::Find(path), s_Fonts.size());
 	}
 
 	Handle<Font> AssetManager::LoadFontFromJson(const CPath& path, const json& j, bool isDefault, int id)
 	{
-		Handle<Font> font = GetFont(path);
+		PathId pathId = NPathId::Intern(path);
+		CPath absPath = NPathId::ToCPath(pathId);
+		Handle<Font> font = FindInIndex<Font>(m_FontIndex, pathId, s_Fonts.size());
 		if (!font.IsNull())
 		{
 			Log::Warning("Tried to load asset that has already been loaded '%s'.", path.Path.c_str());
 			return font;
 		}
 
-		CPath absPath = File::GetAbsolutePath(path);
 		int index = id;
 
 		// If id is -1, we don't care where you place the font so long as it gets loaded
@@ -227,6 +244,7 @@ namespace Cocoa
 		{
 			index = s_Fonts.size();
 			s_Fonts.emplace_back(Font{ absPath, isDefault });
+			NHashMap::Put(m_FontIndex, pathId, (uint32)index);
 		}
 		// Otherwise, place the font in the id location specified, and report error if a font is already located there for some reason
 		else
@@ -236,6 +254,7 @@ namespace Cocoa
 			if (s_Fonts[index].IsNull())
 			{
 				s_Fonts[index] = Font{ absPath, isDefault };
+				NHashMap::Put(m_FontIndex, pathId, (uint32)index);
 			}
 			else
 			{
@@ -257,12 +276,27 @@ namespace Cocoa
 			return font;
 		}
 
-		CPath absPath = File::GetAbsolutePath(fontFile);
-		int index = s_Fonts.size();
+		CPath absPath = NPathId::ToCPath(NPathId::Intern(fontFile));
+		Font newFont = Font{ absPath, false };
+		newFont.GenerateSdf(fontFile, fontSize, outputFile, glyphRangeStart, glyphRangeEnd, padding, upscaleResolution);
+		return LoadGeneratedFont(newFont, outputFile);
+	}
+
+	Handle<Font> AssetManager::LoadGeneratedFont(Font& font, const CPath& fontTextureFile)
+	{
+		PathId pathId = NPathId::Intern(font.m_Path);
+		Handle<Font> existingFont = FindInIndex<Font>(m_FontIndex, pathId, s_Fonts.size());
+		if (!existingFont.IsNull())
+		{
+			Log::Warning("Tried to load asset that has already been loaded '%s'.", font.m_Path.Path.c_str());
+			font.Free();
+			return existingFont;
+		}
 
-		s_Fonts.push_back(Font{ absPath, false });
+		int index = s_Fonts.size();
+		s_Fonts.push_back(font);
+		NHashMap::Put(m_FontIndex, pathId, (uint32)index);
 		Font& newFont = s_Fonts.at(index);
-		newFont.GenerateSdf(fontFile, fontSize, outputFile, glyphRangeStart, glyphRangeEnd, padding, upscaleResolution);
 
 		Texture fontTexSpec;
 		fontTexSpec.IsDefault = false;
@@ -270,7 +304,7 @@ namespace Cocoa
 		fontTexSpec.MinFilter = FilterMode::Linear;
 		fontTexSpec.WrapS = WrapMode::Repeat;
 		fontTexSpec.WrapT = WrapMode::Repeat;
-		newFont.m_FontTexture = AssetManager::LoadTextureFromFile(fontTexSpec, outputFile);
+		newFont.m_FontTexture = AssetManager::LoadTextureFromFile(fontTexSpec, fontTextureFile);
 
 		return Handle<Font>(index);
 	}
@@ -366,6 +400,13 @@ namespace Cocoa
 
 	void AssetManager::Clear()
 	{
+		// Anything still streaming belongs to the textures we're about to delete
+		TextureStreamer::CancelAll();
+
+		// The glyph cache pages are about to be deleted along with everything else
+		GlyphCache::Clear();
+		TextLayout::Clear();
+
 		// Delete all textures on GPU before clear
 		for (auto& tex : s_Textures)
 		{
@@ -387,5 +428,26 @@ namespace Cocoa
 		}
 		NShader::ClearAllShaderVariables();
 		s_Shaders.clear();
+
+		NHashMap::Clear(m_TextureIndex);
+		NHashMap::Clear(m_FontIndex);
+		NHashMap::Clear(m_ShaderIndex);
+	}
+
+	void AssetManager::Destroy()
+	{
+		NHashMap::Free(m_TextureIndex);
+		NHashMap::Free(m_FontIndex);
+		NHashMap::Free(m_ShaderIndex);
+	}
+
+	// Internal Functions
+	template<typename T>
+	static Handle<T> FindInIndex(const HashMap<PathId, uint32>& index, PathId path, size_t numAssets)
+	{
+		// Empty paths never match anything, same as CPath's operator==
+		const uint32* resourceId = !NPathId::IsNull(path) ? NHashMap::Get(index, path) : nullptr;
+		// Loading a scene resizes the asset lists to what the scene saved, ignore anything that got cut off
+		return resourceId && *resourceId < numAssets ? Handle<T>(*resourceId) : Handle<T>();
 	}
 }
\ No newline at end of file
@@ -0,0 +1,428 @@
+#include "cocoa/core/JobSystem.h"
+#include "cocoa/util/Log.h"
+#include "cocoa/util/CMath.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+
+namespace Cocoa
+{
+	namespace JobSystem
+	{
+		struct Job
+		{
+			JobFunction Function;
+			void* Data;
+			JobCounter* Counter;
+		};
+
+		// Thieves read a slot while the owner may be writing another one, so every field is atomic
+		struct QueuedJob
+		{
+			std::atomic<JobFunction> Function;
+			std::atomic<void*> Data;
+			std::atomic<JobCounter*> Counter;
+		};
+
+		// Chase-Lev deque with a fixed capacity. Only the owning thread pushes and pops at the bottom, any thread steals from the top
+		static const int64 m_QueueCapacity = 4096;
+		struct WorkStealingQueue
+		{
+			std::atomic<int64> Top{ 0 };
+			std::atomic<int64> Bottom{ 0 };
+			QueuedJob Jobs[m_QueueCapacity];
+		};
+
+		struct ParallelForData
+		{
+			const std::function<void(int, int)>* Task;
+			int NumTasks;
+			int GrainSize;
+			std::atomic<int> NextTask;
+		};
+
+		// Internal Variables
+		// How often an idle worker looks for work again before it goes to sleep
+		static const int m_SpinCount = 64;
+
+		static std::vector<std::thread> m_Workers;
+		static std::atomic<bool> m_Running{ false };
+
+		// One queue per worker plus one for the main thread, which is the last one
+		static WorkStealingQueue* m_Queues = nullptr;
+		static int m_NumQueues = 0;
+		// Index of the queue the current thread owns, -1 for threads outside of the pool
+		static thread_local int m_WorkerIndex = -1;
+
+		// Jobs kicked off by threads outside of the pool
+		static std::mutex m_SharedMutex;
+		static std::deque<Job> m_SharedJobs;
+		static std::atomic<int> m_NumSharedJobs{ 0 };
+
+		// Long running jobs that only the workers take from, see RunInBackground. Guarded by m_SharedMutex as well
+		static std::deque<Job> m_BackgroundJobs;
+		static std::atomic<int> m_NumBackgroundJobs{ 0 };
+
+		// Never less than the number of jobs sitting in the queues, idle workers sleep while it's zero
+		static std::atomic<int> m_NumQueuedJobs{ 0 };
+		static std::atomic<int> m_NumSleeping{ 0 };
+		static std::mutex m_SleepMutex;
+		static std::condition_variable m_WorkAvailable;
+
+		// Forward Declarations
+		static void WorkerLoop(int workerIndex);
+		static bool Push(WorkStealingQueue& queue, const Job& job);
+		static void Load(const QueuedJob& slot, Job& outJob);
+		static bool Pop(WorkStealingQueue& queue, Job& outJob);
+		static bool Steal(WorkStealingQueue& queue, Job& outJob);
+		static bool PopShared(std::deque<Job>& jobs, std::atomic<int>& numJobs, Job& outJob);
+		static bool FindJob(int workerIndex, Job& outJob);
+		static void Execute(const Job& job, int workerIndex);
+		static void WakeWorker();
+		static void ParallelForJob(void* data, int workerIndex);
+
+		void Init(int numWorkers)
+		{
+			Log::Assert(!m_Running, "Tried to initialize the job system twice.");
+			if (numWorkers < 0)
+			{
+				// Leave one core for the main thread, it runs jobs while it waits anyways
+				numWorkers = CMath::Max((int)std::thread::hardware_concurrency() - 1, 1);
+			}
+
+			m_NumQueues = numWorkers + 1;
+			m_Queues = new WorkStealingQueue[m_NumQueues];
+			m_WorkerIndex = numWorkers;
+
+			m_Running = true;
+			for (int i = 0; i < numWorkers; i++)
+			{
+				m_Workers.push_back(std::thread(WorkerLoop, i));
+			}
+		}
+
+		void Destroy()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_SleepMutex);
+				m_Running = false;
+			}
+			m_WorkAvailable.notify_all();
+
+			for (auto& worker : m_Workers)
+			{
+				worker.join();
+			}
+			m_Workers.clear();
+
+			delete[] m_Queues;
+			m_Queues = nullptr;
+			m_NumQueues = 0;
+			m_WorkerIndex = -1;
+			m_SharedJobs.clear();
+			m_NumSharedJobs = 0;
+			m_BackgroundJobs.clear();
+			m_NumBackgroundJobs = 0;
+			m_NumQueuedJobs = 0;
+		}
+
+		int NumWorkers()
+		{
+			return (int)m_Workers.size();
+		}
+
+		void Run(JobFunction function, void* data, JobCounter* counter)
+		{
+			if (counter)
+			{
+				counter->Value.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			Job job = { function, data, counter };
+			int workerIndex = m_WorkerIndex;
+			if (!m_Running)
+			{
+				Execute(job, workerIndex);
+				return;
+			}
+
+			m_NumQueuedJobs.fetch_add(1);
+			if (workerIndex >= 0)
+			{
+				if (!Push(m_Queues[workerIndex], job))
+				{
+					// The deque is full, which means there's plenty of work for everybody already
+					m_NumQueuedJobs.fetch_sub(1);
+					Execute(job, workerIndex);
+					return;
+				}
+			}
+			else
+			{
+				std::lock_guard<std::mutex> lock(m_SharedMutex);
+				m_SharedJobs.push_back(job);
+				m_NumSharedJobs++;
+			}
+
+			WakeWorker();
+		}
+
+		void RunInBackground(JobFunction function, void* data, JobCounter* counter)
+		{
+			if (counter)
+			{
+				counter->Value.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			Job job = { function, data, counter };
+			if (!m_Running)
+			{
+				Execute(job, m_WorkerIndex);
+				return;
+			}
+
+			m_NumQueuedJobs.fetch_add(1);
+			{
+				std::lock_guard<std::mutex> lock(m_SharedMutex);
+				m_BackgroundJobs.push_back(job);
+				m_NumBackgroundJobs++;
+			}
+			WakeWorker();
+		}
+
+		void Wait(JobCounter& counter)
+		{
+			int workerIndex = m_WorkerIndex;
+			while (counter.Value.load(std::memory_order_acquire) > 0)
+			{
+				Job job;
+				if (workerIndex >= 0 && FindJob(workerIndex, job))
+				{
+					Execute(job, workerIndex);
+				}
+				else if (workerIndex >= 0)
+				{
+					std::this_thread::yield();
+				}
+				else
+				{
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+				}
+			}
+		}
+
+		void ParallelFor(int numTasks, const std::function<void(int taskIndex, int workerIndex)>& task, int grainSize)
+		{
+			if (numTasks <= 0)
+			{
+				return;
+			}
+
+			ParallelForData data;
+			data.Task = &task;
+			data.NumTasks = numTasks;
+			data.GrainSize = CMath::Max(grainSize, 1);
+			data.NextTask = 0;
+
+			// Every job keeps grabbing chunks until none are left, so there is no point in having more jobs than threads
+			int numChunks = (numTasks + data.GrainSize - 1) / data.GrainSize;
+			int numJobs = CMath::Min(numChunks, NumWorkers() + 1);
+			int workerIndex = m_WorkerIndex;
+			if (!m_Running)
+			{
+				ParallelForJob(&data, NumWorkers());
+				return;
+			}
+
+			JobCounter counter;
+			int numKicked = workerIndex >= 0 ? numJobs - 1 : numJobs;
+			for (int i = 0; i < numKicked; i++)
+			{
+				Run(ParallelForJob, &data, &counter);
+			}
+
+			// Threads outside of the pool don't have a worker index to run tasks with, they only wait
+			if (workerIndex >= 0)
+			{
+				ParallelForJob(&data, workerIndex);
+			}
+			Wait(counter);
+		}
+
+		// Internal Functions
+		static void WorkerLoop(int workerIndex)
+		{
+			m_WorkerIndex = workerIndex;
+			while (m_Running)
+			{
+				Job job;
+				bool foundJob = FindJob(workerIndex, job);
+				for (int spin = 0; !foundJob && spin < m_SpinCount; spin++)
+				{
+					std::this_thread::yield();
+					foundJob = FindJob(workerIndex, job);
+				}
+
+				if (foundJob)
+				{
+					Execute(job, workerIndex);
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(m_SleepMutex);
+				m_NumSleeping++;
+				m_WorkAvailable.wait(lock, []() { return !m_Running || m_NumQueuedJobs > 0; });
+				m_NumSleeping--;
+			}
+		}
+
+		static bool Push(WorkStealingQueue& queue, const Job& job)
+		{
+			int64 bottom = queue.Bottom.load(std::memory_order_relaxed);
+			int64 top = queue.Top.load(std::memory_order_acquire);
+			if (bottom - top >= m_QueueCapacity)
+			{
+				return false;
+			}
+
+			QueuedJob& slot = queue.Jobs[bottom & (m_QueueCapacity - 1)];
+			slot.Function.store(job.Function, std::memory_order_relaxed);
+			slot.Data.store(job.Data, std::memory_order_relaxed);
+			slot.Counter.store(job.Counter, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			queue.Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		static void Load(const QueuedJob& slot, Job& outJob)
+		{
+			outJob.Function = slot.Function.load(std::memory_order_relaxed);
+			outJob.Data = slot.Data.load(std::memory_order_relaxed);
+			outJob.Counter = slot.Counter.load(std::memory_order_relaxed);
+		}
+
+		static bool Pop(WorkStealingQueue& queue, Job& outJob)
+		{
+			int64 bottom = queue.Bottom.load(std::memory_order_relaxed) - 1;
+			queue.Bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 top = queue.Top.load(std::memory_order_relaxed);
+			if (top > bottom)
+			{
+				queue.Bottom.store(bottom + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			Load(queue.Jobs[bottom & (m_QueueCapacity - 1)], outJob);
+			if (top == bottom)
+			{
+				// Last job in the queue, a thief may be going for it as well
+				bool won = queue.Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				queue.Bottom.store(bottom + 1, std::memory_order_relaxed);
+				return won;
+			}
+			return true;
+		}
+
+		static bool Steal(WorkStealingQueue& queue, Job& outJob)
+		{
+			int64 top = queue.Top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 bottom = queue.Bottom.load(std::memory_order_acquire);
+			if (top >= bottom)
+			{
+				return false;
+			}
+
+			// The owner never overwrites the slot at top while top is unchanged, so a successful exchange means the read was valid
+			Load(queue.Jobs[top & (m_QueueCapacity - 1)], outJob);
+			return queue.Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		}
+
+		static bool PopShared(std::deque<Job>& jobs, std::atomic<int>& numJobs, Job& outJob)
+		{
+			if (numJobs == 0)
+			{
+				return false;
+			}
+
+			std::lock_guard<std::mutex> lock(m_SharedMutex);
+			if (jobs.empty())
+			{
+				return false;
+			}
+
+			outJob = jobs.front();
+			jobs.pop_front();
+			numJobs--;
+			return true;
+		}
+
+		static bool FindJob(int workerIndex, Job& outJob)
+		{
+			bool foundJob = Pop(m_Queues[workerIndex], outJob);
+			if (!foundJob)
+			{
+				foundJob = PopShared(m_SharedJobs, m_NumSharedJobs, outJob);
+			}
+
+			for (int i = 1; !foundJob && i < m_NumQueues; i++)
+			{
+				foundJob = Steal(m_Queues[(workerIndex + i) % m_NumQueues], outJob);
+			}
+
+			// The main thread owns the last queue and leaves background jobs to the workers
+			bool isMainThread = workerIndex == m_NumQueues - 1;
+			if (!foundJob && !isMainThread)
+			{
+				foundJob = PopShared(m_BackgroundJobs, m_NumBackgroundJobs, outJob);
+			}
+
+			if (foundJob)
+			{
+				m_NumQueuedJobs.fetch_sub(1);
+			}
+			return foundJob;
+		}
+
+		static void Execute(const Job& job, int workerIndex)
+		{
+			job.Function(job.Data, workerIndex);
+			if (job.Counter)
+			{
+				job.Counter->Value.fetch_sub(1, std::memory_order_release);
+			}
+		}
+
+		static void WakeWorker()
+		{
+			// Pairs with the sleeping worker checking m_NumQueuedJobs after it incremented m_NumSleeping,
+			// either the worker sees the new job or we see the worker and wake it up
+			if (m_NumSleeping > 0)
+			{
+				{
+					std::lock_guard<std::mutex> lock(m_SleepMutex);
+				}
+				m_WorkAvailable.notify_one();
+			}
+		}
+
+		static void ParallelForJob(void* data, int workerIndex)
+		{
+			ParallelForData& parallelFor = *(ParallelForData*)data;
+			int begin = parallelFor.NextTask.fetch_add(parallelFor.GrainSize);
+			while (begin < parallelFor.NumTasks)
+			{
+				int end = CMath::Min(begin + parallelFor.GrainSize, parallelFor.NumTasks);
+				for (int taskIndex = begin; taskIndex < end; taskIndex++)
+				{
+					(*parallelFor.Task)(taskIndex, workerIndex);
+				}
+				begin = parallelFor.NextTask.fetch_add(parallelFor.GrainSize);
+			}
+		}
+	}
+}
@@ -1,89 +1,175 @@
 #include "externalLibs.h"
 #include "cocoa/core/Memory.h"
 #include "cocoa/util/Log.h"
+#include "cocoa/core/SizeClassAllocator.h"
+
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <string_view>
+#include <unordered_set>
 
 namespace Cocoa
 {
 	namespace Memory
 	{
 #if _COCOA_DEBUG
+		struct CallsiteRecord
+		{
+			AllocationCallsite Stats;
+			int AllocationsThisFrame;
+			int FreesThisFrame;
+		};
+
 		struct DebugMemoryAllocation
 		{
-			const char* FileAllocator;
-			int FileAllocatorLine;
-			int References;
-			void* Memory;
+			// Records never move once they're in the map, so allocations can point straight at theirs
+			CallsiteRecord* Callsite;
+			size_t Size;
+		};
+
+		// Lookups use the caller's __FILE__, but keys stored in m_Callsites always point into m_CallsiteFilenames
+		struct CallsiteKey
+		{
+			const char* Filename;
+			int Line;
+
+			bool operator==(const CallsiteKey& other) const
+			{
+				// __FILE__ of the same header can end up at different addresses in different translation units
+				return Line == other.Line && (Filename == other.Filename || strcmp(Filename, other.Filename) == 0);
+			}
+		};
 
-			bool operator==(const DebugMemoryAllocation& other) const
+		struct CallsiteKeyHash
+		{
+			size_t operator()(const CallsiteKey& key) const
 			{
-				return other.Memory == this->Memory;
+				return std::hash<std::string_view>()(key.Filename) ^ ((size_t)key.Line * 0x9E3779B97F4A7C15ull);
 			}
 		};
 
-		static std::vector<DebugMemoryAllocation> InternalAllocations;
+		// Job workers allocate too, so every access to the tracking data goes through the mutex
+		static std::mutex m_TrackingMutex;
+		static std::unordered_map<void*, DebugMemoryAllocation> m_Allocations;
+		static std::unordered_map<CallsiteKey, CallsiteRecord, CallsiteKeyHash> m_Callsites;
+		// __FILE__ of code in the script dll goes away when the dll unloads, so callsites keep their own copy of the name
+		static std::unordered_set<std::string> m_CallsiteFilenames;
+#endif
+
+		struct LinearArena
+		{
+			uint8* Memory = nullptr;
+			size_t Capacity = 0;
+			// Keeps counting past the capacity, that's how much the arena would have needed
+			std::atomic<size_t> Used{ 0 };
+			size_t HighWaterMark = 0;
+
+			// Heap blocks for everything that didn't fit, freed on reset
+			std::mutex OverflowMutex;
+			std::vector<void*> Overflow;
+		};
+
+		struct ScratchStack
+		{
+			uint8* Memory = nullptr;
+			size_t Capacity = 0;
+			size_t Used = 0;
+			size_t HighWaterMark = 0;
+
+			~ScratchStack();
+		};
+
+		// Internal Variables
+		static const size_t m_FrameArenaSize = 4 * 1024 * 1024;
+		static const size_t m_DoubleBufferedArenaSize = 1024 * 1024;
+		static const size_t m_ScratchStackSize = 1024 * 1024;
+
+		static LinearArena m_FrameArena;
+		// Allocations go to the current one, the other one still holds last frame's memory
+		static LinearArena m_DoubleBufferedArenas[2];
+		static int m_CurrentDoubleBuffered = 0;
+
+		static thread_local ScratchStack m_ScratchStack;
+		static std::atomic<size_t> m_ScratchCapacity{ 0 };
+		static std::atomic<size_t> m_ScratchHighWaterMark{ 0 };
+
+		// Forward Declarations
+		static uint8* AlignPointer(uint8* pointer, size_t alignment);
+		static void InitArena(LinearArena& arena, size_t capacity);
+		static void FreeArena(LinearArena& arena);
+		static void* ArenaAllocate(LinearArena& arena, size_t numBytes, size_t alignment);
+		static void ResetArena(LinearArena& arena);
+		static ArenaStats GetStats(const LinearArena& arena);
+#if _COCOA_DEBUG
+		static void TrackAllocation(const char* filename, int line, void* memory, size_t numBytes);
+		static void TrackFree(const DebugMemoryAllocation& allocation);
 #endif
 
 		void* _Allocate(const char* filename, int line, size_t numBytes)
 		{
+#if _COCOA_ENGINE_ALLOCATOR
+			void* memory = SizeClassAllocator::Allocate(numBytes);
+#else
 			void* memory = malloc(numBytes);
+#endif
 #if _COCOA_DEBUG
 			// If we are in a debug build, track all memory allocations to see if we free them all as well
-			auto iterator = std::find(InternalAllocations.begin(), InternalAllocations.end(), DebugMemoryAllocation{ filename, line, 0, memory });
-			if (iterator == InternalAllocations.end())
+			std::lock_guard<std::mutex> lock(m_TrackingMutex);
+			if (m_Allocations.find(memory) != m_Allocations.end())
 			{
-				InternalAllocations.push_back({ filename, line, 1, memory });
-			}
-			else
-			{
-				if (iterator->References <= 0)
-				{
-					iterator->References++;
-				}
-				else
-				{
-					Log::Error("Tried to allocate memory that has already been allocated... This should never be hit. If it is, we have a problem.");
-				}
+				Log::Error("Tried to allocate memory that has already been allocated... This should never be hit. If it is, we have a problem.");
 			}
+			TrackAllocation(filename, line, memory, numBytes);
 #endif
 			return memory;
 		}
 
 		void* _Realloc(const char* filename, int line, void* oldMemory, size_t numBytes)
 		{
+#if _COCOA_ENGINE_ALLOCATOR
+			void* newMemory = SizeClassAllocator::Reallocate(oldMemory, numBytes);
+#else
 			void* newMemory = realloc(oldMemory, numBytes);
+#endif
 #if _COCOA_DEBUG
 			// If we are in a debug build, track all memory allocations to see if we free them all as well
-			auto newMemoryIter = std::find(InternalAllocations.begin(), InternalAllocations.end(), DebugMemoryAllocation{ filename, line, 0, newMemory });
-			auto oldMemoryIter = std::find(InternalAllocations.begin(), InternalAllocations.end(), DebugMemoryAllocation{ filename, line, 0, oldMemory });
-			if (newMemoryIter != oldMemoryIter)
+			std::lock_guard<std::mutex> lock(m_TrackingMutex);
+			if (newMemory == nullptr && numBytes > 0)
 			{
-				// Realloc could not expand the current pointer, so it allocated a new memory block
-				if (oldMemoryIter == InternalAllocations.end())
+				// The old block is untouched when realloc fails, so it stays tracked
+				Log::Error("Failed to realloc %zu bytes in '%s' line: %d.", numBytes, filename, line);
+				return newMemory;
+			}
+
+			if (oldMemory != nullptr)
+			{
+				auto oldMemoryIter = m_Allocations.find(oldMemory);
+				if (oldMemoryIter == m_Allocations.end())
 				{
 					Log::Error("Tried to realloc invalid memory in '%s' line: %d.", filename, line);
 				}
-				else
-				{
-					oldMemoryIter->References--;
-				}
-
-				if (newMemoryIter == InternalAllocations.end())
+				else if (newMemory == oldMemory)
 				{
-					InternalAllocations.push_back({ filename, line, 1, newMemory });
+					// Realloc resized the block in place, it still belongs to whoever allocated it
+					CallsiteRecord* callsite = oldMemoryIter->second.Callsite;
+					callsite->Stats.LiveBytes = callsite->Stats.LiveBytes - oldMemoryIter->second.Size + numBytes;
+					callsite->Stats.PeakBytes = std::max(callsite->Stats.PeakBytes, callsite->Stats.LiveBytes);
+					oldMemoryIter->second.Size = numBytes;
+					return newMemory;
 				}
 				else
 				{
-					if (newMemoryIter->References <= 0)
-					{
-						newMemoryIter->References++;
-					}
-					else
-					{
-						Log::Error("Tried to allocate memory that has already been allocated... This should never be hit. If it is, we have a problem.");
-					}
+					TrackFree(oldMemoryIter->second);
+					m_Allocations.erase(oldMemoryIter);
 				}
 			}
-			// If realloc expanded the memory in-place, then we don't need to do anything because no "new" memory locations were allocated
+
+			// Realloc could not expand the current pointer, so it allocated a new memory block
+			if (newMemory != nullptr)
+			{
+				TrackAllocation(filename, line, newMemory, numBytes);
+			}
 #endif
 			return newMemory;
 		}
@@ -91,46 +177,298 @@ namespace Cocoa
 		void _Free(const char* filename, int line, void* memory)
 		{
 #if _COCOA_DEBUG
-			auto iterator = std::find(InternalAllocations.begin(), InternalAllocations.end(), DebugMemoryAllocation{ filename, line, 0, memory });
-			if (iterator == InternalAllocations.end())
-			{
-				Log::Error("Tried to free invalid memory that was never allocated.");
-				Log::Error("Code that attempted to free: '%s' line: %d", filename, line);
-			}
-			else if (iterator->References <= 0)
-			{
-				Log::Error("Tried to free memory that has already been freed.");
-				Log::Error("Code that attempted to free: '%s' line: %d", filename, line);
-				Log::Error("Code that allocated the memory block: '%s' line: %d", iterator->FileAllocator, iterator->FileAllocatorLine);
-			}
-			else
 			{
-				iterator->References--;
+				std::lock_guard<std::mutex> lock(m_TrackingMutex);
+				auto iterator = m_Allocations.find(memory);
+				if (iterator == m_Allocations.end())
+				{
+					Log::Error("Tried to free memory that was never allocated or has already been freed.");
+					Log::Error("Code that attempted to free: '%s' line: %d", filename, line);
+				}
+				else
+				{
+					TrackFree(iterator->second);
+					m_Allocations.erase(iterator);
+				}
 			}
 #endif
 			// When debug is turned off we literally just free the memory, so it will through a segfault if a
 			// faulty release build was published
+#if _COCOA_ENGINE_ALLOCATOR
+			SizeClassAllocator::Free(memory);
+#else
 			free(memory);
+#endif
 		}
 
 		void Init()
 		{
 #if _COCOA_DEBUG
-			InternalAllocations = std::vector<DebugMemoryAllocation>();
+			std::lock_guard<std::mutex> lock(m_TrackingMutex);
+			m_Allocations.clear();
+			m_Callsites.clear();
+			m_CallsiteFilenames.clear();
 #endif
+			InitArena(m_FrameArena, m_FrameArenaSize);
+			InitArena(m_DoubleBufferedArenas[0], m_DoubleBufferedArenaSize);
+			InitArena(m_DoubleBufferedArenas[1], m_DoubleBufferedArenaSize);
+			m_CurrentDoubleBuffered = 0;
 		}
 
 		void Destroy()
 		{
+			FreeArena(m_FrameArena);
+			FreeArena(m_DoubleBufferedArenas[0]);
+			FreeArena(m_DoubleBufferedArenas[1]);
+#if _COCOA_ENGINE_ALLOCATOR
+			SizeClassAllocator::Destroy();
+#endif
+
+#if _COCOA_DEBUG
+			std::lock_guard<std::mutex> lock(m_TrackingMutex);
+			for (const auto& [key, callsite] : m_Callsites)
+			{
+				if (callsite.Stats.LiveAllocations > 0)
+				{
+					Log::Warning("Application ended execution and did not free %d allocation(s) (%zu bytes) allocated at: '%s' line: %d",
+						callsite.Stats.LiveAllocations, callsite.Stats.LiveBytes, callsite.Stats.Filename, callsite.Stats.Line);
+				}
+			}
+#endif
+		}
+
+		void* FrameAlloc(size_t numBytes, size_t alignment)
+		{
+			return ArenaAllocate(m_FrameArena, numBytes, alignment);
+		}
+
+		void* DoubleBufferedFrameAlloc(size_t numBytes, size_t alignment)
+		{
+			return ArenaAllocate(m_DoubleBufferedArenas[m_CurrentDoubleBuffered], numBytes, alignment);
+		}
+
+		void EndFrame()
+		{
+			ResetArena(m_FrameArena);
+
+			// The arena that held last frame's memory becomes the current one, which leaves this frame's memory alone until
+			// the end of the next frame
+			m_CurrentDoubleBuffered = 1 - m_CurrentDoubleBuffered;
+			ResetArena(m_DoubleBufferedArenas[m_CurrentDoubleBuffered]);
+
+#if _COCOA_DEBUG
+			std::lock_guard<std::mutex> lock(m_TrackingMutex);
+			for (auto& [key, callsite] : m_Callsites)
+			{
+				callsite.Stats.AllocationsLastFrame = callsite.AllocationsThisFrame;
+				callsite.Stats.FreesLastFrame = callsite.FreesThisFrame;
+				callsite.AllocationsThisFrame = 0;
+				callsite.FreesThisFrame = 0;
+			}
+#endif
+		}
+
+		ArenaStats GetFrameArenaStats()
+		{
+			return GetStats(m_FrameArena);
+		}
+
+		ArenaStats GetDoubleBufferedArenaStats()
+		{
+			ArenaStats current = GetStats(m_DoubleBufferedArenas[m_CurrentDoubleBuffered]);
+			ArenaStats previous = GetStats(m_DoubleBufferedArenas[1 - m_CurrentDoubleBuffered]);
+			return {
+				current.Capacity + previous.Capacity,
+				current.Used + previous.Used,
+				std::max(current.HighWaterMark, previous.HighWaterMark)
+			};
+		}
+
+		ArenaStats GetScratchStats()
+		{
+			return { m_ScratchCapacity.load(), m_ScratchStack.Used, m_ScratchHighWaterMark.load() };
+		}
+
+		void GetAllocationCallsites(std::vector<AllocationCallsite>& outCallsites)
+		{
+			outCallsites.clear();
 #if _COCOA_DEBUG
-			for (auto& alloc : InternalAllocations)
 			{
-				if (alloc.References > 0)
+				std::lock_guard<std::mutex> lock(m_TrackingMutex);
+				outCallsites.reserve(m_Callsites.size());
+				for (const auto& [key, callsite] : m_Callsites)
 				{
-					Log::Warning("Application ended execution and did not free memory allocated at: '%s' line: %d", alloc.FileAllocator, alloc.FileAllocatorLine);
+					outCallsites.push_back(callsite.Stats);
 				}
 			}
+
+			std::sort(outCallsites.begin(), outCallsites.end(), [](const AllocationCallsite& a, const AllocationCallsite& b)
+			{
+				return a.LiveBytes > b.LiveBytes;
+			});
 #endif
 		}
+
+		// Internal Functions
+#if _COCOA_DEBUG
+		// Both expect m_TrackingMutex to be locked
+		static void TrackAllocation(const char* filename, int line, void* memory, size_t numBytes)
+		{
+			auto iter = m_Callsites.find(CallsiteKey{ filename, line });
+			if (iter == m_Callsites.end())
+			{
+				const char* ownedFilename = m_CallsiteFilenames.emplace(filename).first->c_str();
+				CallsiteRecord record;
+				record.Stats = { ownedFilename, line, 0, 0, 0, 0, 0, 0 };
+				record.AllocationsThisFrame = 0;
+				record.FreesThisFrame = 0;
+				iter = m_Callsites.emplace(CallsiteKey{ ownedFilename, line }, record).first;
+			}
+			CallsiteRecord& callsite = iter->second;
+
+			callsite.Stats.LiveBytes += numBytes;
+			callsite.Stats.PeakBytes = std::max(callsite.Stats.PeakBytes, callsite.Stats.LiveBytes);
+			callsite.Stats.LiveAllocations++;
+			callsite.Stats.TotalAllocations++;
+			callsite.AllocationsThisFrame++;
+			m_Allocations[memory] = { &callsite, numBytes };
+		}
+
+		static void TrackFree(const DebugMemoryAllocation& allocation)
+		{
+			CallsiteRecord& callsite = *allocation.Callsite;
+			callsite.Stats.LiveBytes -= allocation.Size;
+			callsite.Stats.LiveAllocations--;
+			callsite.FreesThisFrame++;
+		}
+#endif
+
+		static uint8* AlignPointer(uint8* pointer, size_t alignment)
+		{
+			Log::Assert(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment has to be a power of two.");
+			return (uint8*)(((uintptr_t)pointer + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		}
+
+		static void InitArena(LinearArena& arena, size_t capacity)
+		{
+			FreeArena(arena);
+			arena.Memory = (uint8*)malloc(capacity);
+			arena.Capacity = capacity;
+			arena.HighWaterMark = 0;
+		}
+
+		static void FreeArena(LinearArena& arena)
+		{
+			ResetArena(arena);
+			free(arena.Memory);
+			arena.Memory = nullptr;
+			arena.Capacity = 0;
+		}
+
+		static void* ArenaAllocate(LinearArena& arena, size_t numBytes, size_t alignment)
+		{
+			// Reserving room for the worst case padding keeps the bump a single atomic add
+			size_t size = numBytes + alignment - 1;
+			size_t offset = arena.Used.fetch_add(size, std::memory_order_relaxed);
+			if (offset + size <= arena.Capacity)
+			{
+				return AlignPointer(arena.Memory + offset, alignment);
+			}
+
+			void* memory = malloc(size);
+			Log::Assert(memory != nullptr, "Ran out of memory for the frame arena.");
+			std::lock_guard<std::mutex> lock(arena.OverflowMutex);
+			arena.Overflow.push_back(memory);
+			return AlignPointer((uint8*)memory, alignment);
+		}
+
+		static void ResetArena(LinearArena& arena)
+		{
+			size_t used = arena.Used.load();
+			arena.HighWaterMark = std::max(arena.HighWaterMark, used);
+			if (!arena.Overflow.empty())
+			{
+				for (void* memory : arena.Overflow)
+				{
+					free(memory);
+				}
+				arena.Overflow.clear();
+
+				// Grow with some headroom, so a frame that needs slightly more doesn't overflow again
+				free(arena.Memory);
+				arena.Capacity = used + used / 2;
+				arena.Memory = (uint8*)malloc(arena.Capacity);
+			}
+			arena.Used = 0;
+		}
+
+		static ArenaStats GetStats(const LinearArena& arena)
+		{
+			size_t used = arena.Used.load();
+			return { arena.Capacity, used, std::max(arena.HighWaterMark, used) };
+		}
+
+		ScratchStack::~ScratchStack()
+		{
+			if (Memory)
+			{
+				free(Memory);
+				m_ScratchCapacity -= Capacity;
+			}
+		}
+	}
+
+	ScratchScope::ScratchScope()
+	{
+		m_Marker = Memory::m_ScratchStack.Used;
+		m_Overflow = nullptr;
+	}
+
+	ScratchScope::~ScratchScope()
+	{
+		while (m_Overflow)
+		{
+			void* next = *(void**)m_Overflow;
+			free(m_Overflow);
+			m_Overflow = next;
+		}
+		Memory::m_ScratchStack.Used = m_Marker;
+	}
+
+	void* ScratchScope::Alloc(size_t numBytes, size_t alignment)
+	{
+		Memory::ScratchStack& stack = Memory::m_ScratchStack;
+		if (!stack.Memory)
+		{
+			stack.Memory = (uint8*)malloc(Memory::m_ScratchStackSize);
+			stack.Capacity = Memory::m_ScratchStackSize;
+			Memory::m_ScratchCapacity += stack.Capacity;
+		}
+
+		// Like the frame arena the offset keeps counting once the stack is full, which is what the high water mark reports
+		size_t size = numBytes + alignment - 1;
+		size_t offset = stack.Used;
+		stack.Used += size;
+		if (stack.Used > stack.HighWaterMark)
+		{
+			stack.HighWaterMark = stack.Used;
+			size_t globalHighWaterMark = Memory::m_ScratchHighWaterMark.load();
+			while (stack.HighWaterMark > globalHighWaterMark &&
+				!Memory::m_ScratchHighWaterMark.compare_exchange_weak(globalHighWaterMark, stack.HighWaterMark))
+			{
+			}
+		}
+
+		if (offset + size <= stack.Capacity)
+		{
+			return Memory::AlignPointer(stack.Memory + offset, alignment);
+		}
+
+		// Doesn't fit, fall back to the heap. The block starts with the link to the previous overflow block
+		uint8* memory = (uint8*)malloc(sizeof(void*) + size);
+		Log::Assert(memory != nullptr, "Ran out of memory for scratch allocations.");
+		*(void**)memory = m_Overflow;
+		m_Overflow = memory;
+		return Memory::AlignPointer(memory + sizeof(void*), alignment);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "externalLibs.h"
+#include "cocoa/core/Pool.h"
+#include "cocoa/core/Memory.h"
+#include "cocoa/util/Log.h"
+
+namespace Cocoa
+{
+	namespace NBlockPool
+	{
+		// Internal Variables
+		// Every chunk starts with a pointer to the next one, padded so the blocks stay 16 byte aligned
+		static const size_t m_ChunkHeaderSize = 16;
+		static const uint8 m_FreedPattern = 0xDD;
+		static const uint8 m_AllocatedPattern = 0xCD;
+
+		// Forward Declarations
+		static void AddChunk(BlockPool& pool);
+
+		BlockPool Create(size_t blockSize, int blocksPerChunk, bool poisonFreedBlocks)
+		{
+			Log::Assert(blocksPerChunk > 0, "A block pool needs at least one block per chunk.");
+			BlockPool pool;
+			pool.FreeList = nullptr;
+			pool.Chunks = nullptr;
+			// Freed blocks hold the free list link, and rounding to 16 keeps every block aligned like malloc would
+			pool.BlockSize = (uint32)((std::max(blockSize, sizeof(void*)) + 15) & ~(size_t)15);
+			pool.BlocksPerChunk = blocksPerChunk;
+			pool.NumAllocated = 0;
+			pool.NumBlocks = 0;
+			pool.PoisonFreedBlocks = poisonFreedBlocks;
+			return pool;
+		}
+
+		void Free(BlockPool& pool)
+		{
+			if (pool.NumAllocated > 0)
+			{
+				Log::Warning("Freed a block pool that still has %d block(s) in use.", pool.NumAllocated);
+			}
+
+			while (pool.Chunks)
+			{
+				void* next = *(void**)pool.Chunks;
+				FreeMem(pool.Chunks);
+				pool.Chunks = next;
+			}
+			pool.FreeList = nullptr;
+			pool.NumAllocated = 0;
+			pool.NumBlocks = 0;
+		}
+
+		void* AllocateBlock(BlockPool& pool)
+		{
+			if (pool.FreeList == nullptr)
+			{
+				AddChunk(pool);
+			}
+
+			uint8* block = (uint8*)pool.FreeList;
+			pool.FreeList = *(void**)block;
+			pool.NumAllocated++;
+
+#if _COCOA_DEBUG
+			if (pool.PoisonFreedBlocks)
+			{
+				for (uint32 i = sizeof(void*); i < pool.BlockSize; i++)
+				{
+					if (block[i] != m_FreedPattern)
+					{
+						Log::Error("Block %p of a pool with %d byte blocks was written to after it was freed.", block, pool.BlockSize);
+						break;
+					}
+				}
+				memset(block, m_AllocatedPattern, pool.BlockSize);
+			}
+#endif
+			return block;
+		}
+
+		void FreeBlock(BlockPool& pool, void* block)
+		{
+			if (block == nullptr)
+			{
+				return;
+			}
+
+			Log::Assert(pool.NumAllocated > 0, "Tried to free a block into a pool that has no blocks in use.");
+#if _COCOA_DEBUG
+			if (pool.PoisonFreedBlocks)
+			{
+				memset(block, m_FreedPattern, pool.BlockSize);
+			}
+#endif
+			*(void**)block = pool.FreeList;
+			pool.FreeList = block;
+			pool.NumAllocated--;
+		}
+
+		// Internal Functions
+		static void AddChunk(BlockPool& pool)
+		{
+			uint8* chunk = (uint8*)AllocMem(m_ChunkHeaderSize + (size_t)pool.BlockSize * pool.BlocksPerChunk);
+			Log::Assert(chunk != nullptr, "Ran out of memory for a block pool.");
+			*(void**)chunk = pool.Chunks;
+			pool.Chunks = chunk;
+
+			// Link the blocks back to front, so they get handed out in address order
+			uint8* blocks = chunk + m_ChunkHeaderSize;
+			for (int i = pool.BlocksPerChunk - 1; i >= 0; i--)
+			{
+				uint8* block = blocks + (size_t)i * pool.BlockSize;
+#if _COCOA_DEBUG
+				if (pool.PoisonFreedBlocks)
+				{
+					memset(block, m_FreedPattern, pool.BlockSize);
+				}
+#endif
+				*(void**)block = pool.FreeList;
+				pool.FreeList = block;
+			}
+			pool.NumBlocks += pool.BlocksPerChunk;
+		}
+	}
+}
@@ -0,0 +1,514 @@
+#include "externalLibs.h"
+#include "cocoa/core/SizeClassAllocator.h"
+#include "cocoa/util/Log.h"
+
+#include <atomic>
+#include <mutex>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Cocoa
+{
+	namespace SizeClassAllocator
+	{
+		// Sits at the start of every slab and every large allocation. Both are aligned to m_SlabSize, so masking any
+		// pointer handed out finds the header it came from
+		struct SlabHeader
+		{
+			uint32 SizeClass;
+			// Only set for large allocations, always a multiple of m_SlabSize
+			size_t MappedSize;
+			SlabHeader* Next;
+		};
+
+		struct FreeBlock
+		{
+			FreeBlock* Next;
+		};
+
+		struct CentralPool
+		{
+			std::mutex Mutex;
+			FreeBlock* FreeList = nullptr;
+			int NumFree = 0;
+		};
+
+		// Sixteen byte steps up to 128 bytes, then four steps per power of two up to 8KB
+		static const int m_NumSizeClasses = 8 + 6 * 4;
+
+		struct ThreadCache
+		{
+			FreeBlock* FreeLists[m_NumSizeClasses] = {};
+			int NumFree[m_NumSizeClasses] = {};
+			// Blocks in the cache are only valid if the slabs weren't given back to the OS since
+			uint32 Generation = 0;
+
+			// Flushed to the shared counters whenever the cache trades a batch
+			uint64 NumAllocations = 0;
+			uint64 NumFrees = 0;
+			uint64 RequestedBytes = 0;
+			uint64 BlockBytesAllocated = 0;
+			uint64 BlockBytesFreed = 0;
+
+			~ThreadCache();
+		};
+
+		// Internal Variables
+		static const size_t m_SlabSize = 64 * 1024;
+		// Keeps the blocks after the header 16 byte aligned, same as malloc
+		static const size_t m_SlabHeaderSize = 64;
+		static const size_t m_MaxSmallSize = 8192;
+		static const uint32 m_LargeSizeClass = 0xFFFFFFFF;
+		// Large allocations up to this many slabs in size are kept around once freed instead of going back to the OS,
+		// arrays that keep growing and shrinking would otherwise map and unmap pages every time
+		static const int m_MaxCachedSpanSlabs = 16;
+		static const size_t m_MaxCachedSpanBytes = 16 * 1024 * 1024;
+
+		static CentralPool m_CentralPools[m_NumSizeClasses];
+		static std::mutex m_SlabMutex;
+		static SlabHeader* m_Slabs = nullptr;
+		static std::atomic<uint32> m_Generation{ 1 };
+
+		// Freed large allocations, indexed by how many slabs they span
+		static std::mutex m_SpanCacheMutex;
+		static SlabHeader* m_CachedSpans[m_MaxCachedSpanSlabs + 1] = {};
+
+		static thread_local ThreadCache m_ThreadCache;
+
+		static std::atomic<uint64> m_SlabBytes{ 0 };
+		static std::atomic<uint64> m_LargeBytes{ 0 };
+		static std::atomic<uint64> m_CachedSpanBytes{ 0 };
+		static std::atomic<uint64> m_RequestedBytes{ 0 };
+		static std::atomic<uint64> m_BlockBytesAllocated{ 0 };
+		static std::atomic<uint64> m_BlockBytesFreed{ 0 };
+		static std::atomic<uint64> m_NumAllocations{ 0 };
+		static std::atomic<uint64> m_NumFrees{ 0 };
+		static std::atomic<uint64> m_NumLargeAllocations{ 0 };
+		static std::atomic<uint64> m_NumBatchTransfers{ 0 };
+
+		// Forward Declarations
+		static int SizeClassIndex(size_t numBytes);
+		static size_t SizeClassSize(int sizeClass);
+		static int BatchSize(int sizeClass);
+		static SlabHeader* GetHeader(void* memory);
+		static ThreadCache& GetThreadCache();
+		static void Refill(ThreadCache& cache, int sizeClass);
+		static void ReleaseBatch(ThreadCache& cache, int sizeClass, int numBlocks);
+		static void FlushStats(ThreadCache& cache);
+		static void* AllocateLarge(size_t numBytes);
+		static void FreeLarge(SlabHeader* header);
+		static void* MapPages(size_t numBytes);
+		static void UnmapPages(void* memory, size_t numBytes);
+
+		void* Allocate(size_t numBytes)
+		{
+			if (numBytes > m_MaxSmallSize)
+			{
+				return AllocateLarge(numBytes);
+			}
+
+			int sizeClass = SizeClassIndex(numBytes);
+			ThreadCache& cache = GetThreadCache();
+			if (cache.FreeLists[sizeClass] == nullptr)
+			{
+				Refill(cache, sizeClass);
+			}
+
+			FreeBlock* block = cache.FreeLists[sizeClass];
+			cache.FreeLists[sizeClass] = block->Next;
+			cache.NumFree[sizeClass]--;
+			cache.NumAllocations++;
+			cache.RequestedBytes += numBytes;
+			cache.BlockBytesAllocated += SizeClassSize(sizeClass);
+			return block;
+		}
+
+		void* Reallocate(void* memory, size_t numBytes)
+		{
+			if (memory == nullptr)
+			{
+				return Allocate(numBytes);
+			}
+
+			SlabHeader* header = GetHeader(memory);
+			size_t oldSize = header->SizeClass == m_LargeSizeClass
+				? header->MappedSize - m_SlabHeaderSize
+				: SizeClassSize(header->SizeClass);
+
+			// Stay put if the block still fits and isn't more than twice as big as it has to be
+			if (numBytes <= oldSize && numBytes > oldSize / 2)
+			{
+				return memory;
+			}
+
+			void* newMemory = Allocate(numBytes);
+			if (newMemory != nullptr)
+			{
+				memcpy(newMemory, memory, std::min(oldSize, numBytes));
+				Free(memory);
+			}
+			return newMemory;
+		}
+
+		void Free(void* memory)
+		{
+			if (memory == nullptr)
+			{
+				return;
+			}
+
+			SlabHeader* header = GetHeader(memory);
+			if (header->SizeClass == m_LargeSizeClass)
+			{
+				FreeLarge(header);
+				return;
+			}
+
+			int sizeClass = (int)header->SizeClass;
+			ThreadCache& cache = GetThreadCache();
+			FreeBlock* block = (FreeBlock*)memory;
+			block->Next = cache.FreeLists[sizeClass];
+			cache.FreeLists[sizeClass] = block;
+			cache.NumFree[sizeClass]++;
+			cache.NumFrees++;
+			cache.BlockBytesFreed += SizeClassSize(sizeClass);
+
+			// Keep one batch around for the next allocations, a thread that only frees hands the rest back
+			int batchSize = BatchSize(sizeClass);
+			if (cache.NumFree[sizeClass] >= batchSize * 2)
+			{
+				ReleaseBatch(cache, sizeClass, batchSize);
+			}
+		}
+
+		void Destroy()
+		{
+			ThreadCache& cache = GetThreadCache();
+			for (int sizeClass = 0; sizeClass < m_NumSizeClasses; sizeClass++)
+			{
+				if (cache.NumFree[sizeClass] > 0)
+				{
+					ReleaseBatch(cache, sizeClass, cache.NumFree[sizeClass]);
+				}
+			}
+			FlushStats(cache);
+
+			{
+				std::lock_guard<std::mutex> lock(m_SpanCacheMutex);
+				for (int numSlabs = 1; numSlabs <= m_MaxCachedSpanSlabs; numSlabs++)
+				{
+					while (m_CachedSpans[numSlabs])
+					{
+						SlabHeader* next = m_CachedSpans[numSlabs]->Next;
+						UnmapPages(m_CachedSpans[numSlabs], m_CachedSpans[numSlabs]->MappedSize);
+						m_CachedSpans[numSlabs] = next;
+					}
+				}
+				m_CachedSpanBytes = 0;
+			}
+
+			// Threads that are still running may hold blocks in their caches, the generation tells them to drop those
+			if (m_BlockBytesAllocated.load() != m_BlockBytesFreed.load())
+			{
+				return;
+			}
+
+			// Refill takes the slab mutex while holding a pool mutex, so never hold both the other way around
+			for (int sizeClass = 0; sizeClass < m_NumSizeClasses; sizeClass++)
+			{
+				std::lock_guard<std::mutex> lock(m_CentralPools[sizeClass].Mutex);
+				m_CentralPools[sizeClass].FreeList = nullptr;
+				m_CentralPools[sizeClass].NumFree = 0;
+			}
+
+			std::lock_guard<std::mutex> lock(m_SlabMutex);
+			while (m_Slabs)
+			{
+				SlabHeader* next = m_Slabs->Next;
+				UnmapPages(m_Slabs, m_SlabSize);
+				m_Slabs = next;
+			}
+			m_SlabBytes = 0;
+			m_Generation++;
+		}
+
+		SizeClassAllocatorStats GetStats()
+		{
+			FlushStats(GetThreadCache());
+
+			uint64 blockBytesAllocated = m_BlockBytesAllocated.load();
+			uint64 blockBytesFreed = m_BlockBytesFreed.load();
+			return {
+				(size_t)m_SlabBytes.load(),
+				(size_t)m_LargeBytes.load(),
+				(size_t)m_CachedSpanBytes.load(),
+				blockBytesAllocated > blockBytesFreed ? (size_t)(blockBytesAllocated - blockBytesFreed) : 0,
+				m_RequestedBytes.load(),
+				blockBytesAllocated,
+				m_NumAllocations.load(),
+				m_NumFrees.load(),
+				m_NumLargeAllocations.load(),
+				m_NumBatchTransfers.load()
+			};
+		}
+
+		// Internal Functions
+		static int SizeClassIndex(size_t numBytes)
+		{
+			if (numBytes <= 128)
+			{
+				return numBytes == 0 ? 0 : (int)((numBytes - 1) / 16);
+			}
+
+			// numBytes is in (2^power, 2^(power + 1)], which is split into four equally sized steps
+			size_t rounded = numBytes - 1;
+			int power = 7;
+			while ((rounded >> (power + 1)) != 0)
+			{
+				power++;
+			}
+			return 8 + (power - 7) * 4 + (int)(rounded >> (power - 2)) - 4;
+		}
+
+		static size_t SizeClassSize(int sizeClass)
+		{
+			if (sizeClass < 8)
+			{
+				return (size_t)(sizeClass + 1) * 16;
+			}
+
+			int power = 7 + (sizeClass - 8) / 4;
+			int step = (sizeClass - 8) % 4 + 1;
+			return ((size_t)1 << power) + (size_t)step * ((size_t)1 << (power - 2));
+		}
+
+		static int BatchSize(int sizeClass)
+		{
+			// Move roughly 16KB at a time, but always enough blocks to make the trip worth it
+			int batchSize = (int)(16 * 1024 / SizeClassSize(sizeClass));
+			return std::max(4, std::min(batchSize, 64));
+		}
+
+		static SlabHeader* GetHeader(void* memory)
+		{
+			return (SlabHeader*)((uintptr_t)memory & ~(uintptr_t)(m_SlabSize - 1));
+		}
+
+		static ThreadCache& GetThreadCache()
+		{
+			ThreadCache& cache = m_ThreadCache;
+			uint32 generation = m_Generation.load(std::memory_order_relaxed);
+			if (cache.Generation != generation)
+			{
+				// Either the first time this thread allocates, or the slabs the cached blocks lived in are gone
+				memset(cache.FreeLists, 0, sizeof(cache.FreeLists));
+				memset(cache.NumFree, 0, sizeof(cache.NumFree));
+				cache.Generation = generation;
+			}
+			return cache;
+		}
+
+		static void Refill(ThreadCache& cache, int sizeClass)
+		{
+			CentralPool& pool = m_CentralPools[sizeClass];
+			size_t blockSize = SizeClassSize(sizeClass);
+			int batchSize = BatchSize(sizeClass);
+			std::lock_guard<std::mutex> lock(pool.Mutex);
+			while (pool.NumFree < batchSize)
+			{
+				// Carve up a new slab, the blocks go to the back so the next batch is still made of blocks freed earlier
+				uint8* slab = (uint8*)MapPages(m_SlabSize);
+				Log::Assert(slab != nullptr, "Ran out of memory for the size class allocator.");
+				SlabHeader* header = (SlabHeader*)slab;
+				header->SizeClass = (uint32)sizeClass;
+				header->MappedSize = m_SlabSize;
+				{
+					std::lock_guard<std::mutex> slabLock(m_SlabMutex);
+					header->Next = m_Slabs;
+					m_Slabs = header;
+				}
+				m_SlabBytes += m_SlabSize;
+
+				FreeBlock** tail = &pool.FreeList;
+				while (*tail)
+				{
+					tail = &(*tail)->Next;
+				}
+				int numBlocks = (int)((m_SlabSize - m_SlabHeaderSize) / blockSize);
+				for (int i = 0; i < numBlocks; i++)
+				{
+					FreeBlock* block = (FreeBlock*)(slab + m_SlabHeaderSize + i * blockSize);
+					*tail = block;
+					tail = &block->Next;
+				}
+				*tail = nullptr;
+				pool.NumFree += numBlocks;
+			}
+
+			FreeBlock* first = pool.FreeList;
+			FreeBlock* last = first;
+			for (int i = 1; i < batchSize; i++)
+			{
+				last = last->Next;
+			}
+			pool.FreeList = last->Next;
+			pool.NumFree -= batchSize;
+
+			last->Next = cache.FreeLists[sizeClass];
+			cache.FreeLists[sizeClass] = first;
+			cache.NumFree[sizeClass] += batchSize;
+			m_NumBatchTransfers++;
+			FlushStats(cache);
+		}
+
+		static void ReleaseBatch(ThreadCache& cache, int sizeClass, int numBlocks)
+		{
+			FreeBlock* first = cache.FreeLists[sizeClass];
+			FreeBlock* last = first;
+			for (int i = 1; i < numBlocks; i++)
+			{
+				last = last->Next;
+			}
+			cache.FreeLists[sizeClass] = last->Next;
+			cache.NumFree[sizeClass] -= numBlocks;
+
+			CentralPool& pool = m_CentralPools[sizeClass];
+			{
+				std::lock_guard<std::mutex> lock(pool.Mutex);
+				last->Next = pool.FreeList;
+				pool.FreeList = first;
+				pool.NumFree += numBlocks;
+			}
+			m_NumBatchTransfers++;
+			FlushStats(cache);
+		}
+
+		static void FlushStats(ThreadCache& cache)
+		{
+			m_NumAllocations += cache.NumAllocations;
+			m_NumFrees += cache.NumFrees;
+			m_RequestedBytes += cache.RequestedBytes;
+			m_BlockBytesAllocated += cache.BlockBytesAllocated;
+			m_BlockBytesFreed += cache.BlockBytesFreed;
+			cache.NumAllocations = 0;
+			cache.NumFrees = 0;
+			cache.RequestedBytes = 0;
+			cache.BlockBytesAllocated = 0;
+			cache.BlockBytesFreed = 0;
+		}
+
+		static void* AllocateLarge(size_t numBytes)
+		{
+			// Mappings are made at slab granularity anyways, so hand all of it out and let realloc grow into it
+			size_t mappedSize = (numBytes + m_SlabHeaderSize + m_SlabSize - 1) & ~(m_SlabSize - 1);
+			int numSlabs = (int)(mappedSize / m_SlabSize);
+			SlabHeader* header = nullptr;
+			if (numSlabs <= m_MaxCachedSpanSlabs)
+			{
+				std::lock_guard<std::mutex> lock(m_SpanCacheMutex);
+				header = m_CachedSpans[numSlabs];
+				if (header)
+				{
+					m_CachedSpans[numSlabs] = header->Next;
+					m_CachedSpanBytes -= mappedSize;
+				}
+			}
+
+			if (header == nullptr)
+			{
+				header = (SlabHeader*)MapPages(mappedSize);
+				if (header == nullptr)
+				{
+					return nullptr;
+				}
+			}
+
+			header->SizeClass = m_LargeSizeClass;
+			header->MappedSize = mappedSize;
+			header->Next = nullptr;
+			m_LargeBytes += mappedSize;
+			m_NumLargeAllocations++;
+			return (uint8*)header + m_SlabHeaderSize;
+		}
+
+		static void FreeLarge(SlabHeader* header)
+		{
+			size_t mappedSize = header->MappedSize;
+			int numSlabs = (int)(mappedSize / m_SlabSize);
+			m_LargeBytes -= mappedSize;
+			if (numSlabs <= m_MaxCachedSpanSlabs)
+			{
+				std::lock_guard<std::mutex> lock(m_SpanCacheMutex);
+				if (m_CachedSpanBytes + mappedSize <= m_MaxCachedSpanBytes)
+				{
+					header->Next = m_CachedSpans[numSlabs];
+					m_CachedSpans[numSlabs] = header;
+					m_CachedSpanBytes += mappedSize;
+					return;
+				}
+			}
+
+			UnmapPages(header, mappedSize);
+		}
+
+		static void* MapPages(size_t numBytes)
+		{
+#ifdef _WIN32
+			// VirtualAlloc hands out memory at the 64KB allocation granularity, which is exactly the slab alignment
+			return VirtualAlloc(nullptr, numBytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+			// Map an extra slab worth of memory and cut off whatever is in front of and after the aligned range
+			size_t mappedSize = numBytes + m_SlabSize;
+			void* memory = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (memory == MAP_FAILED)
+			{
+				return nullptr;
+			}
+
+			uintptr_t start = (uintptr_t)memory;
+			uintptr_t alignedStart = (start + m_SlabSize - 1) & ~(uintptr_t)(m_SlabSize - 1);
+			uintptr_t end = start + mappedSize;
+			uintptr_t pageSize = (uintptr_t)sysconf(_SC_PAGESIZE);
+			uintptr_t alignedEnd = (alignedStart + numBytes + pageSize - 1) & ~(pageSize - 1);
+			if (alignedStart > start)
+			{
+				munmap(memory, alignedStart - start);
+			}
+			if (end > alignedEnd)
+			{
+				munmap((void*)alignedEnd, end - alignedEnd);
+			}
+			return (void*)alignedStart;
+#endif
+		}
+
+		static void UnmapPages(void* memory, size_t numBytes)
+		{
+#ifdef _WIN32
+			VirtualFree(memory, 0, MEM_RELEASE);
+#else
+			munmap(memory, numBytes);
+#endif
+		}
+
+		ThreadCache::~ThreadCache()
+		{
+			// Blocks from before the slabs were given back aren't valid anymore, only the counters are left to flush
+			if (Generation == m_Generation.load())
+			{
+				for (int sizeClass = 0; sizeClass < m_NumSizeClasses; sizeClass++)
+				{
+					if (NumFree[sizeClass] > 0)
+					{
+						ReleaseBatch(*this, sizeClass, NumFree[sizeClass]);
+					}
+				}
+			}
+			FlushStats(*this);
+		}
+	}
+}
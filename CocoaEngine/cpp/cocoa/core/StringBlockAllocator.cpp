@@ -0,0 +1,79 @@
+#include "externalLibs.h"
+#include "cocoa/core/StringBlockAllocator.h"
+#include "cocoa/core/Memory.h"
+#include "cocoa/util/Log.h"
+
+namespace Cocoa
+{
+	namespace NStringBlockAllocator
+	{
+		// Internal Variables
+		static const int m_BlockSizes[StringBlockAllocator::NumBlockSizes] = { 16, 32, 64, 128, 256 };
+
+		// Forward Declarations
+		static int PoolIndex(int length);
+
+		StringBlockAllocator Create()
+		{
+			StringBlockAllocator allocator;
+			for (int i = 0; i < StringBlockAllocator::NumBlockSizes; i++)
+			{
+				// Smaller strings are a lot more common, so they get bigger chunks
+				int blocksPerChunk = 4096 / m_BlockSizes[i];
+				allocator.Pools[i] = NBlockPool::Create(m_BlockSizes[i], blocksPerChunk);
+			}
+			return allocator;
+		}
+
+		void Free(StringBlockAllocator& allocator)
+		{
+			for (int i = 0; i < StringBlockAllocator::NumBlockSizes; i++)
+			{
+				NBlockPool::Free(allocator.Pools[i]);
+			}
+		}
+
+		char* CopyString(StringBlockAllocator& allocator, const char* str, int length)
+		{
+			Log::Assert(length >= 0, "Tried to copy a string with a negative length.");
+			int poolIndex = PoolIndex(length);
+			char* copy = poolIndex >= 0
+				? (char*)NBlockPool::AllocateBlock(allocator.Pools[poolIndex])
+				: (char*)AllocMem(sizeof(char) * (length + 1));
+			memcpy(copy, str, sizeof(char) * length);
+			copy[length] = '\0';
+			return copy;
+		}
+
+		void FreeString(StringBlockAllocator& allocator, const char* str, int length)
+		{
+			if (str == nullptr)
+			{
+				return;
+			}
+
+			int poolIndex = PoolIndex(length);
+			if (poolIndex >= 0)
+			{
+				NBlockPool::FreeBlock(allocator.Pools[poolIndex], (void*)str);
+			}
+			else
+			{
+				FreeMem((void*)str);
+			}
+		}
+
+		// Internal Functions
+		static int PoolIndex(int length)
+		{
+			for (int i = 0; i < StringBlockAllocator::NumBlockSizes; i++)
+			{
+				if (length + 1 <= m_BlockSizes[i])
+				{
+					return i;
+				}
+			}
+			return -1;
+		}
+	}
+}
@@ -203,9 +203,6 @@ namespace Cocoa
 
 		static void Init(CPath& outPath, const char* path, int pathSize)
 		{
-			// TODO: Should be enough characters for any valid path... Maybe make this platform dependent in the future
-			static char pathBuffer[260];
-
 			if (pathSize == 0)
 			{
 				outPath.Path = "";
@@ -219,15 +216,20 @@ namespace Cocoa
 			int pathIndex = 0;
 			int lastDot = -1;
 
+			// The normalized path is never longer than the input, so it gets written straight into the output. This used to
+			// go through a shared static buffer, which broke paths created on other threads and paths over 260 characters
+			outPath.Path.resize(pathSize);
+			char* pathBuffer = &outPath.Path[0];
+
 			const char* iterEnd = path + pathSize;
 			for (const char* iter = path; iter != iterEnd; iter++)
 			{
 				char c = *iter;
-				if (c == '.' && stringIndex > 0 && pathBuffer[stringIndex - 1] != '.')
+				if (c == '.' && stringIndex > 0 && path[stringIndex - 1] != '.')
 				{
 					lastDot = pathIndex;
 				}
-				else if (c == '.' && stringIndex > 0 && pathBuffer[stringIndex - 1] == '.')
+				else if (c == '.' && stringIndex > 0 && path[stringIndex - 1] == '.')
 				{
 					// We have a double dot ..
 					// If .. is at the end of the path or .. is followed by a path separator '/'
@@ -241,7 +243,7 @@ namespace Cocoa
 					}
 				}
 
-				if (IsSeparator(c) && (stringIndex == 0 || stringIndex == 1 || !IsSeparator(pathBuffer[stringIndex - 1])))
+				if (IsSeparator(c) && (stringIndex == 0 || stringIndex == 1 || !IsSeparator(path[stringIndex - 1])))
 				{
 					pathBuffer[pathIndex] = PATH_SEPARATOR;
 					lastPathSeparator = pathIndex;
@@ -255,10 +257,9 @@ namespace Cocoa
 
 				stringIndex++;
 			}
-			pathBuffer[pathIndex] = '\0';
 
 			// TODO: Bug here (repro just open an existing project possibly with a blank name for example '.cprj')
-			outPath.Path = std::string(pathBuffer, pathIndex);
+			outPath.Path.resize(pathIndex);
 			outPath.FilenameOffset = lastPathSeparator >= -1 && lastPathSeparator != pathIndex
 				? lastPathSeparator + 1 : pathIndex;
 			outPath.FileExtOffset = (lastDot == -1 || lastDot < lastPathSeparator || lastPathSeparator == lastDot - 1)
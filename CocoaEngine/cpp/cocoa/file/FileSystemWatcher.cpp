@@ -87,6 +87,9 @@ namespace Cocoa
 			return;
 		}
 
+		// Events only report paths relative to the watched directory
+		PathId directory = NPathId::Intern(m_Path);
+
 		bool result = true;
 		HANDLE hEvents[2];
 		hEvents[0] = pollingOverlap.hEvent;
@@ -119,40 +122,49 @@ namespace Cocoa
 			{
 				pNotify = (FILE_NOTIFY_INFORMATION*)((char*)buffer + offset);
 				strcpy(filename, "");
-				int filenamelen = WideCharToMultiByte(CP_ACP, 0, pNotify->FileName, pNotify->FileNameLength / 2, filename, sizeof(filename), NULL, NULL);
-				filename[pNotify->FileNameLength / 2] = '\0';
-				switch (pNotify->Action)
+				int filenamelen = WideCharToMultiByte(CP_ACP, 0, pNotify->FileName, pNotify->FileNameLength / 2, filename, sizeof(filename) - 1, NULL, NULL);
+				if (filenamelen <= 0)
 				{
-				case FILE_ACTION_ADDED:
-					if (m_OnCreated != nullptr)
-					{
-						m_OnCreated(NCPath::CreatePath(filename));
-					}
-					break;
-				case FILE_ACTION_REMOVED:
-					if (m_OnDeleted != nullptr)
-					{
-						m_OnDeleted(NCPath::CreatePath(filename));
-					}
-					break;
-				case FILE_ACTION_MODIFIED:
-					if (m_OnChanged != nullptr)
-					{
-						m_OnChanged(NCPath::CreatePath(filename));
-					}
-					break;
-				case FILE_ACTION_RENAMED_OLD_NAME:
-					// Log::Info("The file was renamed and this is the old name: [%s]", filename);
-					break;
-				case FILE_ACTION_RENAMED_NEW_NAME:
-					if (m_OnRenamed != nullptr)
+					// Joining an empty name would report the event for the watched directory itself
+					Log::Warning("Could not convert a filename for FileSystemWatcher '%s', skipping the event.", m_Path.Path.c_str());
+				}
+				else
+				{
+					filename[filenamelen] = '\0';
+					PathId file = NPathId::Join(directory, filename, filenamelen);
+					switch (pNotify->Action)
 					{
-						m_OnRenamed(NCPath::CreatePath(filename));
+					case FILE_ACTION_ADDED:
+						if (m_OnCreated != nullptr)
+						{
+							m_OnCreated(file);
+						}
+						break;
+					case FILE_ACTION_REMOVED:
+						if (m_OnDeleted != nullptr)
+						{
+							m_OnDeleted(file);
+						}
+						break;
+					case FILE_ACTION_MODIFIED:
+						if (m_OnChanged != nullptr)
+						{
+							m_OnChanged(file);
+						}
+						break;
+					case FILE_ACTION_RENAMED_OLD_NAME:
+						// Log::Info("The file was renamed and this is the old name: [%s]", filename);
+						break;
+					case FILE_ACTION_RENAMED_NEW_NAME:
+						if (m_OnRenamed != nullptr)
+						{
+							m_OnRenamed(file);
+						}
+						break;
+					default:
+						Log::Error("Default error. Unknown file action '%d' for FileSystemWatcher '%s'", pNotify->Action, m_Path.Path.c_str());
+						break;
 					}
-					break;
-				default:
-					Log::Error("Default error. Unknown file action '%d' for FileSystemWatcher '%s'", pNotify->Action, m_Path.Path.c_str());
-					break;
 				}
 
 				offset += pNotify->NextEntryOffset;
@@ -0,0 +1,447 @@
+#include "cocoa/file/PathId.h"
+#include "cocoa/file/File.h"
+#include "cocoa/core/Memory.h"
+#include "cocoa/util/Log.h"
+#include "cocoa/util/HashMap.h"
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+
+namespace Cocoa
+{
+	namespace NPathId
+	{
+		struct PathEntry
+		{
+			const char* Path;
+			int Size;
+			int FilenameOffset;
+			int FileExtOffset;
+			PathId Parent;
+		};
+
+		// Internal Variables
+		static const char m_WinSeparator = '\\';
+		static const char m_UnixSeparator = '/';
+#ifdef _WIN32
+		static const char m_Separator = m_WinSeparator;
+#else
+		static const char m_Separator = m_UnixSeparator;
+#endif
+		static const int m_EntriesPerBlock = 4096;
+		static const int m_MaxBlocks = 1024;
+		static const size_t m_StringChunkSize = 64 * 1024;
+		static const PathEntry m_NullEntry = { "", 0, 0, 0, { 0 } };
+
+		static std::shared_mutex m_Mutex;
+		// Entries live in blocks that never move once allocated, which is what lets the accessors skip the lock
+		static PathEntry* m_EntryBlocks[m_MaxBlocks];
+		static std::atomic<uint32> m_NumEntries{ 0 };
+		// Hash of the path to its id. If two paths hash to the same key the second one moves on to the next key of its
+		// probe sequence, see FindNormalized
+		static HashMap<uint64, uint32> m_Lookup = NHashMap::Create<uint64, uint32>();
+		// Paths get copied into shared chunks, only really long paths get an allocation of their own
+		static std::vector<char*> m_StringAllocations;
+		static char* m_StringChunk = nullptr;
+		static size_t m_StringChunkUsed = m_StringChunkSize;
+
+		// Forward Declarations
+		static bool IsSeparator(char c);
+		static bool IsAbsolute(const char* path, int length);
+		static void Normalize(const char* path, int length, std::string& outPath);
+		static void NormalizeAbsolute(const char* path, int length, std::string& outPath);
+		static int RootSize(const char* path, int size);
+		static uint64 HashPath(const char* path, int size);
+		static const PathEntry& GetEntry(PathId path);
+		static PathId FindNormalized(const char* path, int size, uint64& outKey);
+		static PathId InternNormalized(const std::string& path);
+		static PathId InsertNormalized(const char* path, int size);
+		static const char* CopyString(const char* str, int size);
+
+		PathId Intern(const CPath& path)
+		{
+			return Intern(path.Path.c_str(), (int)path.Path.size());
+		}
+
+		PathId Intern(const char* path, int length)
+		{
+			if (path == nullptr || length <= 0)
+			{
+				return CreateNull();
+			}
+
+			// Reused so interning a path that's already in the table doesn't allocate
+			static thread_local std::string normalized;
+			Normalize(path, length, normalized);
+			return InternNormalized(normalized);
+		}
+
+		PathId Find(const CPath& path)
+		{
+			if (path.Path.empty())
+			{
+				return CreateNull();
+			}
+
+			static thread_local std::string normalized;
+			Normalize(path.Path.c_str(), (int)path.Path.size(), normalized);
+
+			uint64 key;
+			std::shared_lock<std::shared_mutex> lock(m_Mutex);
+			return FindNormalized(normalized.c_str(), (int)normalized.size(), key);
+		}
+
+		PathId Join(PathId directory, const char* relativePath, int length)
+		{
+			if (relativePath == nullptr || length <= 0)
+			{
+				return directory;
+			}
+
+			if (IsNull(directory) || IsAbsolute(relativePath, length))
+			{
+				return Intern(relativePath, length);
+			}
+
+			static thread_local std::string joined;
+			static thread_local std::string normalized;
+			const PathEntry& entry = GetEntry(directory);
+			joined.assign(entry.Path, entry.Size);
+			joined += m_Separator;
+			joined.append(relativePath, length);
+			NormalizeAbsolute(joined.c_str(), (int)joined.size(), normalized);
+			return InternNormalized(normalized);
+		}
+
+		PathId Join(PathId directory, const char* relativePath)
+		{
+			return Join(directory, relativePath, relativePath ? (int)strlen(relativePath) : 0);
+		}
+
+		PathId Parent(PathId path)
+		{
+			return GetEntry(path).Parent;
+		}
+
+		const char* Filepath(PathId path)
+		{
+			return GetEntry(path).Path;
+		}
+
+		int Size(PathId path)
+		{
+			return GetEntry(path).Size;
+		}
+
+		const char* Filename(PathId path)
+		{
+			const PathEntry& entry = GetEntry(path);
+			return entry.Path + entry.FilenameOffset;
+		}
+
+		int FilenameSize(PathId path)
+		{
+			const PathEntry& entry = GetEntry(path);
+			return entry.Size - entry.FilenameOffset;
+		}
+
+		const char* FileExt(PathId path)
+		{
+			const PathEntry& entry = GetEntry(path);
+			return entry.Path + entry.FileExtOffset;
+		}
+
+		int FileExtSize(PathId path)
+		{
+			const PathEntry& entry = GetEntry(path);
+			return entry.Size - entry.FileExtOffset;
+		}
+
+		CPath ToCPath(PathId path)
+		{
+			return NCPath::CreatePath(Filepath(path));
+		}
+
+		void Destroy()
+		{
+			std::unique_lock<std::shared_mutex> lock(m_Mutex);
+			for (char* allocation : m_StringAllocations)
+			{
+				FreeMem(allocation);
+			}
+			m_StringAllocations.clear();
+			m_StringChunk = nullptr;
+			m_StringChunkUsed = m_StringChunkSize;
+
+			for (int i = 0; i < m_MaxBlocks; i++)
+			{
+				if (m_EntryBlocks[i])
+				{
+					FreeMem(m_EntryBlocks[i]);
+					m_EntryBlocks[i] = nullptr;
+				}
+			}
+			m_NumEntries = 0;
+			NHashMap::Free(m_Lookup);
+		}
+
+		// Internal Functions
+		static bool IsSeparator(char c)
+		{
+			return c == m_WinSeparator || c == m_UnixSeparator;
+		}
+
+		static bool IsAbsolute(const char* path, int length)
+		{
+#ifdef _WIN32
+			// 'C:\' or '\\server\share'. A single leading separator is still relative to the current drive
+			return (length >= 3 && path[1] == ':' && IsSeparator(path[2]))
+				|| (length >= 2 && IsSeparator(path[0]) && IsSeparator(path[1]));
+#else
+			return length >= 1 && IsSeparator(path[0]);
+#endif
+		}
+
+		static void Normalize(const char* path, int length, std::string& outPath)
+		{
+			if (IsAbsolute(path, length))
+			{
+				NormalizeAbsolute(path, length, outPath);
+				return;
+			}
+
+			// Only relative paths need the working directory, everything else is done without touching the file system
+			CPath absolutePath = File::GetAbsolutePath(NCPath::CreatePath(std::string(path, length)));
+			NormalizeAbsolute(absolutePath.Path.c_str(), (int)absolutePath.Path.size(), outPath);
+		}
+
+		static void NormalizeAbsolute(const char* path, int length, std::string& outPath)
+		{
+			outPath.clear();
+			int index = 0;
+			if (length >= 2 && !IsSeparator(path[0]) && path[1] == ':')
+			{
+				outPath.append(path, 2);
+				outPath += m_Separator;
+				index = 2;
+			}
+			else if (length >= 2 && IsSeparator(path[0]) && IsSeparator(path[1]))
+			{
+				outPath += m_Separator;
+				outPath += m_Separator;
+				index = 2;
+			}
+			else if (length >= 1 && IsSeparator(path[0]))
+			{
+				outPath += m_Separator;
+				index = 1;
+			}
+			// '..' never goes above the root
+			size_t rootSize = outPath.size();
+
+			while (index < length)
+			{
+				while (index < length && IsSeparator(path[index]))
+				{
+					index++;
+				}
+
+				int segmentStart = index;
+				while (index < length && !IsSeparator(path[index]))
+				{
+					index++;
+				}
+				int segmentSize = index - segmentStart;
+
+				if (segmentSize == 0 || (segmentSize == 1 && path[segmentStart] == '.'))
+				{
+					continue;
+				}
+
+				if (segmentSize == 2 && path[segmentStart] == '.' && path[segmentStart + 1] == '.')
+				{
+					size_t lastSeparator = outPath.rfind(m_Separator);
+					outPath.resize(lastSeparator != std::string::npos && lastSeparator >= rootSize ? lastSeparator : rootSize);
+					continue;
+				}
+
+				if (outPath.size() > rootSize)
+				{
+					outPath += m_Separator;
+				}
+				outPath.append(&path[segmentStart], segmentSize);
+			}
+		}
+
+		static int RootSize(const char* path, int size)
+		{
+			if (size >= 3 && path[1] == ':' && path[2] == m_Separator)
+			{
+				return 3;
+			}
+			else if (size >= 2 && path[0] == m_Separator && path[1] == m_Separator)
+			{
+				return 2;
+			}
+			else if (size >= 1 && path[0] == m_Separator)
+			{
+				return 1;
+			}
+			return 0;
+		}
+
+		static uint64 HashPath(const char* path, int size)
+		{
+			// FNV-1a
+			uint64 hash = 14695981039346656037ull;
+			for (int i = 0; i < size; i++)
+			{
+				hash = (hash ^ (uint8)path[i]) * 1099511628211ull;
+			}
+			return hash;
+		}
+
+		static const PathEntry& GetEntry(PathId path)
+		{
+			if (IsNull(path))
+			{
+				return m_NullEntry;
+			}
+
+			Log::Assert(path.Id <= m_NumEntries.load(std::memory_order_relaxed), "Invalid path id '%u'.", path.Id);
+			uint32 index = path.Id - 1;
+			return m_EntryBlocks[index / m_EntriesPerBlock][index % m_EntriesPerBlock];
+		}
+
+		// Needs at least a shared lock. outKey is set to the key the path is or would be stored under
+		static PathId FindNormalized(const char* path, int size, uint64& outKey)
+		{
+			uint64 key = HashPath(path, size);
+			while (true)
+			{
+				const uint32* id = NHashMap::Get(m_Lookup, key);
+				if (id == nullptr)
+				{
+					outKey = key;
+					return CreateNull();
+				}
+
+				const PathEntry& entry = GetEntry({ *id });
+				if (entry.Size == size && memcmp(entry.Path, path, size) == 0)
+				{
+					outKey = key;
+					return { *id };
+				}
+
+				// Collision, every path walks the same sequence of keys so lookups and inserts agree
+				key = key * 6364136223846793005ull + 1442695040888963407ull;
+			}
+		}
+
+		static PathId InternNormalized(const std::string& path)
+		{
+			uint64 key;
+			{
+				std::shared_lock<std::shared_mutex> lock(m_Mutex);
+				PathId id = FindNormalized(path.c_str(), (int)path.size(), key);
+				if (!IsNull(id))
+				{
+					return id;
+				}
+			}
+
+			std::unique_lock<std::shared_mutex> lock(m_Mutex);
+			return InsertNormalized(path.c_str(), (int)path.size());
+		}
+
+		// Needs the exclusive lock
+		static PathId InsertNormalized(const char* path, int size)
+		{
+			uint64 key;
+			PathId existing = FindNormalized(path, size, key);
+			if (!IsNull(existing))
+			{
+				return existing;
+			}
+
+			int rootSize = RootSize(path, size);
+			int lastSeparator = size - 1;
+			while (lastSeparator >= 0 && path[lastSeparator] != m_Separator)
+			{
+				lastSeparator--;
+			}
+
+			// Parents go in first, so a new file in a directory that's already known only costs one extra lookup
+			PathId parent = CreateNull();
+			if (size > rootSize)
+			{
+				parent = InsertNormalized(path, lastSeparator >= rootSize ? lastSeparator : rootSize);
+				FindNormalized(path, size, key);
+			}
+
+			uint32 index = m_NumEntries.load(std::memory_order_relaxed);
+			int block = (int)(index / m_EntriesPerBlock);
+			if (block >= m_MaxBlocks)
+			{
+				Log::Error("Path table is full, could not add '%.*s'.", size, path);
+				return CreateNull();
+			}
+
+			if (m_EntryBlocks[block] == nullptr)
+			{
+				m_EntryBlocks[block] = (PathEntry*)AllocMem(sizeof(PathEntry) * m_EntriesPerBlock);
+			}
+
+			int filenameOffset = lastSeparator + 1 > rootSize ? lastSeparator + 1 : rootSize;
+			// A dot at the start of the filename doesn't start an extension, same as CPath
+			int fileExtOffset = size;
+			for (int i = size - 1; i > filenameOffset; i--)
+			{
+				if (path[i] == '.')
+				{
+					fileExtOffset = i;
+					break;
+				}
+			}
+
+			PathEntry& entry = m_EntryBlocks[block][index % m_EntriesPerBlock];
+			entry.Path = CopyString(path, size);
+			entry.Size = size;
+			entry.FilenameOffset = filenameOffset;
+			entry.FileExtOffset = fileExtOffset;
+			entry.Parent = parent;
+			m_NumEntries.store(index + 1, std::memory_order_release);
+
+			PathId id = { index + 1 };
+			NHashMap::Put(m_Lookup, key, id.Id);
+			return id;
+		}
+
+		static const char* CopyString(const char* str, int size)
+		{
+			size_t numBytes = size + 1;
+			char* copy;
+			if (numBytes > m_StringChunkSize / 4)
+			{
+				copy = (char*)AllocMem(numBytes);
+				m_StringAllocations.push_back(copy);
+			}
+			else
+			{
+				if (m_StringChunkUsed + numBytes > m_StringChunkSize)
+				{
+					m_StringChunk = (char*)AllocMem(m_StringChunkSize);
+					m_StringAllocations.push_back(m_StringChunk);
+					m_StringChunkUsed = 0;
+				}
+				copy = m_StringChunk + m_StringChunkUsed;
+				m_StringChunkUsed += numBytes;
+			}
+
+			memcpy(copy, str, size);
+			copy[size] = '\0';
+			return copy;
+		}
+	}
+}
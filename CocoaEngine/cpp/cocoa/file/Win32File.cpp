@@ -2,7 +2,9 @@
 #include "cocoa/file/File.h"
 #include "cocoa/util/Log.h"
 #include "cocoa/core/Memory.h"
+#include "cocoa/core/Pool.h"
 
+#include <mutex>
 #include <direct.h>
 #include <shobjidl_core.h>
 #include <shlobj.h>
@@ -22,9 +24,18 @@ namespace Cocoa
 {
 	namespace File
 	{
+		// Internal Variables
+		// Files get opened from the file watcher thread and the main thread at the same time, and pools aren't thread safe
+		static std::mutex m_FileHandlesMutex;
+		static Pool<FileHandle> m_FileHandles = NPool::Create<FileHandle>(16);
+
 		FileHandle* OpenFile(const CPath& filename)
 		{
-			FileHandle* file = (FileHandle*)AllocMem(sizeof(FileHandle));
+			FileHandle* file;
+			{
+				std::lock_guard<std::mutex> lock(m_FileHandlesMutex);
+				file = NPool::New(m_FileHandles);
+			}
 			file->m_Filename = filename.Path.c_str();
 
 			FILE* filePointer;
@@ -79,7 +90,10 @@ namespace Cocoa
 				{
 					Log::Warning("Tried to free invalid file.");
 				}
-				FreeMem(file);
+				{
+					std::lock_guard<std::mutex> lock(m_FileHandlesMutex);
+					NPool::Delete(m_FileHandles, file);
+				}
 				file = nullptr;
 			}
 			else
@@ -1,5 +1,6 @@
 #include "cocoa/physics2d/Physics2D.h"
 #include "cocoa/components/Transform.h"
+#include "cocoa/scenes/ComponentGroups.h"
 #include "cocoa/core/Application.h"
 #include "cocoa/util/CMath.h"
 #include "cocoa/util/Settings.h"
@@ -130,18 +131,14 @@ namespace Cocoa
 				m_PhysicsTime -= Settings::Physics2D::s_Timestep;
 			}
 
-			auto view = scene.Registry.view<TransformData, Rigidbody2D>();
-			for (entt::entity rawEntity : view)
+			ComponentGroups::Rigidbodies(scene).each([](auto entity, Rigidbody2D& rb, TransformData& transform)
 			{
-				Entity entity = { rawEntity };
-				TransformData& transform = NEntity::GetComponent<TransformData>(entity);
-				Rigidbody2D& rb = NEntity::GetComponent<Rigidbody2D>(entity);
 				b2Body* body = static_cast<b2Body*>(rb.m_RawRigidbody);
 				b2Vec2 position = body->GetPosition();
 				transform.Position.x = position.x;
 				transform.Position.y = position.y;
 				transform.EulerRotation.z = CMath::ToDegrees(body->GetAngle());
-			}
+			});
 		}
 
 		void ApplyForce(Entity entity, glm::vec2 force)
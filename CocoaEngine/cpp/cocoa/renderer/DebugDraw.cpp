@@ -23,31 +23,77 @@ namespace Cocoa
 			{ -0.5f, -0.5f },
 		};
 
+		// Internal Structures
+		struct ArenaBlock
+		{
+			uint8* Memory;
+			int Used;
+			int Capacity;
+		};
+
+		// Every primitive that expires on the same frame lives in the same bucket. Shape vertices are bump allocated
+		// out of the bucket's arena, so when the bucket expires everything in it is released at once by resetting
+		// the array counts and arena offsets. None of the memory is returned to the heap until Destroy is called.
+		struct LifetimeBucket
+		{
+			DynamicArray<Line2D> Lines;
+			DynamicArray<DebugSprite> Sprites;
+			DynamicArray<DebugShape> Shapes;
+			DynamicArray<ArenaBlock> ArenaBlocks;
+			int CurrentArenaBlock;
+		};
+
 		// Internal Variables
 		static DynamicArray<RenderBatchData> m_Batches;
-		static DynamicArray<Line2D> m_Lines;
-		static DynamicArray<DebugSprite> m_Sprites;
-		static DynamicArray<DebugShape> m_Shapes;
 		static Handle<Shader> m_Shader;
 
+		static Handle<Shader> m_GridShader;
+		static uint32 m_GridVao = (uint32)-1;
+		static bool m_DrawGrid = false;
+		static glm::vec2 m_GridSize;
+		static float m_GridStrokeWidth;
+		static glm::vec3 m_GridColor;
+		static int m_GridMajorLineEvery;
+
+		// NOTE: This must be a power of two. Primitives that live longer than m_NumLifetimeBuckets - 1 frames
+		// get moved to a later bucket when their current bucket expires
+		static const int m_NumLifetimeBuckets = 32;
+		static const int m_MaxBucketSpan = m_NumLifetimeBuckets - 1;
+		static const int m_ArenaBlockSize = 16 * 1024;
+		static LifetimeBucket m_Buckets[m_NumLifetimeBuckets];
+		static uint32 m_FrameIndex = 0;
+
 		static const int m_TexSlots[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
 		static const int m_MaxBatchSize = 500;
 
 		// Forward Declarations
-		static void RemoveDeadSprites();
-		static void RemoveDeadLines();
-		static void RemoveDeadShapes();
-		static void AddSpritesToBatches();
-		static void AddLinesToBatches();
-		static void AddShapesToBatches();
+		static LifetimeBucket& GetBucket(int framesToLive, int& outFramesRemaining);
+		static void* ArenaAllocate(LifetimeBucket& bucket, int numBytes);
+		static void ReleaseBucket(LifetimeBucket& bucket);
+		static void DrawGrid(const Camera& camera);
+		static void PushLine(const Line2D& line, int framesToLive);
+		static void PushSprite(const DebugSprite& sprite, int framesToLive);
+		static void PushShape(const DebugShape& shape, int framesToLive);
+		static void AddSpritesToBatches(const DynamicArray<DebugSprite>& sprites);
+		static void AddLinesToBatches(const DynamicArray<Line2D>& lines);
+		static void AddShapesToBatches(const DynamicArray<DebugShape>& shapes);
 
 		void Init()
 		{
 			m_Batches = NDynamicArray::Create<RenderBatchData>();
-			m_Lines = NDynamicArray::Create<Line2D>();
-			m_Sprites = NDynamicArray::Create<DebugSprite>();
-			m_Shapes = NDynamicArray::Create<DebugShape>();
+			for (int i = 0; i < m_NumLifetimeBuckets; i++)
+			{
+				LifetimeBucket& bucket = m_Buckets[i];
+				bucket.Lines = NDynamicArray::Create<Line2D>();
+				bucket.Sprites = NDynamicArray::Create<DebugSprite>();
+				bucket.Shapes = NDynamicArray::Create<DebugShape>();
+				bucket.ArenaBlocks = NDynamicArray::Create<ArenaBlock>();
+				bucket.CurrentArenaBlock = 0;
+			}
+			m_FrameIndex = 0;
 			m_Shader = Handle<Shader>();
+			m_GridShader = Handle<Shader>();
+			m_DrawGrid = false;
 		}
 
 		void Destroy()
@@ -57,14 +103,25 @@ namespace Cocoa
 				RenderBatch::Free(m_Batches.m_Data[i]);
 			}
 			NDynamicArray::Free<RenderBatchData>(m_Batches);
-			NDynamicArray::Free<Line2D>(m_Lines);
-			NDynamicArray::Free<DebugSprite>(m_Sprites);
 
-			for (int i = 0; i < m_Shapes.m_NumElements; i++)
+			for (int i = 0; i < m_NumLifetimeBuckets; i++)
 			{
-				FreeMem(m_Shapes.m_Data[i].Vertices);
+				LifetimeBucket& bucket = m_Buckets[i];
+				NDynamicArray::Free<Line2D>(bucket.Lines);
+				NDynamicArray::Free<DebugSprite>(bucket.Sprites);
+				NDynamicArray::Free<DebugShape>(bucket.Shapes);
+				for (int block = 0; block < bucket.ArenaBlocks.m_NumElements; block++)
+				{
+					FreeMem(bucket.ArenaBlocks.m_Data[block].Memory);
+				}
+				NDynamicArray::Free<ArenaBlock>(bucket.ArenaBlocks);
+			}
+
+			if (m_GridVao != (uint32)-1)
+			{
+				glDeleteVertexArrays(1, &m_GridVao);
+				m_GridVao = (uint32)-1;
 			}
-			NDynamicArray::Free<DebugShape>(m_Shapes);
 		}
 
 		void BeginFrame()
@@ -76,16 +133,40 @@ namespace Cocoa
 				m_Shader = AssetManager::GetShader(shaderPath);
 			}
 
-			RemoveDeadLines();
-			RemoveDeadSprites();
-			RemoveDeadShapes();
+			if (m_GridShader.IsNull())
+			{
+				CPath gridShaderPath = Settings::General::s_EngineAssetsPath;
+				NCPath::Join(gridShaderPath, NCPath::CreatePath("shaders/Grid2D.glsl"));
+				m_GridShader = AssetManager::GetShader(gridShaderPath);
+			}
+
+			// The grid has to be requested again every frame
+			m_DrawGrid = false;
+
+			// Everything that expires this frame sits in the same bucket, so release it all at once
+			m_FrameIndex++;
+			ReleaseBucket(m_Buckets[m_FrameIndex & m_MaxBucketSpan]);
 		}
 
 		void DrawBottomBatches(const Camera& camera)
 		{
-			AddLinesToBatches();
-			AddSpritesToBatches();
-			AddShapesToBatches();
+			if (m_DrawGrid)
+			{
+				DrawGrid(camera);
+			}
+
+			for (int i = 0; i < m_NumLifetimeBuckets; i++)
+			{
+				AddLinesToBatches(m_Buckets[i].Lines);
+			}
+			for (int i = 0; i < m_NumLifetimeBuckets; i++)
+			{
+				AddSpritesToBatches(m_Buckets[i].Sprites);
+			}
+			for (int i = 0; i < m_NumLifetimeBuckets; i++)
+			{
+				AddShapesToBatches(m_Buckets[i].Shapes);
+			}
 
 			const Shader& shaderRef = AssetManager::GetShader(m_Shader.m_AssetId);
 			NShader::Bind(shaderRef);
@@ -128,9 +209,21 @@ namespace Cocoa
 		// ===================================================================================================================
 		// Draw Primitive Methods
 		// ===================================================================================================================
+		void AddGrid2D(const glm::vec2& gridSize, float strokeWidth, const glm::vec3& color, int majorLineEvery)
+		{
+			Log::Assert(majorLineEvery > 0, "Grid major line interval must be greater than 0.");
+			m_DrawGrid = true;
+			m_GridSize = gridSize;
+			m_GridStrokeWidth = strokeWidth;
+			m_GridColor = color;
+			m_GridMajorLineEvery = majorLineEvery;
+		}
+
 		void AddLine2D(glm::vec2& from, glm::vec2& to, float strokeWidth, glm::vec3 color, int lifetime, bool onTop)
 		{
-			NDynamicArray::Add<Line2D>(m_Lines, NLine2D::Create(from, to, color, strokeWidth, lifetime, onTop));
+			// Lines are kept alive for one extra frame since some of them are added after the scene has been rendered
+			// (the inspector draws collider outlines during ImGui for example)
+			PushLine(NLine2D::Create(from, to, color, strokeWidth, lifetime, onTop), lifetime + 1);
 		}
 
 		void AddBox2D(glm::vec2& center, glm::vec2& dimensions, float rotation, float strokeWidth, glm::vec3 color, int lifetime, bool onTop)
@@ -179,7 +272,7 @@ namespace Cocoa
 			int lifetime,
 			bool onTop)
 		{
-			NDynamicArray::Add<DebugSprite>(m_Sprites, DebugSprite{ spriteTexture, size, position, tint, texCoordMin, texCoordMax, rotation, lifetime, onTop });
+			PushSprite(DebugSprite{ spriteTexture, size, position, tint, texCoordMin, texCoordMax, rotation, lifetime, onTop }, lifetime);
 		}
 
 		void AddShape(
@@ -193,8 +286,9 @@ namespace Cocoa
 			int lifetime, 
 			bool onTop)
 		{
-			// TODO: Maybe do this differently? I really don't like allocating and freeing so much small bits of memory
-			glm::vec2* vertsCopy = (glm::vec2*)AllocMem(sizeof(glm::vec2) * numVertices);
+			int framesRemaining;
+			LifetimeBucket& bucket = GetBucket(lifetime, framesRemaining);
+			glm::vec2* vertsCopy = (glm::vec2*)ArenaAllocate(bucket, sizeof(glm::vec2) * numVertices);
 			memcpy(vertsCopy, vertices, sizeof(glm::vec2) * numVertices);
 			if (!CMath::Compare(rotation, 0.0f) || !CMath::Compare(scale, {1.0f, 1.0f}))
 			{
@@ -207,74 +301,157 @@ namespace Cocoa
 					vertsCopy[i] = glm::vec2(transformedPos.x, transformedPos.y);
 				}
 			}
-			NDynamicArray::Add<DebugShape>(m_Shapes, DebugShape{ vertsCopy, numVertices, numElements, glm::vec3(color), glm::vec2(position), rotation, lifetime, onTop });
+			NDynamicArray::Add<DebugShape>(bucket.Shapes, DebugShape{ vertsCopy, numVertices, numElements, glm::vec3(color), glm::vec2(position), rotation, framesRemaining, onTop });
 		}
 
 
 		// ===================================================================================================================
 		// Private methods
 		// ===================================================================================================================
-		static void RemoveDeadSprites()
+		static LifetimeBucket& GetBucket(int framesToLive, int& outFramesRemaining)
 		{
-			int index = 0;
-			while (index < m_Sprites.m_NumElements)
+			// Anything with a lifetime of 0 or less still gets drawn once
+			framesToLive = CMath::Max(framesToLive, 1);
+			if (framesToLive > m_MaxBucketSpan)
 			{
-				DebugSprite& spriteIter = m_Sprites.m_Data[index];
-				spriteIter.Lifetime--;
-				if (spriteIter.Lifetime <= 0)
-				{
-					NDynamicArray::Remove<DebugSprite>(m_Sprites, index);
-				}
-				else
-				{
-					index++;
-				}
+				// Park long lived primitives in the furthest bucket and keep track of how many frames they have left
+				// once that bucket expires
+				outFramesRemaining = framesToLive - m_MaxBucketSpan;
+				return m_Buckets[(m_FrameIndex + m_MaxBucketSpan) & m_MaxBucketSpan];
 			}
+
+			outFramesRemaining = 0;
+			return m_Buckets[(m_FrameIndex + framesToLive) & m_MaxBucketSpan];
 		}
 
-		static void RemoveDeadLines()
+		static void* ArenaAllocate(LifetimeBucket& bucket, int numBytes)
 		{
-			auto index = 0;
-			while (index != m_Lines.m_NumElements)
+			while (bucket.CurrentArenaBlock < bucket.ArenaBlocks.m_NumElements)
 			{
-				Line2D& lineIter = m_Lines.m_Data[index];
-				lineIter.Lifetime--;
-				// TODO: Investigate why this needs < but RemoveDeadShapes only needs <=
-				if (lineIter.Lifetime < 0)
+				ArenaBlock& block = bucket.ArenaBlocks.m_Data[bucket.CurrentArenaBlock];
+				if (block.Used + numBytes <= block.Capacity)
 				{
-					NDynamicArray::Remove<Line2D>(m_Lines, index);
-				}
-				else
-				{
-					index++;
+					void* memory = block.Memory + block.Used;
+					block.Used += numBytes;
+					return memory;
 				}
+				bucket.CurrentArenaBlock++;
 			}
+
+			// None of the existing blocks have room, so chain a new one. Blocks are never moved, which keeps the
+			// vertex pointers of older shapes in this bucket valid
+			int capacity = CMath::Max(numBytes, m_ArenaBlockSize);
+			ArenaBlock newBlock = { (uint8*)AllocMem(capacity), numBytes, capacity };
+			NDynamicArray::Add<ArenaBlock>(bucket.ArenaBlocks, newBlock);
+			bucket.CurrentArenaBlock = bucket.ArenaBlocks.m_NumElements - 1;
+			return newBlock.Memory;
 		}
 
-		static void RemoveDeadShapes()
+		static void ReleaseBucket(LifetimeBucket& bucket)
 		{
-			auto index = 0;
-			while (index != m_Shapes.m_NumElements)
+			// Move anything that has not actually expired yet into its next bucket before resetting this one.
+			// The destination is never this bucket, since it is at least one frame away
+			for (int i = 0; i < bucket.Lines.m_NumElements; i++)
 			{
-				DebugShape& shapeIter = m_Shapes.m_Data[index];
-				shapeIter.Lifetime--;
-				if (shapeIter.Lifetime <= 0)
+				const Line2D& line = bucket.Lines.m_Data[i];
+				if (line.Lifetime > 0)
 				{
-					FreeMem(m_Shapes.m_Data[index].Vertices);
-					NDynamicArray::Remove<DebugShape>(m_Shapes, index);
+					PushLine(line, line.Lifetime);
 				}
-				else
+			}
+
+			for (int i = 0; i < bucket.Sprites.m_NumElements; i++)
+			{
+				const DebugSprite& sprite = bucket.Sprites.m_Data[i];
+				if (sprite.Lifetime > 0)
+				{
+					PushSprite(sprite, sprite.Lifetime);
+				}
+			}
+
+			for (int i = 0; i < bucket.Shapes.m_NumElements; i++)
+			{
+				const DebugShape& shape = bucket.Shapes.m_Data[i];
+				if (shape.Lifetime > 0)
 				{
-					index++;
+					PushShape(shape, shape.Lifetime);
 				}
 			}
+
+			NDynamicArray::Clear<Line2D>(bucket.Lines, false);
+			NDynamicArray::Clear<DebugSprite>(bucket.Sprites, false);
+			NDynamicArray::Clear<DebugShape>(bucket.Shapes, false);
+			for (int i = 0; i < bucket.ArenaBlocks.m_NumElements; i++)
+			{
+				bucket.ArenaBlocks.m_Data[i].Used = 0;
+			}
+			bucket.CurrentArenaBlock = 0;
+		}
+
+		static void PushLine(const Line2D& line, int framesToLive)
+		{
+			int framesRemaining;
+			LifetimeBucket& bucket = GetBucket(framesToLive, framesRemaining);
+			NDynamicArray::Add<Line2D>(bucket.Lines, line);
+			bucket.Lines.m_Data[bucket.Lines.m_NumElements - 1].Lifetime = framesRemaining;
+		}
+
+		static void PushSprite(const DebugSprite& sprite, int framesToLive)
+		{
+			int framesRemaining;
+			LifetimeBucket& bucket = GetBucket(framesToLive, framesRemaining);
+			NDynamicArray::Add<DebugSprite>(bucket.Sprites, sprite);
+			bucket.Sprites.m_Data[bucket.Sprites.m_NumElements - 1].Lifetime = framesRemaining;
+		}
+
+		static void PushShape(const DebugShape& shape, int framesToLive)
+		{
+			int framesRemaining;
+			LifetimeBucket& bucket = GetBucket(framesToLive, framesRemaining);
+			glm::vec2* vertsCopy = (glm::vec2*)ArenaAllocate(bucket, sizeof(glm::vec2) * shape.NumVertices);
+			memcpy(vertsCopy, shape.Vertices, sizeof(glm::vec2) * shape.NumVertices);
+
+			DebugShape movedShape = shape;
+			movedShape.Vertices = vertsCopy;
+			movedShape.Lifetime = framesRemaining;
+			NDynamicArray::Add<DebugShape>(bucket.Shapes, movedShape);
+		}
+
+		static void DrawGrid(const Camera& camera)
+		{
+			if (m_GridShader.IsNull())
+			{
+				return;
+			}
+
+			// The grid shader builds a full screen triangle from gl_VertexID, but core profile
+			// still requires a vertex array to be bound for the draw call
+			if (m_GridVao == (uint32)-1)
+			{
+				glGenVertexArrays(1, &m_GridVao);
+			}
+
+			const Shader& shaderRef = AssetManager::GetShader(m_GridShader.m_AssetId);
+			NShader::Bind(shaderRef);
+			NShader::UploadMat4(shaderRef, "uInverseView", camera.InverseView);
+			NShader::UploadMat4(shaderRef, "uInverseProjection", camera.InverseProjection);
+			NShader::UploadVec2(shaderRef, "uGridSize", m_GridSize);
+			NShader::UploadFloat(shaderRef, "uStrokeWidth", m_GridStrokeWidth);
+			NShader::UploadVec3(shaderRef, "uColor", m_GridColor);
+			NShader::UploadInt(shaderRef, "uMajorLineEvery", m_GridMajorLineEvery);
+
+			glBindVertexArray(m_GridVao);
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+			glBindVertexArray(0);
+
+			NShader::Unbind(shaderRef);
 		}
 
-		static void AddSpritesToBatches()
+		static void AddSpritesToBatches(const DynamicArray<DebugSprite>& sprites)
 		{
-			for (int i = 0; i < m_Sprites.m_NumElements; i++)
+			for (int i = 0; i < sprites.m_NumElements; i++)
 			{
-				const DebugSprite& sprite = m_Sprites.m_Data[i];
+				const DebugSprite& sprite = sprites.m_Data[i];
 				bool wasAdded = false;
 				bool spriteOnTop = sprite.OnTop;
 				for (auto batch = NDynamicArray::Begin<RenderBatchData>(m_Batches); batch != NDynamicArray::End<RenderBatchData>(m_Batches); batch++)
@@ -318,9 +495,9 @@ namespace Cocoa
 			}
 		}
 
-		static void AddLinesToBatches()
+		static void AddLinesToBatches(const DynamicArray<Line2D>& lines)
 		{
-			for (auto line = NDynamicArray::Begin<Line2D>(m_Lines); line != NDynamicArray::End<Line2D>(m_Lines); line++)
+			for (const Line2D* line = lines.m_Data; line != lines.m_Data + lines.m_NumElements; line++)
 			{
 				bool wasAdded = false;
 				bool lineOnTop = line->OnTop;
@@ -344,9 +521,9 @@ namespace Cocoa
 			}
 		}
 
-		static void AddShapesToBatches()
+		static void AddShapesToBatches(const DynamicArray<DebugShape>& shapes)
 		{
-			for (auto shape = NDynamicArray::Begin<DebugShape>(m_Shapes); shape != NDynamicArray::End<DebugShape>(m_Shapes); shape++)
+			for (const DebugShape* shape = shapes.m_Data; shape != shapes.m_Data + shapes.m_NumElements; shape++)
 			{
 				bool wasAdded = false;
 				bool shapeOnTop = shape->OnTop;
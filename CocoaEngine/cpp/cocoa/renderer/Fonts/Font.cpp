@@ -2,6 +2,7 @@
 #include "cocoa/renderer/fonts/FontUtil.h"
 #include "cocoa/core/AssetManager.h"
 #include "cocoa/core/Memory.h"
+#include "cocoa/file/File.h"
 #include "cocoa/util/JsonExtended.h"
 
 #include <stb/stb_image.h>
@@ -12,6 +13,33 @@ namespace Cocoa
 	CharInfo Font::nullCharacter = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 	Font Font::nullFont = Font();
 
+	// Internal Variables
+	// The metrics file is this header followed directly by the packed CharInfo array. From version 2 on
+	// the character map is followed by the layout header and the kerning pairs
+	struct FontMetricsHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		int32 GlyphRangeStart;
+		int32 GlyphRangeEnd;
+		int32 CharacterMapSize;
+		uint32 CharInfoSize;
+	};
+
+	struct FontLayoutHeader
+	{
+		float LineHeight;
+		int32 NumKerningPairs;
+	};
+
+	static const uint32 m_MetricsMagic = 'C' | ('F' << 8) | ('N' << 16) | ('T' << 24);
+	static const uint32 m_MetricsVersion = 2;
+	static const char* m_MetricsExtension = ".fontmetrics";
+
+	// Forward Declarations
+	static void SerializeLegacyCharacterMap(const Font& font, json& j);
+	static void DeserializeLegacyCharacterMap(Font& font, const json& j);
+
 	Font::Font()
 	{
 		m_IsNull = true;
@@ -31,9 +59,10 @@ namespace Cocoa
 
 	const CharInfo& Font::GetCharacterInfo(int codepoint) const
 	{
-		if (codepoint < m_CharacterMapSize && codepoint >= 0)
+		int index = codepoint - m_GlyphRangeStart;
+		if (index < m_CharacterMapSize && index >= 0)
 		{
-			return m_CharacterMap[codepoint];
+			return m_CharacterMap[index];
 		}
 		else
 		{
@@ -41,23 +70,211 @@ namespace Cocoa
 		}
 	}
 
-	void Font::GenerateSdf(const CPath& fontFile, int fontSize, const CPath& outputFile, int glyphRangeStart, int glyphRangeEnd, int padding, int upscaleResolution)
+	float Font::GetKerning(uint32 left, uint32 right) const
+	{
+		if (m_Kerning.empty())
+		{
+			return 0.0f;
+		}
+
+		auto iter = m_Kerning.find(((uint64)left << 32) | right);
+		return iter != m_Kerning.end() ? iter->second : 0.0f;
+	}
+
+	void Font::GenerateSdf(const CPath& fontFile, int fontSize, const CPath& outputFile, int glyphRangeStart, int glyphRangeEnd, int padding, int upscaleResolution,
+		std::atomic<int>* glyphsCompleted, DistanceFieldType fieldType)
 	{
 		m_GlyphRangeStart = glyphRangeStart;
 		m_GlyphRangeEnd = glyphRangeEnd;
+		m_FontSize = fontSize;
+		m_Padding = padding;
+		m_UpscaleResolution = upscaleResolution;
+		m_FieldType = fieldType;
 		m_CharacterMap = (CharInfo*)AllocMem(sizeof(CharInfo) * (glyphRangeEnd - glyphRangeStart));
 		m_CharacterMapSize = glyphRangeEnd - glyphRangeStart;
-		FontUtil::CreateSdfFontTexture(fontFile, fontSize, m_CharacterMap, (glyphRangeEnd - glyphRangeStart), outputFile, padding, upscaleResolution, glyphRangeStart);
+		FontUtil::CreateSdfFontTexture(fontFile, fontSize, m_CharacterMap, (glyphRangeEnd - glyphRangeStart), outputFile, padding, upscaleResolution, glyphRangeStart, glyphsCompleted, fieldType);
+
+		std::vector<KerningPair> kerningPairs;
+		FontUtil::GetLayoutMetrics(fontFile, glyphRangeStart, glyphRangeEnd, m_LineHeight, kerningPairs);
+		m_Kerning.clear();
+		for (const KerningPair& pair : kerningPairs)
+		{
+			m_Kerning[((uint64)pair.Left << 32) | pair.Right] = pair.Amount;
+		}
+
+		CPath metricsPath = GetMetricsPath(outputFile);
+		if (WriteMetrics(metricsPath))
+		{
+			m_MetricsPath = metricsPath;
+		}
+	}
+
+	bool Font::WriteMetrics(const CPath& metricsFile) const
+	{
+		FontMetricsHeader header;
+		header.Magic = m_MetricsMagic;
+		header.Version = m_MetricsVersion;
+		header.GlyphRangeStart = m_GlyphRangeStart;
+		header.GlyphRangeEnd = m_GlyphRangeEnd;
+		header.CharacterMapSize = m_CharacterMapSize;
+		header.CharInfoSize = sizeof(CharInfo);
+
+		std::ofstream outStream(metricsFile.Path.c_str(), std::ios::binary);
+		if (!outStream)
+		{
+			Log::Warning("Could not write font metrics file '%s'.", metricsFile.Path.c_str());
+			return false;
+		}
+
+		FontLayoutHeader layoutHeader;
+		layoutHeader.LineHeight = m_LineHeight;
+		layoutHeader.NumKerningPairs = (int32)m_Kerning.size();
+
+		outStream.write((const char*)&header, sizeof(FontMetricsHeader));
+		outStream.write((const char*)m_CharacterMap, sizeof(CharInfo) * m_CharacterMapSize);
+		outStream.write((const char*)&layoutHeader, sizeof(FontLayoutHeader));
+		for (const auto& kerning : m_Kerning)
+		{
+			KerningPair pair = { (uint32)(kerning.first >> 32), (uint32)kerning.first, kerning.second };
+			outStream.write((const char*)&pair, sizeof(KerningPair));
+		}
+		return outStream.good();
+	}
+
+	bool Font::ReadMetrics(const CPath& metricsFile)
+	{
+		FileHandle* file = File::OpenFile(metricsFile);
+		if (file->m_Data == nullptr || file->m_Size < sizeof(FontMetricsHeader))
+		{
+			Log::Warning("Could not read font metrics file '%s'.", metricsFile.Path.c_str());
+			File::CloseFile(file);
+			return false;
+		}
+
+		FontMetricsHeader header;
+		memcpy(&header, file->m_Data, sizeof(FontMetricsHeader));
+		// Version 1 files only have the character map, they just don't get any kerning. The sizes come from the file, so
+		// check them against the file size before multiplying anything
+		bool validHeader = header.Magic == m_MetricsMagic && (header.Version == 1 || header.Version == m_MetricsVersion) &&
+			header.CharInfoSize == sizeof(CharInfo) && header.CharacterMapSize >= 0 &&
+			(uint32)header.CharacterMapSize <= (file->m_Size - sizeof(FontMetricsHeader)) / sizeof(CharInfo);
+		uint32 characterMapEnd = validHeader ? (uint32)(sizeof(FontMetricsHeader) + sizeof(CharInfo) * header.CharacterMapSize) : 0;
+
+		FontLayoutHeader layoutHeader = { m_LineHeight, 0 };
+		if (validHeader && header.Version >= 2)
+		{
+			validHeader = file->m_Size >= characterMapEnd + sizeof(FontLayoutHeader);
+			if (validHeader)
+			{
+				memcpy(&layoutHeader, file->m_Data + characterMapEnd, sizeof(FontLayoutHeader));
+				validHeader = layoutHeader.NumKerningPairs >= 0 &&
+					(uint32)layoutHeader.NumKerningPairs <= (file->m_Size - characterMapEnd - sizeof(FontLayoutHeader)) / sizeof(KerningPair) &&
+					file->m_Size == characterMapEnd + sizeof(FontLayoutHeader) + sizeof(KerningPair) * layoutHeader.NumKerningPairs;
+			}
+		}
+		else if (validHeader)
+		{
+			validHeader = file->m_Size == characterMapEnd;
+		}
+
+		if (!validHeader)
+		{
+			Log::Warning("Font metrics file '%s' is corrupt or was written by an incompatible version.", metricsFile.Path.c_str());
+			File::CloseFile(file);
+			return false;
+		}
+
+		m_GlyphRangeStart = header.GlyphRangeStart;
+		m_GlyphRangeEnd = header.GlyphRangeEnd;
+		m_CharacterMapSize = header.CharacterMapSize;
+		m_CharacterMap = (CharInfo*)AllocMem(sizeof(CharInfo) * m_CharacterMapSize);
+		memcpy(m_CharacterMap, file->m_Data + sizeof(FontMetricsHeader), sizeof(CharInfo) * m_CharacterMapSize);
+
+		m_LineHeight = layoutHeader.LineHeight;
+		m_Kerning.clear();
+		const KerningPair* kerningPairs = (const KerningPair*)(file->m_Data + characterMapEnd + sizeof(FontLayoutHeader));
+		for (int i = 0; i < layoutHeader.NumKerningPairs; i++)
+		{
+			m_Kerning[((uint64)kerningPairs[i].Left << 32) | kerningPairs[i].Right] = kerningPairs[i].Amount;
+		}
+		m_MetricsPath = metricsFile;
+
+		File::CloseFile(file);
+		return true;
+	}
+
+	CPath Font::GetMetricsPath(const CPath& fontTextureFile)
+	{
+		return NCPath::CreatePath(fontTextureFile.Path.substr(0, fontTextureFile.FileExtOffset) + m_MetricsExtension);
 	}
 
 	json Font::Serialize() const
 	{
 		json res;
 		res["CharacterMapSize"] = m_CharacterMapSize;
-		for (int i = 0; i < m_CharacterMapSize; i++)
+		if (!m_MetricsPath.Path.empty())
+		{
+			res["MetricsFilepath"] = m_MetricsPath.Path.c_str();
+		}
+		else
+		{
+			// The metrics file couldn't be written, so keep the glyphs in the scene instead of losing them
+			SerializeLegacyCharacterMap(*this, res);
+		}
+
+		res["FontTextureId"] = m_FontTexture.m_AssetId;
+		res["GlyphRangeStart"] = m_GlyphRangeStart;
+		res["GlyphRangeEnd"] = m_GlyphRangeEnd;
+		res["FontSize"] = m_FontSize;
+		res["Padding"] = m_Padding;
+		res["UpscaleResolution"] = m_UpscaleResolution;
+		res["FieldType"] = (int)m_FieldType;
+		res["Filepath"] = m_Path.Path.c_str();
+		return res;
+	}
+
+	void Font::Deserialize(const json& j)
+	{
+		JsonExtended::AssignIfNotNull(j, "FontTextureId", m_FontTexture.m_AssetId);
+		JsonExtended::AssignIfNotNull(j, "GlyphRangeStart", m_GlyphRangeStart);
+		JsonExtended::AssignIfNotNull(j, "GlyphRangeEnd", m_GlyphRangeEnd);
+		JsonExtended::AssignIfNotNull(j, "FontSize", m_FontSize);
+		JsonExtended::AssignIfNotNull(j, "Padding", m_Padding);
+		JsonExtended::AssignIfNotNull(j, "UpscaleResolution", m_UpscaleResolution);
+		int fieldType = (int)m_FieldType;
+		JsonExtended::AssignIfNotNull(j, "FieldType", fieldType);
+		m_FieldType = (DistanceFieldType)fieldType;
+		JsonExtended::AssignIfNotNull(j, "Filepath", m_Path);
+
+		CPath metricsPath = NCPath::CreatePath();
+		JsonExtended::AssignIfNotNull(j, "MetricsFilepath", metricsPath);
+		if (!metricsPath.Path.empty() && ReadMetrics(metricsPath))
 		{
-			const CharInfo& charInfo = m_CharacterMap[i];
-			res["CharacterMap"][std::to_string(i)] = {
+			return;
+		}
+
+		DeserializeLegacyCharacterMap(*this, j);
+		if (!j.contains("CharacterMap"))
+		{
+			return;
+		}
+
+		// Fonts from older scenes don't have a metrics file yet. Write it once here, so the next save of the scene
+		// can point to it
+		metricsPath = GetMetricsPath(AssetManager::GetTexturePath(m_FontTexture.m_AssetId));
+		if (!metricsPath.Path.empty() && !File::IsFile(metricsPath) && WriteMetrics(metricsPath))
+		{
+			m_MetricsPath = metricsPath;
+		}
+	}
+
+	// Scenes saved before the metrics file existed store every glyph in the json
+	static void SerializeLegacyCharacterMap(const Font& font, json& j)
+	{
+		for (int i = 0; i < font.m_CharacterMapSize; i++)
+		{
+			const CharInfo& charInfo = font.m_CharacterMap[i];
+			j["CharacterMap"][std::to_string(i)] = {
 				{"ux0", charInfo.ux0},
 				{"uy0", charInfo.uy0},
 				{"ux1", charInfo.ux1},
@@ -69,47 +286,30 @@ namespace Cocoa
 				{"chScaleY", charInfo.chScaleY}
 			};
 		}
-
-		res["FontTextureId"] = m_FontTexture.m_AssetId;
-		res["GlyphRangeStart"] = m_GlyphRangeStart;
-		res["GlyphRangeEnd"] = m_GlyphRangeEnd;
-		res["Filepath"] = m_Path.Path.c_str();
-		return res;
 	}
 
-	void Font::Deserialize(const json& j)
+	static void DeserializeLegacyCharacterMap(Font& font, const json& j)
 	{
-		JsonExtended::AssignIfNotNull(j, "CharacterMapSize", m_CharacterMapSize);
+		JsonExtended::AssignIfNotNull(j, "CharacterMapSize", font.m_CharacterMapSize);
 
-		m_CharacterMap = (CharInfo*)AllocMem(sizeof(CharInfo) * m_CharacterMapSize);
-		for (int i = 0; i < m_CharacterMapSize; i++)
+		font.m_CharacterMap = (CharInfo*)AllocMem(sizeof(CharInfo) * font.m_CharacterMapSize);
+		for (int i = 0; i < font.m_CharacterMapSize; i++)
 		{
-			float ux0, uy0, ux1, uy1, advance, bearingX, bearingY, chScaleX, chScaleY;
+			font.m_CharacterMap[i] = Font::nullCharacter;
 			if (j.contains("CharacterMap") && j["CharacterMap"].contains(std::to_string(i)))
 			{
-				json subJ = j["CharacterMap"][std::to_string(i)];
-				JsonExtended::AssignIfNotNull(subJ, "ux0", ux0);
-				JsonExtended::AssignIfNotNull(subJ, "uy0", uy0);
-				JsonExtended::AssignIfNotNull(subJ, "ux1", ux1);
-				JsonExtended::AssignIfNotNull(subJ, "uy1", uy1);
-				JsonExtended::AssignIfNotNull(subJ, "advance", advance);
-				JsonExtended::AssignIfNotNull(subJ, "bearingX", bearingX);
-				JsonExtended::AssignIfNotNull(subJ, "bearingY", bearingY);
-				JsonExtended::AssignIfNotNull(subJ, "chScaleX", chScaleX);
-				JsonExtended::AssignIfNotNull(subJ, "chScaleY", chScaleY);
-				m_CharacterMap[i] = {
-					ux0, uy0,
-					ux1, uy1,
-					advance,
-					bearingX, bearingY,
-					chScaleX, chScaleY
-				};
+				const json& subJ = j["CharacterMap"][std::to_string(i)];
+				CharInfo& charInfo = font.m_CharacterMap[i];
+				JsonExtended::AssignIfNotNull(subJ, "ux0", charInfo.ux0);
+				JsonExtended::AssignIfNotNull(subJ, "uy0", charInfo.uy0);
+				JsonExtended::AssignIfNotNull(subJ, "ux1", charInfo.ux1);
+				JsonExtended::AssignIfNotNull(subJ, "uy1", charInfo.uy1);
+				JsonExtended::AssignIfNotNull(subJ, "advance", charInfo.advance);
+				JsonExtended::AssignIfNotNull(subJ, "bearingX", charInfo.bearingX);
+				JsonExtended::AssignIfNotNull(subJ, "bearingY", charInfo.bearingY);
+				JsonExtended::AssignIfNotNull(subJ, "chScaleX", charInfo.chScaleX);
+				JsonExtended::AssignIfNotNull(subJ, "chScaleY", charInfo.chScaleY);
 			}
 		}
-
-		JsonExtended::AssignIfNotNull(j, "FontTextureId", m_FontTexture.m_AssetId);
-		JsonExtended::AssignIfNotNull(j, "GlyphRangeStart", m_GlyphRangeStart);
-		JsonExtended::AssignIfNotNull(j, "GlyphRangeEnd", m_GlyphRangeEnd);
-		JsonExtended::AssignIfNotNull(j, "Filepath", m_Path);
 	}
 }
\ No newline at end of file
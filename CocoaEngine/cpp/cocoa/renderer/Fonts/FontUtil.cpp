@@ -2,11 +2,14 @@
 #include "cocoa/util/CMath.h"
 #include "cocoa/util/Log.h"
 #include "cocoa/core/Memory.h"
+#include "cocoa/core/JobSystem.h"
+#include "cocoa/renderer/Fonts/Font.h"
 
 #include "stb/stb_image_write.h"
+#include FT_OUTLINE_H
+#include FT_TRUETYPE_TABLES_H
+#include FT_TRUETYPE_TAGS_H
 
-// TODO: CONSIDER WRITING MY OWN THREAD LIBRARY?
-#include <thread>
 
 namespace Cocoa
 {
@@ -49,6 +52,182 @@ namespace Cocoa
 			return (output + 1) * 0.5f;
 		}
 
+		// Internal Variables
+		static const float m_DistanceInfinity = 1e20f;
+
+		// Msdf edge colors, every bit is one channel of the output
+		static const int m_MsdfBlack = 0;
+		static const int m_MsdfRed = 1;
+		static const int m_MsdfGreen = 2;
+		static const int m_MsdfYellow = 3;
+		static const int m_MsdfBlue = 4;
+		static const int m_MsdfMagenta = 5;
+		static const int m_MsdfCyan = 6;
+		static const int m_MsdfWhite = 7;
+
+		// Curves are flattened into this many segments before measuring distances
+		static const int m_MsdfCurveSegments = 8;
+		// sin(3 radians), edges that meet at a sharper angle than this count as a corner
+		static const float m_MsdfCornerThreshold = 0.1411f;
+		static const float m_MsdfDistanceEpsilon = 0.001f;
+
+		// Empty texels left between glyphs in the atlas so linear filtering never picks up a neighbouring glyph
+		static const int m_GlyphSpacing = 1;
+
+		static bool IsInside(int x, int y, const uint8* bitmap, int width, int height)
+		{
+			return (x < width) && (y < height) && (x >= 0) && (y >= 0) && bitmap[x + (y * width)] > 127;
+		}
+
+		// Felzenszwalb-Huttenlocher lower envelope of parabolas. Turns the squared distances in f into the exact
+		// squared euclidean distance along this line for every index in O(n). v and z are scratch space of n and n + 1 elements
+		static void DistanceTransform1D(const float* f, float* d, int* v, float* z, int n)
+		{
+			int k = 0;
+			v[0] = 0;
+			z[0] = -m_DistanceInfinity;
+			z[1] = m_DistanceInfinity;
+			for (int q = 1; q < n; q++)
+			{
+				// The bounds are far enough out that this always stops at k == 0
+				double s = (((double)f[q] + (double)q * q) - ((double)f[v[k]] + (double)v[k] * v[k])) / (2.0 * q - 2.0 * v[k]);
+				while (s <= z[k])
+				{
+					k--;
+					s = (((double)f[q] + (double)q * q) - ((double)f[v[k]] + (double)v[k] * v[k])) / (2.0 * q - 2.0 * v[k]);
+				}
+
+				k++;
+				v[k] = q;
+				z[k] = (float)s;
+				z[k + 1] = m_DistanceInfinity;
+			}
+
+			k = 0;
+			for (int q = 0; q < n; q++)
+			{
+				while (z[k + 1] < q)
+				{
+					k++;
+				}
+				float dq = (float)(q - v[k]);
+				d[q] = dq * dq + f[v[k]];
+			}
+		}
+
+		// Computes the same values FindNearestPixel would return at every (sampleX[i], sampleY[j]), but with an exact separable distance
+		// transform over the whole glyph instead of scanning a window around each sample. Only the sampled rows and columns are ever
+		// resolved, so the cost is linear in the size of the upscaled bitmap
+		static void SampleSignedDistanceField(const uint8* bitmap, int width, int height, int spread,
+			const int* sampleX, int numSamplesX, const int* sampleY, int numSamplesY, float* output)
+		{
+			// The domain has to contain the whole glyph, every sample, and a ring of outside pixels around the glyph so
+			// that the nearest inside and nearest outside pixel of every sample is part of it
+			int minX = -1, maxX = width;
+			int minY = -1, maxY = height;
+			for (int i = 0; i < numSamplesX; i++)
+			{
+				minX = CMath::Min(minX, sampleX[i]);
+				maxX = CMath::Max(maxX, sampleX[i]);
+			}
+			for (int j = 0; j < numSamplesY; j++)
+			{
+				minY = CMath::Min(minY, sampleY[j]);
+				maxY = CMath::Max(maxY, sampleY[j]);
+			}
+			int domainWidth = maxX - minX + 1;
+			int domainHeight = maxY - minY + 1;
+			int maxLength = CMath::Max(domainWidth, domainHeight);
+
+			// Glyphs get generated on the job workers, the scratch stack keeps these off the shared heap
+			ScratchScope scratch;
+			float* columnDistance = scratch.Alloc<float>(domainHeight);
+			float* rows = scratch.Alloc<float>(domainWidth * numSamplesY);
+			float* rowDistance = scratch.Alloc<float>(domainWidth);
+			int* envelopeIndices = scratch.Alloc<int>(maxLength);
+			float* envelopeBounds = scratch.Alloc<float>(maxLength + 1);
+			float* distanceToInside = scratch.Alloc<float>(numSamplesX * numSamplesY);
+			float* distanceToOutside = scratch.Alloc<float>(numSamplesX * numSamplesY);
+
+			for (int pass = 0; pass < 2; pass++)
+			{
+				bool featureIsInside = pass == 0;
+				float* distances = featureIsInside ? distanceToInside : distanceToOutside;
+
+				// Vertical pass: squared distance to the nearest feature pixel in the same column, kept for the sampled rows only
+				for (int x = minX; x <= maxX; x++)
+				{
+					float lastFeature = -m_DistanceInfinity;
+					for (int y = minY; y <= maxY; y++)
+					{
+						if (IsInside(x, y, bitmap, width, height) == featureIsInside)
+						{
+							lastFeature = (float)y;
+						}
+						columnDistance[y - minY] = (float)y - lastFeature;
+					}
+					lastFeature = m_DistanceInfinity;
+					for (int y = maxY; y >= minY; y--)
+					{
+						if (IsInside(x, y, bitmap, width, height) == featureIsInside)
+						{
+							lastFeature = (float)y;
+						}
+						columnDistance[y - minY] = std::min(columnDistance[y - minY], lastFeature - (float)y);
+					}
+
+					for (int j = 0; j < numSamplesY; j++)
+					{
+						float distance = columnDistance[sampleY[j] - minY];
+						rows[(x - minX) + j * domainWidth] = distance >= m_DistanceInfinity ? m_DistanceInfinity : distance * distance;
+					}
+				}
+
+				// Horizontal pass: combine the column distances into exact euclidean distances for every sampled row
+				for (int j = 0; j < numSamplesY; j++)
+				{
+					DistanceTransform1D(&rows[j * domainWidth], rowDistance, envelopeIndices, envelopeBounds, domainWidth);
+					for (int i = 0; i < numSamplesX; i++)
+					{
+						distances[i + j * numSamplesX] = rowDistance[sampleX[i] - minX];
+					}
+				}
+			}
+
+			float maxDistanceSquared = (float)(spread * spread);
+			for (int j = 0; j < numSamplesY; j++)
+			{
+				for (int i = 0; i < numSamplesX; i++)
+				{
+					bool inside = IsInside(sampleX[i], sampleY[j], bitmap, width, height);
+					float distanceSquared = inside ? distanceToOutside[i + j * numSamplesX] : distanceToInside[i + j * numSamplesX];
+					distanceSquared = std::min(distanceSquared, maxDistanceSquared);
+
+					// Same mapping as FindNearestPixel so fonts generated either way look the same
+					int minDistance = (int)sqrt(distanceSquared);
+					float value = (minDistance - 0.5f) / (spread - 0.5f);
+					value *= inside ? 1 : -1;
+					output[i + j * numSamplesX] = (value + 1) * 0.5f;
+				}
+			}
+		}
+
+		static SdfBitmapContainer CreateGlyphContainer(int codepoint, FT_Face font, int bitmapWidth, int bitmapHeight, int padding, unsigned char* bitmap)
+		{
+			FT_Set_Pixel_Sizes(font, 0, 64);
+			FT_Load_Char(font, codepoint, FT_LOAD_RENDER);
+			return {
+				bitmapWidth, bitmapHeight,
+				padding, padding,
+				(float)(font->glyph->metrics.horiAdvance >> 6) / 64.0f,
+				(float)(font->glyph->metrics.horiBearingX >> 6) / (float)64.0f,
+				(float)(font->glyph->metrics.horiBearingY >> 6) / (float)64.0f,
+				(float)(font->glyph->metrics.width >> 6) / (float)64.0f,
+				(float)(font->glyph->metrics.height >> 6) / (float)64.0f,
+				bitmap
+			};
+		}
+
 		SdfBitmapContainer GenerateSdfCodepointBitmap(int codepoint, FT_Face font, int fontSize, int padding, int upscaleResolution, bool flipVertically)
 		{
 			int spread = upscaleResolution / 2;
@@ -78,39 +257,675 @@ namespace Cocoa
 			unsigned char* sdfBitmap = (unsigned char*)AllocMem(sizeof(unsigned char) * bitmapHeight * bitmapWidth);
 			Log::Assert(sdfBitmap != nullptr, "Ran out of memory. Could not allocate memory to generate a font.");
 
-			for (int y = -padding; y < bitmapHeight - padding; y++)
+			if (characterWidth <= 0 || characterHeight <= 0)
 			{
+				// Glyphs without any visible pixels (like spaces) are entirely outside the shape
+				memset(sdfBitmap, 0, sizeof(unsigned char) * bitmapHeight * bitmapWidth);
+			}
+			else
+			{
+				// Sample positions in the upscaled glyph bitmap for every pixel of the sdf bitmap
+				ScratchScope scratch;
+				int* sampleX = scratch.Alloc<int>(bitmapWidth);
+				int* sampleY = scratch.Alloc<int>(bitmapHeight);
 				for (int x = -padding; x < bitmapWidth - padding; x++)
 				{
-					int pixelX = (int)CMath::MapRange((float)x, -(float)padding, (float)(characterWidth + padding), -padding * scaleX, (characterWidth + padding) * scaleX);
-					int pixelY = (int)CMath::MapRange((float)(characterHeight - y), -(float)padding, (float)(characterHeight + padding), -padding * scaleY, (characterHeight + padding) * scaleY);
-					float val = FindNearestPixel(pixelX, pixelY, img, width, height, spread);
-					if (!flipVertically)
+					sampleX[x + padding] = (int)CMath::MapRange((float)x, -(float)padding, (float)(characterWidth + padding), -padding * scaleX, (characterWidth + padding) * scaleX);
+				}
+				for (int y = -padding; y < bitmapHeight - padding; y++)
+				{
+					sampleY[y + padding] = (int)CMath::MapRange((float)(characterHeight - y), -(float)padding, (float)(characterHeight + padding), -padding * scaleY, (characterHeight + padding) * scaleY);
+				}
+
+				float* sdfValues = scratch.Alloc<float>(bitmapWidth * bitmapHeight);
+				SampleSignedDistanceField(img, width, height, spread, sampleX, bitmapWidth, sampleY, bitmapHeight, sdfValues);
+
+				for (int y = 0; y < bitmapHeight; y++)
+				{
+					for (int x = 0; x < bitmapWidth; x++)
+					{
+						float val = sdfValues[x + y * bitmapWidth];
+						if (!flipVertically)
+						{
+							sdfBitmap[x + (y * bitmapWidth)] = (int)(val * 255.0f);
+						}
+						else
+						{
+							sdfBitmap[x + ((bitmapHeight - y - 1) * bitmapWidth)] = (int)(val * 255.0f);
+						}
+					}
+				}
+			}
+
+			return CreateGlyphContainer(codepoint, font, bitmapWidth, bitmapHeight, padding, sdfBitmap);
+		}
+
+		struct MsdfSegment
+		{
+			glm::vec2 Start;
+			glm::vec2 End;
+			int Edge;
+		};
+
+		// An edge is one line or curve of the outline. Curves are flattened into several segments
+		struct MsdfEdge
+		{
+			glm::vec2 StartDirection;
+			glm::vec2 EndDirection;
+			int FirstSegment;
+			int NumSegments;
+			int Color;
+		};
+
+		struct MsdfContour
+		{
+			int FirstEdge;
+			int NumEdges;
+		};
+
+		struct MsdfShape
+		{
+			std::vector<MsdfSegment> Segments;
+			std::vector<MsdfEdge> Edges;
+			std::vector<MsdfContour> Contours;
+			glm::vec2 Cursor;
+		};
+
+		static glm::vec2 ToVec2(const FT_Vector* vector)
+		{
+			return glm::vec2((float)vector->x / 64.0f, (float)vector->y / 64.0f);
+		}
+
+		static void AddMsdfEdge(MsdfShape& shape, const glm::vec2* points, int numPoints, const glm::vec2& startDirection, const glm::vec2& endDirection)
+		{
+			MsdfEdge edge;
+			edge.StartDirection = startDirection;
+			edge.EndDirection = endDirection;
+			edge.FirstSegment = (int)shape.Segments.size();
+			edge.NumSegments = numPoints - 1;
+			edge.Color = m_MsdfWhite;
+			for (int i = 0; i < numPoints - 1; i++)
+			{
+				shape.Segments.push_back({ points[i], points[i + 1], (int)shape.Edges.size() });
+			}
+			shape.Edges.push_back(edge);
+			shape.Contours.back().NumEdges++;
+			shape.Cursor = points[numPoints - 1];
+		}
+
+		static int MsdfMoveTo(const FT_Vector* to, void* user)
+		{
+			MsdfShape& shape = *(MsdfShape*)user;
+			shape.Contours.push_back({ (int)shape.Edges.size(), 0 });
+			shape.Cursor = ToVec2(to);
+			return 0;
+		}
+
+		static int MsdfLineTo(const FT_Vector* to, void* user)
+		{
+			MsdfShape& shape = *(MsdfShape*)user;
+			glm::vec2 points[2] = { shape.Cursor, ToVec2(to) };
+			if (points[0] != points[1])
+			{
+				glm::vec2 direction = points[1] - points[0];
+				AddMsdfEdge(shape, points, 2, direction, direction);
+			}
+			return 0;
+		}
+
+		static int MsdfConicTo(const FT_Vector* control, const FT_Vector* to, void* user)
+		{
+			MsdfShape& shape = *(MsdfShape*)user;
+			glm::vec2 p0 = shape.Cursor;
+			glm::vec2 p1 = ToVec2(control);
+			glm::vec2 p2 = ToVec2(to);
+			if (p0 == p2 && p0 == p1)
+			{
+				return 0;
+			}
+
+			glm::vec2 points[m_MsdfCurveSegments + 1];
+			for (int i = 0; i <= m_MsdfCurveSegments; i++)
+			{
+				float t = (float)i / (float)m_MsdfCurveSegments;
+				float mt = 1.0f - t;
+				points[i] = mt * mt * p0 + 2.0f * mt * t * p1 + t * t * p2;
+			}
+			glm::vec2 startDirection = p1 != p0 ? p1 - p0 : p2 - p0;
+			glm::vec2 endDirection = p2 != p1 ? p2 - p1 : p2 - p0;
+			AddMsdfEdge(shape, points, m_MsdfCurveSegments + 1, startDirection, endDirection);
+			return 0;
+		}
+
+		static int MsdfCubicTo(const FT_Vector* control1, const FT_Vector* control2, const FT_Vector* to, void* user)
+		{
+			MsdfShape& shape = *(MsdfShape*)user;
+			glm::vec2 p0 = shape.Cursor;
+			glm::vec2 p1 = ToVec2(control1);
+			glm::vec2 p2 = ToVec2(control2);
+			glm::vec2 p3 = ToVec2(to);
+			if (p0 == p3 && p0 == p1 && p0 == p2)
+			{
+				return 0;
+			}
+
+			glm::vec2 points[m_MsdfCurveSegments + 1];
+			for (int i = 0; i <= m_MsdfCurveSegments; i++)
+			{
+				float t = (float)i / (float)m_MsdfCurveSegments;
+				float mt = 1.0f - t;
+				points[i] = mt * mt * mt * p0 + 3.0f * mt * mt * t * p1 + 3.0f * mt * t * t * p2 + t * t * t * p3;
+			}
+			glm::vec2 startDirection = p1 != p0 ? p1 - p0 : (p2 != p0 ? p2 - p0 : p3 - p0);
+			glm::vec2 endDirection = p3 != p2 ? p3 - p2 : (p3 != p1 ? p3 - p1 : p3 - p0);
+			AddMsdfEdge(shape, points, m_MsdfCurveSegments + 1, startDirection, endDirection);
+			return 0;
+		}
+
+		static bool IsCorner(glm::vec2 incoming, glm::vec2 outgoing)
+		{
+			incoming = glm::normalize(incoming);
+			outgoing = glm::normalize(outgoing);
+			float cross = incoming.x * outgoing.y - incoming.y * outgoing.x;
+			return glm::dot(incoming, outgoing) <= 0.0f || fabs(cross) > m_MsdfCornerThreshold;
+		}
+
+		// Moves to another two channel color, sharing exactly one channel with the current color unless banned says otherwise
+		static void SwitchColor(int& color, uint64& seed, int banned = m_MsdfBlack)
+		{
+			int combined = color & banned;
+			if (combined == m_MsdfRed || combined == m_MsdfGreen || combined == m_MsdfBlue)
+			{
+				color = combined ^ m_MsdfWhite;
+				return;
+			}
+
+			if (color == m_MsdfBlack || color == m_MsdfWhite)
+			{
+				static const int startColors[3] = { m_MsdfCyan, m_MsdfMagenta, m_MsdfYellow };
+				color = startColors[seed % 3];
+				seed /= 3;
+				return;
+			}
+
+			int shifted = color << (1 + (seed & 1));
+			color = (shifted | shifted >> 3) & m_MsdfWhite;
+			seed >>= 1;
+		}
+
+		// Splits 0..n-1 into three roughly equal parts, returning -1, 0 or 1
+		static int SymmetricalTrichotomy(int position, int n)
+		{
+			return (int)(3 + 2.875f * position / (n - 1) - 1.4375f + 0.5f) - 3;
+		}
+
+		// Gives every edge a color so that the two edges meeting at a corner only share one channel. Each channel on its own
+		// then rounds off the corner in a different direction, and the median of the three reconstructs the sharp corner
+		static void ColorEdges(MsdfShape& shape)
+		{
+			uint64 seed = 0;
+			std::vector<int> corners;
+			for (const MsdfContour& contour : shape.Contours)
+			{
+				corners.clear();
+				for (int i = 0; i < contour.NumEdges; i++)
+				{
+					const MsdfEdge& previous = shape.Edges[contour.FirstEdge + (i + contour.NumEdges - 1) % contour.NumEdges];
+					const MsdfEdge& edge = shape.Edges[contour.FirstEdge + i];
+					if (IsCorner(previous.EndDirection, edge.StartDirection))
+					{
+						corners.push_back(i);
+					}
+				}
+
+				if (corners.empty())
+				{
+					// Smooth contours don't need any corners preserved
+					continue;
+				}
+
+				if (corners.size() == 1)
+				{
+					// Teardrop, split the contour into three colors so the single corner still has two colors meeting at it
+					int colors[3] = { m_MsdfWhite, m_MsdfWhite, m_MsdfWhite };
+					SwitchColor(colors[0], seed);
+					colors[2] = colors[0];
+					SwitchColor(colors[2], seed);
+
+					int corner = corners[0];
+					for (int i = 0; i < contour.NumEdges; i++)
+					{
+						int color = contour.NumEdges >= 3
+							? colors[1 + SymmetricalTrichotomy(i, contour.NumEdges)]
+							: colors[i == 0 ? 0 : 2];
+						shape.Edges[contour.FirstEdge + (corner + i) % contour.NumEdges].Color = color;
+					}
+					continue;
+				}
+
+				int numCorners = (int)corners.size();
+				int start = corners[0];
+				int spline = 0;
+				int color = m_MsdfWhite;
+				SwitchColor(color, seed);
+				int initialColor = color;
+				for (int i = 0; i < contour.NumEdges; i++)
+				{
+					int index = (start + i) % contour.NumEdges;
+					if (spline + 1 < numCorners && corners[spline + 1] == index)
+					{
+						spline++;
+						// The last spline must differ from the first one too, they meet at the first corner
+						SwitchColor(color, seed, spline == numCorners - 1 ? initialColor : m_MsdfBlack);
+					}
+					shape.Edges[contour.FirstEdge + index].Color = color;
+				}
+			}
+		}
+
+		struct MsdfChannelDistance
+		{
+			float Distance;
+			float Orthogonality;
+			int Segment;
+		};
+
+		// Signed distance to the segment, but past the ends of an edge the distance to the edge's extended tangent line is
+		// used instead. That's what lets the channels meet in a sharp corner instead of a rounded one
+		static float PseudoDistance(const MsdfShape& shape, int segmentIndex, const glm::vec2& point)
+		{
+			const MsdfSegment& segment = shape.Segments[segmentIndex];
+			const MsdfEdge& edge = shape.Edges[segment.Edge];
+			glm::vec2 direction = segment.End - segment.Start;
+			glm::vec2 toPoint = point - segment.Start;
+			float length = glm::length(direction);
+			float t = glm::dot(toPoint, direction) / (length * length);
+			float cross = direction.x * toPoint.y - direction.y * toPoint.x;
+			float side = cross >= 0.0f ? 1.0f : -1.0f;
+
+			glm::vec2 closest = segment.Start + direction * std::min(std::max(t, 0.0f), 1.0f);
+			float distance = glm::length(point - closest) * side;
+
+			bool firstSegment = segmentIndex == edge.FirstSegment;
+			bool lastSegment = segmentIndex == edge.FirstSegment + edge.NumSegments - 1;
+			if ((t < 0.0f && firstSegment) || (t > 1.0f && lastSegment))
+			{
+				float lineDistance = cross / length;
+				if (fabs(lineDistance) <= fabs(distance))
+				{
+					distance = lineDistance;
+				}
+			}
+
+			return distance;
+		}
+
+		SdfBitmapContainer GenerateMsdfCodepointBitmap(int codepoint, FT_Face font, int fontSize, int padding, int upscaleResolution)
+		{
+			int spread = upscaleResolution / 2;
+
+			// The outline is loaded at the same size the single channel path renders at, so both produce the same layout
+			FT_Set_Pixel_Sizes(font, 0, upscaleResolution);
+			if (FT_Load_Char(font, codepoint, FT_LOAD_NO_BITMAP))
+			{
+				Log::Warning("Could not generate '%c'.\n", codepoint);
+				return {
+					0, 0, 0, 0, 0, 0, 0, 0, 0, nullptr
+				};
+			}
+
+			FT_Outline* outline = &font->glyph->outline;
+			FT_BBox box;
+			FT_Outline_Get_CBox(outline, &box);
+			int left = (int)floor(box.xMin / 64.0f);
+			int top = (int)ceil(box.yMax / 64.0f);
+			int width = (int)ceil(box.xMax / 64.0f) - left;
+			int height = top - (int)floor(box.yMin / 64.0f);
+
+			int characterWidth = (int)(fontSize * ((float)width / (float)upscaleResolution));
+			int characterHeight = (int)(fontSize * ((float)height / (float)upscaleResolution));
+			int bitmapWidth = characterWidth + padding * 2;
+			int bitmapHeight = characterHeight + padding * 2;
+			unsigned char* msdfBitmap = (unsigned char*)AllocMem(sizeof(unsigned char) * bitmapWidth * bitmapHeight * 3);
+			Log::Assert(msdfBitmap != nullptr, "Ran out of memory. Could not allocate memory to generate a font.");
+			memset(msdfBitmap, 0, sizeof(unsigned char) * bitmapWidth * bitmapHeight * 3);
+
+			MsdfShape shape;
+			if (characterWidth > 0 && characterHeight > 0 && outline->n_contours > 0)
+			{
+				FT_Outline_Funcs outlineFuncs;
+				outlineFuncs.move_to = MsdfMoveTo;
+				outlineFuncs.line_to = MsdfLineTo;
+				outlineFuncs.conic_to = MsdfConicTo;
+				outlineFuncs.cubic_to = MsdfCubicTo;
+				outlineFuncs.shift = 0;
+				outlineFuncs.delta = 0;
+				FT_Outline_Decompose(outline, &outlineFuncs, &shape);
+			}
+
+			if (!shape.Segments.empty())
+			{
+				ColorEdges(shape);
+
+				// Distances are positive inside the glyph. TrueType outlines wind clockwise, so their inside is on the right
+				float orientation = FT_Outline_Get_Orientation(outline) == FT_ORIENTATION_TRUETYPE ? -1.0f : 1.0f;
+				bool evenOddFill = (outline->flags & FT_OUTLINE_EVEN_ODD_FILL) != 0;
+				float scaleX = (float)width / (float)characterWidth;
+				float scaleY = (float)height / (float)characterHeight;
+
+				for (int y = 0; y < bitmapHeight; y++)
+				{
+					for (int x = 0; x < bitmapWidth; x++)
+					{
+						// Same sample positions as the single channel generator, the bitmap is stored bottom row first
+						glm::vec2 point = glm::vec2(
+							left + (x - padding) * scaleX + 0.5f,
+							top - (characterHeight - (y - padding)) * scaleY - 0.5f);
+
+						MsdfChannelDistance channels[3];
+						for (int c = 0; c < 3; c++)
+						{
+							channels[c] = { m_DistanceInfinity, 0.0f, -1 };
+						}
+						float trueDistance = m_DistanceInfinity;
+						int winding = 0;
+
+						for (int s = 0; s < shape.Segments.size(); s++)
+						{
+							const MsdfSegment& segment = shape.Segments[s];
+							glm::vec2 direction = segment.End - segment.Start;
+							glm::vec2 toPoint = point - segment.Start;
+							float t = glm::dot(toPoint, direction) / glm::dot(direction, direction);
+							glm::vec2 closest = segment.Start + direction * std::min(std::max(t, 0.0f), 1.0f);
+							float distance = glm::length(point - closest);
+							float cross = direction.x * toPoint.y - direction.y * toPoint.x;
+
+							// Nonzero winding decides what's really inside, used to clean up channel clashes below
+							if (segment.Start.y <= point.y && segment.End.y > point.y && cross > 0.0f)
+							{
+								winding++;
+							}
+							else if (segment.Start.y > point.y && segment.End.y <= point.y && cross < 0.0f)
+							{
+								winding--;
+							}
+
+							trueDistance = std::min(trueDistance, distance);
+
+							// When two segments are equally close, the one the point is more perpendicular to is the real owner
+							float orthogonality = distance > 0.0f ? fabs(cross) / (glm::length(direction) * distance) : 1.0f;
+							int color = shape.Edges[segment.Edge].Color;
+							for (int c = 0; c < 3; c++)
+							{
+								MsdfChannelDistance& channel = channels[c];
+								if ((color & (1 << c)) && (distance < channel.Distance - m_MsdfDistanceEpsilon ||
+									(distance < channel.Distance + m_MsdfDistanceEpsilon && orthogonality > channel.Orthogonality)))
+								{
+									channel = { distance, orthogonality, s };
+								}
+							}
+						}
+
+						bool inside = evenOddFill ? (winding & 1) != 0 : winding != 0;
+						float signedTrueDistance = inside ? trueDistance : -trueDistance;
+
+						float distances[3];
+						for (int c = 0; c < 3; c++)
+						{
+							distances[c] = channels[c].Segment != -1
+								? PseudoDistance(shape, channels[c].Segment, point) * orientation
+								: -m_DistanceInfinity;
+						}
+
+						// Where the median disagrees with the real inside test the channels clash, so fall back to the true distance
+						float median = std::max(std::min(distances[0], distances[1]), std::min(std::max(distances[0], distances[1]), distances[2]));
+						if ((median > 0.0f) != inside)
+						{
+							distances[0] = signedTrueDistance;
+							distances[1] = signedTrueDistance;
+							distances[2] = signedTrueDistance;
+						}
+
+						for (int c = 0; c < 3; c++)
+						{
+							float value = std::min(std::max(distances[c] / (float)spread, -1.0f), 1.0f);
+							msdfBitmap[(x + y * bitmapWidth) * 3 + c] = (unsigned char)((value + 1) * 0.5f * 255.0f);
+						}
+					}
+				}
+			}
+
+			return CreateGlyphContainer(codepoint, font, bitmapWidth, bitmapHeight, padding, msdfBitmap);
+		}
+
+		struct FreetypeWorkerContext
+		{
+			FT_Library Library;
+			FT_Face Face;
+			bool Initialized;
+			bool Valid;
+		};
+
+		static FT_Face GetWorkerFace(FreetypeWorkerContext& context, const char* fontFile)
+		{
+			// FreeType libraries and faces can't be shared between threads, so every worker loads its own face once
+			if (!context.Initialized)
+			{
+				context.Initialized = true;
+				context.Valid = false;
+				if (FT_Init_FreeType(&context.Library))
+				{
+					Log::Warning("Could not initialize freetype.\n");
+					return nullptr;
+				}
+
+				if (FT_New_Face(context.Library, fontFile, 0, &context.Face))
+				{
+					Log::Warning("Could not load font %s.\n", fontFile);
+					FT_Done_FreeType(context.Library);
+					return nullptr;
+				}
+				context.Valid = true;
+			}
+
+			return context.Valid ? context.Face : nullptr;
+		}
+
+		struct SkylineNode
+		{
+			int X;
+			int Y;
+			int Width;
+		};
+
+		static int NextPowerOfTwo(int value)
+		{
+			int result = 1;
+			while (result < value)
+			{
+				result *= 2;
+			}
+			return result;
+		}
+
+		// Returns the lowest y a rectangle of the given size can sit at when its left edge is at skyline[index], or -1 if it doesn't fit
+		static int SkylineFit(const std::vector<SkylineNode>& skyline, int index, int width, int height, int atlasWidth, int atlasHeight)
+		{
+			int x = skyline[index].X;
+			if (x + width > atlasWidth)
+			{
+				return -1;
+			}
+
+			int y = skyline[index].Y;
+			int widthLeft = width;
+			for (int i = index; widthLeft > 0; i++)
+			{
+				y = CMath::Max(y, skyline[i].Y);
+				if (y + height > atlasHeight)
+				{
+					return -1;
+				}
+				widthLeft -= skyline[i].Width;
+			}
+
+			return y;
+		}
+
+		// Bottom-left skyline packer. The skyline is the top edge of everything placed so far, every glyph goes wherever
+		// its top ends up lowest. Returns false if the glyphs don't fit in the atlas
+		static bool PackSkyline(const SdfBitmapContainer* glyphs, const std::vector<int>& packOrder, int atlasWidth, int atlasHeight, std::vector<glm::ivec2>& outPositions)
+		{
+			std::vector<SkylineNode> skyline;
+			skyline.push_back({ 0, 0, atlasWidth });
+
+			for (int glyphIndex : packOrder)
+			{
+				int width = glyphs[glyphIndex].width + m_GlyphSpacing;
+				int height = glyphs[glyphIndex].height + m_GlyphSpacing;
+
+				int bestIndex = -1;
+				int bestTop = atlasHeight + 1;
+				int bestNodeWidth = atlasWidth + 1;
+				for (int i = 0; i < skyline.size(); i++)
+				{
+					int y = SkylineFit(skyline, i, width, height, atlasWidth, atlasHeight);
+					if (y >= 0 && (y + height < bestTop || (y + height == bestTop && skyline[i].Width < bestNodeWidth)))
+					{
+						bestIndex = i;
+						bestTop = y + height;
+						bestNodeWidth = skyline[i].Width;
+					}
+				}
+
+				if (bestIndex == -1)
+				{
+					return false;
+				}
+
+				int x = skyline[bestIndex].X;
+				outPositions[glyphIndex] = glm::ivec2(x, bestTop - height);
+				skyline.insert(skyline.begin() + bestIndex, { x, bestTop, width });
+
+				// Cut away the parts of the following nodes that are now covered by the new node
+				for (int i = bestIndex + 1; i < skyline.size();)
+				{
+					const SkylineNode& previous = skyline[i - 1];
+					SkylineNode& node = skyline[i];
+					int overlap = previous.X + previous.Width - node.X;
+					if (overlap <= 0)
+					{
+						break;
+					}
+
+					node.X += overlap;
+					node.Width -= overlap;
+					if (node.Width > 0)
 					{
-						sdfBitmap[(x + padding) + ((y + padding) * bitmapWidth)] = (int)(val * 255.0f);
+						break;
+					}
+					skyline.erase(skyline.begin() + i);
+				}
+
+				for (int i = 0; i < (int)skyline.size() - 1;)
+				{
+					if (skyline[i].Y == skyline[i + 1].Y)
+					{
+						skyline[i].Width += skyline[i + 1].Width;
+						skyline.erase(skyline.begin() + i + 1);
 					}
 					else
 					{
-						sdfBitmap[(x + padding) + ((bitmapHeight - (y + padding) - 1) * bitmapWidth)] = (int)(val * 255.0f);
+						i++;
 					}
 				}
 			}
 
+			return true;
+		}
+
+		bool GetGlyphMetrics(int codepoint, FT_Face font, CharInfo& outCharInfo)
+		{
+			outCharInfo = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 			FT_Set_Pixel_Sizes(font, 0, 64);
-			FT_Load_Char(font, codepoint, FT_LOAD_RENDER);
-			return {
-				bitmapWidth, bitmapHeight,
-				padding, padding,
-				(float)(font->glyph->metrics.horiAdvance >> 6) / 64.0f,
-				(float)(font->glyph->metrics.horiBearingX >> 6) / (float)64.0f,
-				(float)(font->glyph->metrics.horiBearingY >> 6) / (float)64.0f,
-				(float)(font->glyph->metrics.width >> 6) / (float)64.0f,
-				(float)(font->glyph->metrics.height >> 6) / (float)64.0f,
-				sdfBitmap
-			};
+			if (FT_Load_Char(font, codepoint, FT_LOAD_DEFAULT))
+			{
+				return false;
+			}
+
+			outCharInfo.advance = (float)(font->glyph->metrics.horiAdvance >> 6) / 64.0f;
+			outCharInfo.bearingX = (float)(font->glyph->metrics.horiBearingX >> 6) / 64.0f;
+			outCharInfo.bearingY = (float)(font->glyph->metrics.horiBearingY >> 6) / 64.0f;
+			outCharInfo.chScaleX = (float)(font->glyph->metrics.width >> 6) / 64.0f;
+			outCharInfo.chScaleY = (float)(font->glyph->metrics.height >> 6) / 64.0f;
+			return true;
 		}
 
-		static void fillSdfBitmaps(int begin, int end, SdfBitmapContainer* arr, const char* fontFile, int fontSize, int padding, int upscaleResolution, int glyphOffset)
+		struct GlyphLess
+		{
+			bool operator()(const std::pair<FT_UInt, uint32>& a, FT_UInt b) const { return a.first < b; }
+			bool operator()(FT_UInt a, const std::pair<FT_UInt, uint32>& b) const { return a < b.first; }
+		};
+
+		static uint16 ReadUint16(const uint8* data)
+		{
+			return (uint16)((data[0] << 8) | data[1]);
+		}
+
+		// Collects the glyph pairs of every horizontal format 0 subtable in the font's 'kern' table, which is where
+		// FT_Get_Kerning reads its values from for TrueType and OpenType fonts. Returns false if there's no such table
+		static bool ReadKernTablePairs(FT_Face font, std::vector<std::pair<FT_UInt, FT_UInt>>& outPairs)
+		{
+			FT_ULong length = 0;
+			if (!FT_IS_SFNT(font) || FT_Load_Sfnt_Table(font, TTAG_kern, 0, nullptr, &length) || length < 4)
+			{
+				return false;
+			}
+
+			std::vector<uint8> table(length);
+			if (FT_Load_Sfnt_Table(font, TTAG_kern, 0, table.data(), &length))
+			{
+				return false;
+			}
+
+			// Apple's version 1 tables have a different header, freetype doesn't read kerning from those either
+			if (ReadUint16(&table[0]) != 0)
+			{
+				return false;
+			}
+
+			int numSubtables = ReadUint16(&table[2]);
+			FT_ULong offset = 4;
+			for (int subtable = 0; subtable < numSubtables && offset + 6 <= length; subtable++)
+			{
+				uint16 subtableLength = ReadUint16(&table[offset + 2]);
+				uint16 coverage = ReadUint16(&table[offset + 4]);
+				FT_ULong pairsStart = offset + 14;
+				bool horizontalFormat0 = (coverage >> 8) == 0 && (coverage & 0x1) != 0;
+				if (horizontalFormat0 && pairsStart <= length)
+				{
+					// The subtable length is only 16 bits, big tables overflow it, so trust the pair count instead
+					FT_ULong numPairs = std::min((FT_ULong)ReadUint16(&table[offset + 6]), (length - pairsStart) / 6);
+					for (FT_ULong pair = 0; pair < numPairs; pair++)
+					{
+						const uint8* entry = &table[pairsStart + pair * 6];
+						outPairs.push_back({ ReadUint16(entry), ReadUint16(entry + 2) });
+					}
+					offset = pairsStart + numPairs * 6;
+				}
+				else
+				{
+					offset += subtableLength > 6 ? subtableLength : 6;
+				}
+			}
+
+			// Freetype adds up the values of a pair that shows up in several subtables, so only ask for it once
+			std::sort(outPairs.begin(), outPairs.end());
+			outPairs.erase(std::unique(outPairs.begin(), outPairs.end()), outPairs.end());
+			return true;
+		}
+
+		void GetLayoutMetrics(const CPath& fontFile, int glyphRangeStart, int glyphRangeEnd, float& outLineHeight, std::vector<KerningPair>& outKerningPairs)
 		{
 			FT_Library ft;
 			if (FT_Init_FreeType(&ft))
@@ -120,22 +935,99 @@ namespace Cocoa
 			}
 
 			FT_Face font;
-			if (FT_New_Face(ft, fontFile, 0, &font))
+			if (FT_New_Face(ft, fontFile.Path.c_str(), 0, &font))
 			{
-				Log::Warning("Could not load font %s.\n", fontFile);
+				Log::Warning("Could not load font %s.\n", fontFile.Path.c_str());
+				FT_Done_FreeType(ft);
 				return;
 			}
 
-			for (int i = begin; i < end; i++)
+			// Glyph metrics are measured at 64 pixels and divided by 64, so do the same here
+			FT_Set_Pixel_Sizes(font, 0, 64);
+			outLineHeight = (float)(font->size->metrics.height >> 6) / 64.0f;
+
+			if (FT_HAS_KERNING(font))
 			{
-				arr[i] = GenerateSdfCodepointBitmap(i + glyphOffset, font, fontSize, padding, upscaleResolution);
+				int numGlyphs = glyphRangeEnd - glyphRangeStart;
+				std::vector<FT_UInt> glyphIndices(numGlyphs);
+				for (int i = 0; i < numGlyphs; i++)
+				{
+					glyphIndices[i] = FT_Get_Char_Index(font, glyphRangeStart + i);
+				}
+
+				std::vector<std::pair<FT_UInt, FT_UInt>> tablePairs;
+				if (ReadKernTablePairs(font, tablePairs))
+				{
+					// Only the pairs listed in the kern table can have a value, so look up just those instead of every
+					// combination of glyphs in the range. Several codepoints can share a glyph
+					std::vector<std::pair<FT_UInt, uint32>> codepointsByGlyph;
+					codepointsByGlyph.reserve(numGlyphs);
+					for (int i = 0; i < numGlyphs; i++)
+					{
+						if (glyphIndices[i] != 0)
+						{
+							codepointsByGlyph.push_back({ glyphIndices[i], (uint32)(glyphRangeStart + i) });
+						}
+					}
+					std::sort(codepointsByGlyph.begin(), codepointsByGlyph.end());
+
+					for (const auto& [leftGlyph, rightGlyph] : tablePairs)
+					{
+						auto lefts = std::equal_range(codepointsByGlyph.begin(), codepointsByGlyph.end(), leftGlyph, GlyphLess());
+						if (lefts.first == lefts.second)
+						{
+							continue;
+						}
+						auto rights = std::equal_range(codepointsByGlyph.begin(), codepointsByGlyph.end(), rightGlyph, GlyphLess());
+						if (rights.first == rights.second)
+						{
+							continue;
+						}
+
+						FT_Vector kerning;
+						if (FT_Get_Kerning(font, leftGlyph, rightGlyph, FT_KERNING_UNFITTED, &kerning) || kerning.x == 0)
+						{
+							continue;
+						}
+
+						for (auto left = lefts.first; left != lefts.second; left++)
+						{
+							for (auto right = rights.first; right != rights.second; right++)
+							{
+								outKerningPairs.push_back({ left->second, right->second, (float)kerning.x / 64.0f / 64.0f });
+							}
+						}
+					}
+				}
+				else
+				{
+					// Fonts without a kern table get their kerning from somewhere freetype doesn't let us enumerate, like an
+					// afm file, so every pair has to be asked for
+					for (int left = 0; left < numGlyphs; left++)
+					{
+						if (glyphIndices[left] == 0)
+						{
+							continue;
+						}
+
+						for (int right = 0; right < numGlyphs; right++)
+						{
+							FT_Vector kerning;
+							if (glyphIndices[right] != 0 && !FT_Get_Kerning(font, glyphIndices[left], glyphIndices[right], FT_KERNING_UNFITTED, &kerning) && kerning.x != 0)
+							{
+								outKerningPairs.push_back({ (uint32)(glyphRangeStart + left), (uint32)(glyphRangeStart + right), (float)kerning.x / 64.0f / 64.0f });
+							}
+						}
+					}
+				}
 			}
 
 			FT_Done_Face(font);
 			FT_Done_FreeType(ft);
 		}
 
-		void CreateSdfFontTexture(const CPath& fontFile, int fontSize, CharInfo* characterMap, int characterMapSize, const CPath& outputFile, int padding, int upscaleResolution, int glyphOffset)
+		void CreateSdfFontTexture(const CPath& fontFile, int fontSize, CharInfo* characterMap, int characterMapSize, const CPath& outputFile, int padding, int upscaleResolution, int glyphOffset,
+			std::atomic<int>* glyphsCompleted, DistanceFieldType fieldType)
 		{
 			FT_Library ft;
 			if (FT_Init_FreeType(&ft))
@@ -159,100 +1051,101 @@ namespace Cocoa
 				return;
 			}
 
-			// Estimate a "squarish" width for the font texture, and leave it at that
-			int emWidth = font->glyph->bitmap.width;
-			int squareLength = (int)sqrt(characterMapSize - glyphOffset) + 1;
-			int fixedWidth = squareLength * emWidth;
+			// The character map covers the codepoints [glyphOffset, glyphOffset + characterMapSize)
+			SdfBitmapContainer* sdfBitmaps = (SdfBitmapContainer*)AllocMem(sizeof(SdfBitmapContainer) * characterMapSize);
 
-			// Calculate the dimensions of the actual width and height of the font texture
-			// and save all the sdf metrics for each codepoint
-			int sdfHeight = 0;
-			int sdfWidth = 0;
-			int rowHeight = 0;
-			int x = 0;
-			int y = 0;
+			// Glyph costs vary a lot, so every glyph is its own task and idle workers pick up the next one
+			int numWorkerContexts = JobSystem::NumWorkers() + 1;
+			FreetypeWorkerContext* workerContexts = (FreetypeWorkerContext*)AllocMem(sizeof(FreetypeWorkerContext) * numWorkerContexts);
+			memset(workerContexts, 0, sizeof(FreetypeWorkerContext) * numWorkerContexts);
+			const char* fontFilepath = fontFile.Path.c_str();
+			JobSystem::ParallelFor(characterMapSize, [&](int glyphIndex, int workerIndex)
+				{
+					FT_Face workerFace = GetWorkerFace(workerContexts[workerIndex], fontFilepath);
+					if (workerFace == nullptr)
+					{
+						sdfBitmaps[glyphIndex] = SdfBitmapContainer{ 0, 0, 0, 0, 0, 0, 0, 0, 0, nullptr };
+					}
+					else if (fieldType == DistanceFieldType::Msdf)
+					{
+						sdfBitmaps[glyphIndex] = GenerateMsdfCodepointBitmap(glyphIndex + glyphOffset, workerFace, lowResFontSize, padding, upscaleResolution);
+					}
+					else
+					{
+						sdfBitmaps[glyphIndex] = GenerateSdfCodepointBitmap(glyphIndex + glyphOffset, workerFace, lowResFontSize, padding, upscaleResolution);
+					}
 
-			SdfBitmapContainer* sdfBitmaps = (SdfBitmapContainer*)AllocMem(sizeof(SdfBitmapContainer) * (characterMapSize - glyphOffset));
-			// Just to be safe, use up to cores - 2
-			const auto processorCount = CMath::Max(std::thread::hardware_concurrency() - 2, 1);
-			int segmentSize = ('z' + 1) / processorCount;
-			int count = 0;
-			std::vector<std::thread> threads;
-			for (int i = 0; i <= processorCount; i++)
-			{
-				int end = CMath::Min(segmentSize + count, characterMapSize - glyphOffset);
-				threads.push_back(std::thread(fillSdfBitmaps, count, end, sdfBitmaps, fontFile.Path.c_str(), lowResFontSize, padding, upscaleResolution, glyphOffset));
-				count += segmentSize;
-			}
+					if (glyphsCompleted)
+					{
+						(*glyphsCompleted)++;
+					}
+				});
 
-			for (auto& th : threads)
+			for (int i = 0; i < numWorkerContexts; i++)
 			{
-				th.join();
+				if (workerContexts[i].Valid)
+				{
+					FT_Done_Face(workerContexts[i].Face);
+					FT_Done_FreeType(workerContexts[i].Library);
+				}
 			}
+			FreeMem(workerContexts);
 
-			for (int codepoint = glyphOffset; codepoint < characterMapSize; codepoint++)
+			// Pack the tallest glyphs first, the skyline packer wastes the least space that way
+			std::vector<int> packOrder;
+			int totalArea = 0;
+			int widestGlyph = 0;
+			for (int i = 0; i < characterMapSize; i++)
 			{
-				if (FT_Load_Char(font, codepoint, FT_LOAD_RENDER))
+				const SdfBitmapContainer& sdf = sdfBitmaps[i];
+				if (!sdf.bitmap)
 				{
-					sdfBitmaps[codepoint - glyphOffset] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, nullptr };
-					Log::Warning("Failed to load glyph.\n");
+					characterMap[i] = Font::nullCharacter;
 					continue;
 				}
 
-				SdfBitmapContainer& container = sdfBitmaps[codepoint];
-				int width = container.width;
-				int height = container.height;
+				packOrder.push_back(i);
+				totalArea += (sdf.width + m_GlyphSpacing) * (sdf.height + m_GlyphSpacing);
+				widestGlyph = CMath::Max(widestGlyph, sdf.width + m_GlyphSpacing);
+			}
+			std::sort(packOrder.begin(), packOrder.end(), [sdfBitmaps](int a, int b) { return sdfBitmaps[a].height > sdfBitmaps[b].height; });
 
-				rowHeight = CMath::Max(height, rowHeight);
-				if (x + width >= fixedWidth)
+			// Start with the smallest power of two square that could hold every glyph and grow it until they all fit
+			int atlasWidth = NextPowerOfTwo(CMath::Max((int)sqrt((float)totalArea), widestGlyph));
+			int atlasHeight = atlasWidth;
+			std::vector<glm::ivec2> glyphPositions(characterMapSize);
+			while (!PackSkyline(sdfBitmaps, packOrder, atlasWidth, atlasHeight, glyphPositions))
+			{
+				if (atlasHeight <= atlasWidth)
 				{
-					x = 0;
-					y += rowHeight;
-					rowHeight = height;
+					atlasHeight *= 2;
+				}
+				else
+				{
+					atlasWidth *= 2;
 				}
-
-				characterMap[codepoint - glyphOffset] = {
-					(float)x + container.xoff,
-					(float)y + container.yoff,
-					(float)(x + width - container.xoff),
-					(float)(y + height - container.yoff),
-					container.advance,
-					container.bearingX,
-					container.bearingY,
-					container.chScaleX,
-					container.chScaleY
-				};
-
-				sdfWidth = CMath::Max(sdfWidth, x + width);
-				sdfHeight = CMath::Max(sdfHeight, y + rowHeight);
-				x += width;
 			}
 
-			// Write all the image data to the final sdf
-			int bitmapLength = sdfWidth * sdfHeight * 4;
-			uint8* finalSdf = (uint8*)AllocMem(sizeof(uint8) * bitmapLength);
+			// A plain sdf only stores the distance, so it's a single channel image
+			int channels = fieldType == DistanceFieldType::Msdf ? 3 : 1;
+			uint8* finalSdf = (uint8*)AllocMem(sizeof(uint8) * atlasWidth * atlasHeight * channels);
 			Log::Assert(finalSdf != nullptr, "Out of memory. Could not allocate memory to generate font.");
-			memset(finalSdf, 0, bitmapLength);
-			int endBitmap = bitmapLength + 1;
+			memset(finalSdf, 0, sizeof(uint8) * atlasWidth * atlasHeight * channels);
 
-			for (int codepoint = glyphOffset; codepoint < characterMapSize; codepoint++)
+			for (int i : packOrder)
 			{
-				SdfBitmapContainer& sdf = sdfBitmaps[codepoint - glyphOffset];
-				float x0 = characterMap[codepoint - glyphOffset].ux0;
-				float y0 = characterMap[codepoint - glyphOffset].uy0;
-				float x1 = characterMap[codepoint - glyphOffset].ux1;
-				float y1 = characterMap[codepoint - glyphOffset].uy1;
-
-				if (!sdf.bitmap) continue;
+				SdfBitmapContainer& sdf = sdfBitmaps[i];
+				int x = glyphPositions[i].x;
+				int y = glyphPositions[i].y;
 
 				// Texture biases give a little wiggle room for sampling the textures, consider adding these as a parameter
 				float bottomLeftTextureBias = -0.1f;
 				float topRightTextureBias = 1;
-				characterMap[codepoint - glyphOffset] = {
-					(float)(x0 + bottomLeftTextureBias) / (float)sdfWidth,
-					(float)(y0 + bottomLeftTextureBias) / (float)sdfHeight,
-					(float)(x1 + topRightTextureBias) / (float)sdfWidth,
-					(float)(y1 + topRightTextureBias) / (float)sdfHeight,
+				characterMap[i] = {
+					(float)(x + sdf.xoff + bottomLeftTextureBias) / (float)atlasWidth,
+					(float)(y + sdf.yoff + bottomLeftTextureBias) / (float)atlasHeight,
+					(float)(x + sdf.width - sdf.xoff + topRightTextureBias) / (float)atlasWidth,
+					(float)(y + sdf.height - sdf.yoff + topRightTextureBias) / (float)atlasHeight,
 					sdf.advance,
 					sdf.bearingX,
 					sdf.bearingY,
@@ -260,31 +1153,21 @@ namespace Cocoa
 					sdf.chScaleY
 				};
 
-				int width = sdf.width;
-				int height = sdf.height;
-				int xoff = sdf.xoff;
-				int yoff = sdf.yoff;
-				x = (int)x0 - xoff;
-				y = (int)y0 - yoff;
-				for (int imgY = 0; imgY < height; imgY++)
+				for (int imgY = 0; imgY < sdf.height; imgY++)
 				{
-					for (int imgX = 0; imgX < width; imgX++)
-					{
-						unsigned char pixelData = sdf.bitmap[imgX + imgY * width];
-						int index = (x + imgX) * 4 + (y + imgY) * sdfWidth * 4;
-						Log::Assert(index + 3 < endBitmap, "Index overflow when generating SDF");
-						finalSdf[index] = pixelData;
-						finalSdf[index + 1] = pixelData;
-						finalSdf[index + 2] = pixelData;
-						finalSdf[index + 3] = pixelData;
-					}
+					memcpy(&finalSdf[(x + (y + imgY) * atlasWidth) * channels], &sdf.bitmap[imgY * sdf.width * channels], sdf.width * channels);
 				}
+			}
 
-				FreeMem(sdf.bitmap);
+			for (int i = 0; i < characterMapSize; i++)
+			{
+				if (sdfBitmaps[i].bitmap)
+				{
+					FreeMem(sdfBitmaps[i].bitmap);
+				}
 			}
 
-			Log::Info("Writing png for font at '%s'\n", outputFile.Path.c_str());
-			stbi_write_png(outputFile.Path.c_str(), sdfWidth, sdfHeight, 4, finalSdf, sdfWidth * 4);
+			stbi_write_png(outputFile.Path.c_str(), atlasWidth, atlasHeight, channels, finalSdf, atlasWidth * channels);
 
 			FreeMem(sdfBitmaps);
 			FreeMem(finalSdf);
@@ -0,0 +1,528 @@
+#include "externalLibs.h"
+
+#include "cocoa/renderer/fonts/GlyphCache.h"
+#include "cocoa/renderer/fonts/Font.h"
+#include "cocoa/renderer/fonts/FontUtil.h"
+#include "cocoa/core/AssetManager.h"
+#include "cocoa/core/Memory.h"
+#include "cocoa/core/JobSystem.h"
+#include "cocoa/util/Log.h"
+#include "cocoa/util/CMath.h"
+
+#include <mutex>
+#include <deque>
+
+namespace Cocoa
+{
+	namespace GlyphCache
+	{
+		struct RasterizeRequest
+		{
+			uint64 Key;
+			uint32 Generation;
+			uint32 Codepoint;
+			std::string FontFilepath;
+			int FontSize;
+			int Padding;
+			int UpscaleResolution;
+		};
+
+		struct RasterizedGlyph
+		{
+			uint64 Key;
+			uint32 Generation;
+			SdfBitmapContainer Sdf;
+		};
+
+		// Cells form an intrusive doubly linked list ordered from most to least recently used
+		struct GlyphCell
+		{
+			uint64 Key;
+			CharInfo Info;
+			int Prev;
+			int Next;
+		};
+
+		// FreeType objects can't be shared between threads, so every worker keeps its own library and faces
+		struct RasterizeContext
+		{
+			FT_Library Library;
+			std::unordered_map<std::string, FT_Face> Faces;
+			bool Initialized;
+			bool Valid;
+		};
+
+		// Internal Variables
+		static const int m_PageSize = 1024;
+		static const int m_CellSize = 128;
+		static const int m_CellsPerRow = m_PageSize / m_CellSize;
+		static const int m_CellsPerPage = m_CellsPerRow * m_CellsPerRow;
+		// Every page takes a texture slot in the font batches, so leave at least half of them for baked font textures
+		static const int m_PageLimit = 8;
+
+		// Values in m_Glyphs that aren't cell indices
+		static const int m_GlyphPending = -1;
+		static const int m_GlyphMissing = -2;
+
+		static int m_MaxPages = 0;
+		static std::vector<Handle<Texture>> m_Pages;
+		static std::vector<GlyphCell> m_Cells;
+		static int m_MostRecent = -1;
+		static int m_LeastRecent = -1;
+		static std::unordered_map<uint64, int> m_Glyphs;
+		// Cells of the existing pages that don't hold a glyph yet
+		static std::vector<int> m_FreeCells;
+		static uint8* m_CellScratch = nullptr;
+
+		static bool m_Running = false;
+
+		// Every request gets its own rasterize job. Contexts are indexed by the worker index the job runs on
+		static std::vector<RasterizeContext> m_RasterizeContexts;
+		static JobCounter m_RasterizeJobs;
+
+		static std::mutex m_RequestMutex;
+		static std::deque<RasterizeRequest> m_Requests;
+
+		static std::mutex m_RasterizedMutex;
+		static std::deque<RasterizedGlyph> m_Rasterized;
+
+		// Only touched from the thread that lays out text. Metrics are read straight from the font file, which is cheap
+		// compared to rasterizing the glyph, so they're known before the glyph lands in a page
+		static FT_Library m_MetricsLibrary = nullptr;
+		static std::unordered_map<std::string, FT_Face> m_MetricsFaces;
+		static std::unordered_map<uint64, CharInfo> m_GlyphMetrics;
+
+		// Bumped every time the cache is cleared, so glyphs requested for an old scene never land in the new one
+		static uint32 m_Generation = 0;
+
+		// Forward Declarations
+		static void RasterizeJob(void* data, int workerIndex);
+		static FT_Face GetContextFace(RasterizeContext& context, const std::string& fontFilepath);
+		static void Insert(uint64 key, const SdfBitmapContainer& sdf);
+		static int AllocateCell();
+		static void Unlink(int cell);
+		static void PushMostRecent(int cell);
+
+		void Init(int memoryBudget)
+		{
+			m_MaxPages = CMath::Min(CMath::Max(memoryBudget / (m_PageSize * m_PageSize), 1), m_PageLimit);
+			m_CellScratch = (uint8*)AllocMem(sizeof(uint8) * m_CellSize * m_CellSize);
+			if (FT_Init_FreeType(&m_MetricsLibrary))
+			{
+				Log::Warning("Could not initialize freetype for the glyph cache metrics.\n");
+				m_MetricsLibrary = nullptr;
+			}
+
+			m_RasterizeContexts.resize(JobSystem::NumWorkers() + 1, RasterizeContext{ nullptr, {}, false, false });
+			m_Running = true;
+		}
+
+		void Destroy()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_RequestMutex);
+				m_Running = false;
+				m_Requests.clear();
+			}
+			// Jobs that are still queued find no request left and return right away
+			JobSystem::Wait(m_RasterizeJobs);
+
+			for (auto& context : m_RasterizeContexts)
+			{
+				for (auto& face : context.Faces)
+				{
+					if (face.second != nullptr)
+					{
+						FT_Done_Face(face.second);
+					}
+				}
+
+				if (context.Valid)
+				{
+					FT_Done_FreeType(context.Library);
+				}
+			}
+			m_RasterizeContexts.clear();
+
+			for (auto& glyph : m_Rasterized)
+			{
+				if (glyph.Sdf.bitmap)
+				{
+					FreeMem(glyph.Sdf.bitmap);
+				}
+			}
+			m_Rasterized.clear();
+
+			if (m_CellScratch)
+			{
+				FreeMem(m_CellScratch);
+				m_CellScratch = nullptr;
+			}
+
+			for (auto& face : m_MetricsFaces)
+			{
+				if (face.second != nullptr)
+				{
+					FT_Done_Face(face.second);
+				}
+			}
+			m_MetricsFaces.clear();
+			m_GlyphMetrics.clear();
+			if (m_MetricsLibrary)
+			{
+				FT_Done_FreeType(m_MetricsLibrary);
+				m_MetricsLibrary = nullptr;
+			}
+		}
+
+		void Update()
+		{
+			while (true)
+			{
+				RasterizedGlyph glyph;
+				{
+					std::lock_guard<std::mutex> lock(m_RasterizedMutex);
+					if (m_Rasterized.empty())
+					{
+						break;
+					}
+					glyph = m_Rasterized.front();
+					m_Rasterized.pop_front();
+				}
+
+				if (glyph.Generation == m_Generation)
+				{
+					Insert(glyph.Key, glyph.Sdf);
+				}
+
+				if (glyph.Sdf.bitmap)
+				{
+					FreeMem(glyph.Sdf.bitmap);
+				}
+			}
+		}
+
+		void Clear()
+		{
+			// The page textures themselves are deleted with the rest of the asset manager's textures
+			m_Generation++;
+			m_Pages.clear();
+			m_Cells.clear();
+			m_FreeCells.clear();
+			m_Glyphs.clear();
+			m_GlyphMetrics.clear();
+			m_MostRecent = -1;
+			m_LeastRecent = -1;
+
+			std::lock_guard<std::mutex> lock(m_RequestMutex);
+			m_Requests.clear();
+		}
+
+		bool GetGlyph(Handle<Font> font, uint32 codepoint, CharInfo& outCharInfo, Handle<Texture>& outPage)
+		{
+			uint64 key = ((uint64)font.m_AssetId << 32) | codepoint;
+			auto iter = m_Glyphs.find(key);
+			if (iter != m_Glyphs.end())
+			{
+				int cell = iter->second;
+				if (cell < 0)
+				{
+					return false;
+				}
+
+				Unlink(cell);
+				PushMostRecent(cell);
+				outCharInfo = m_Cells[cell].Info;
+				outPage = m_Pages[cell / m_CellsPerPage];
+				return true;
+			}
+
+			if (!m_Running)
+			{
+				return false;
+			}
+
+			const Font& fontAsset = AssetManager::GetFont(font.m_AssetId);
+			m_Glyphs[key] = m_GlyphPending;
+			{
+				std::lock_guard<std::mutex> lock(m_RequestMutex);
+				m_Requests.push_back({ key, m_Generation, codepoint, fontAsset.m_Path.Path, fontAsset.m_FontSize, fontAsset.m_Padding, fontAsset.m_UpscaleResolution });
+			}
+			// Keep rasterizing off the main thread, it would stall the frame while the main thread waits on other jobs
+			JobSystem::RunInBackground(RasterizeJob, nullptr, &m_RasterizeJobs);
+			return false;
+		}
+
+		bool GetGlyphMetrics(Handle<Font> font, uint32 codepoint, CharInfo& outCharInfo)
+		{
+			uint64 key = ((uint64)font.m_AssetId << 32) | codepoint;
+			auto glyphIter = m_Glyphs.find(key);
+			if (glyphIter != m_Glyphs.end() && glyphIter->second >= 0)
+			{
+				outCharInfo = m_Cells[glyphIter->second].Info;
+				return true;
+			}
+
+			auto metricsIter = m_GlyphMetrics.find(key);
+			if (metricsIter != m_GlyphMetrics.end())
+			{
+				outCharInfo = metricsIter->second;
+				return true;
+			}
+
+			if (!m_MetricsLibrary)
+			{
+				return false;
+			}
+
+			const Font& fontAsset = AssetManager::GetFont(font.m_AssetId);
+			auto faceIter = m_MetricsFaces.find(fontAsset.m_Path.Path);
+			if (faceIter == m_MetricsFaces.end())
+			{
+				FT_Face face = nullptr;
+				if (FT_New_Face(m_MetricsLibrary, fontAsset.m_Path.Path.c_str(), 0, &face))
+				{
+					face = nullptr;
+				}
+				faceIter = m_MetricsFaces.insert({ fontAsset.m_Path.Path, face }).first;
+			}
+
+			if (faceIter->second == nullptr)
+			{
+				return false;
+			}
+
+			// Codepoints the font doesn't have keep empty metrics, the rasterizer can't draw them either
+			FontUtil::GetGlyphMetrics(codepoint, faceIter->second, outCharInfo);
+			m_GlyphMetrics[key] = outCharInfo;
+			return true;
+		}
+
+		int MaxPages()
+		{
+			return m_MaxPages;
+		}
+
+		int NumPages()
+		{
+			return (int)m_Pages.size();
+		}
+
+		Handle<Texture> GetPage(int index)
+		{
+			return m_Pages[index];
+		}
+
+		static void RasterizeJob(void* data, int workerIndex)
+		{
+			RasterizeRequest request;
+			{
+				std::lock_guard<std::mutex> lock(m_RequestMutex);
+				if (!m_Running || m_Requests.empty())
+				{
+					return;
+				}
+				request = m_Requests.front();
+				m_Requests.pop_front();
+			}
+
+			RasterizedGlyph glyph;
+			glyph.Key = request.Key;
+			glyph.Generation = request.Generation;
+			glyph.Sdf = SdfBitmapContainer{ 0, 0, 0, 0, 0, 0, 0, 0, 0, nullptr };
+
+			FT_Face face = GetContextFace(m_RasterizeContexts[workerIndex], request.FontFilepath);
+			if (face != nullptr)
+			{
+				glyph.Sdf = FontUtil::GenerateSdfCodepointBitmap(request.Codepoint, face, request.FontSize, request.Padding, request.UpscaleResolution);
+
+				// Glyphs too big for a cell get rasterized again at a smaller size. The metrics don't depend on the size,
+				// so the glyph lays out the same and only loses some sharpness
+				int fontSize = request.FontSize;
+				int padding = request.Padding;
+				while (glyph.Sdf.bitmap && (glyph.Sdf.width >= m_CellSize || glyph.Sdf.height >= m_CellSize) && fontSize > 1)
+				{
+					float scale = (float)(m_CellSize - 1) / (float)CMath::Max(glyph.Sdf.width, glyph.Sdf.height);
+					fontSize = CMath::Max(CMath::Min((int)(fontSize * scale), fontSize - 1), 1);
+					padding = (int)(padding * scale);
+					FreeMem(glyph.Sdf.bitmap);
+					glyph.Sdf = FontUtil::GenerateSdfCodepointBitmap(request.Codepoint, face, fontSize, padding, request.UpscaleResolution);
+				}
+
+				if (fontSize != request.FontSize)
+				{
+					Log::Warning("Glyph %d of %s doesn't fit in a %dx%d glyph cache cell at size %d, rasterized it at size %d instead.",
+						request.Codepoint, request.FontFilepath.c_str(), m_CellSize, m_CellSize, request.FontSize, fontSize);
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(m_RasterizedMutex);
+			m_Rasterized.push_back(glyph);
+		}
+
+		static FT_Face GetContextFace(RasterizeContext& context, const std::string& fontFilepath)
+		{
+			if (!context.Initialized)
+			{
+				context.Initialized = true;
+				context.Valid = !FT_Init_FreeType(&context.Library);
+				if (!context.Valid)
+				{
+					Log::Warning("Could not initialize freetype for the glyph cache.\n");
+				}
+			}
+
+			if (!context.Valid)
+			{
+				return nullptr;
+			}
+
+			auto faceIter = context.Faces.find(fontFilepath);
+			if (faceIter == context.Faces.end())
+			{
+				FT_Face face = nullptr;
+				if (FT_New_Face(context.Library, fontFilepath.c_str(), 0, &face))
+				{
+					Log::Warning("Could not load font %s.\n", fontFilepath.c_str());
+					face = nullptr;
+				}
+				faceIter = context.Faces.insert({ fontFilepath, face }).first;
+			}
+
+			return faceIter->second;
+		}
+
+		static void Insert(uint64 key, const SdfBitmapContainer& sdf)
+		{
+			// Leave a texel of the cell free on the right and top so filtering never reaches into the next cell
+			if (!sdf.bitmap || sdf.width >= m_CellSize || sdf.height >= m_CellSize)
+			{
+				if (sdf.bitmap)
+				{
+					Log::Warning("Glyph %d is %dx%d, which doesn't fit in a %dx%d glyph cache cell.", (uint32)key, sdf.width, sdf.height, m_CellSize, m_CellSize);
+				}
+				m_Glyphs[key] = m_GlyphMissing;
+				return;
+			}
+
+			int cell = AllocateCell();
+			GlyphCell& glyphCell = m_Cells[cell];
+			glyphCell.Key = key;
+			PushMostRecent(cell);
+			m_Glyphs[key] = cell;
+
+			int cellInPage = cell % m_CellsPerPage;
+			int x = (cellInPage % m_CellsPerRow) * m_CellSize;
+			int y = (cellInPage / m_CellsPerRow) * m_CellSize;
+
+			// Same texture biases the baked atlases use
+			float bottomLeftTextureBias = -0.1f;
+			float topRightTextureBias = 1;
+			glyphCell.Info = {
+				(float)(x + sdf.xoff + bottomLeftTextureBias) / (float)m_PageSize,
+				(float)(y + sdf.yoff + bottomLeftTextureBias) / (float)m_PageSize,
+				(float)(x + sdf.width - sdf.xoff + topRightTextureBias) / (float)m_PageSize,
+				(float)(y + sdf.height - sdf.yoff + topRightTextureBias) / (float)m_PageSize,
+				sdf.advance,
+				sdf.bearingX,
+				sdf.bearingY,
+				sdf.chScaleX,
+				sdf.chScaleY
+			};
+
+			// Upload the whole cell so nothing of the glyph that used to live here is left around the new one
+			memset(m_CellScratch, 0, sizeof(uint8) * m_CellSize * m_CellSize);
+			for (int row = 0; row < sdf.height; row++)
+			{
+				memcpy(&m_CellScratch[row * m_CellSize], &sdf.bitmap[row * sdf.width], sdf.width);
+			}
+
+			const Texture& page = AssetManager::GetTexture(m_Pages[cell / m_CellsPerPage].m_AssetId);
+			TextureUtil::Bind(page);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, m_CellSize, m_CellSize, GL_RED, GL_UNSIGNED_BYTE, m_CellScratch);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
+
+		static int AllocateCell()
+		{
+			if (!m_FreeCells.empty())
+			{
+				int cell = m_FreeCells.back();
+				m_FreeCells.pop_back();
+				return cell;
+			}
+
+			if (m_Pages.size() < m_MaxPages)
+			{
+				Texture page;
+				page.Width = m_PageSize;
+				page.Height = m_PageSize;
+				page.MagFilter = FilterMode::Linear;
+				page.MinFilter = FilterMode::Linear;
+				page.InternalFormat = ByteFormat::R8;
+				page.ExternalFormat = ByteFormat::RED;
+				TextureUtil::Generate(page);
+				m_Pages.push_back(AssetManager::AddRuntimeTexture(page));
+
+				// The first cell of the new page is used right away, the rest are handed out in order after it
+				int firstCell = (int)m_Cells.size();
+				m_Cells.resize(m_Cells.size() + m_CellsPerPage, GlyphCell{ 0, Font::nullCharacter, -1, -1 });
+				for (int cell = (int)m_Cells.size() - 1; cell > firstCell; cell--)
+				{
+					m_FreeCells.push_back(cell);
+				}
+				return firstCell;
+			}
+
+			// Out of budget, evict the least recently used glyph. It gets rasterized again if it's ever needed
+			int cell = m_LeastRecent;
+			Log::Assert(cell != -1, "Glyph cache has no pages to evict from.");
+			Unlink(cell);
+			m_Glyphs.erase(m_Cells[cell].Key);
+			return cell;
+		}
+
+		static void Unlink(int cell)
+		{
+			GlyphCell& glyphCell = m_Cells[cell];
+			if (glyphCell.Prev != -1)
+			{
+				m_Cells[glyphCell.Prev].Next = glyphCell.Next;
+			}
+			else
+			{
+				m_MostRecent = glyphCell.Next;
+			}
+
+			if (glyphCell.Next != -1)
+			{
+				m_Cells[glyphCell.Next].Prev = glyphCell.Prev;
+			}
+			else
+			{
+				m_LeastRecent = glyphCell.Prev;
+			}
+
+			glyphCell.Prev = -1;
+			glyphCell.Next = -1;
+		}
+
+		static void PushMostRecent(int cell)
+		{
+			GlyphCell& glyphCell = m_Cells[cell];
+			glyphCell.Prev = -1;
+			glyphCell.Next = m_MostRecent;
+			if (m_MostRecent != -1)
+			{
+				m_Cells[m_MostRecent].Prev = cell;
+			}
+			m_MostRecent = cell;
+
+			if (m_LeastRecent == -1)
+			{
+				m_LeastRecent = cell;
+			}
+		}
+	}
+}
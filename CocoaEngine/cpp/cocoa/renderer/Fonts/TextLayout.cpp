@@ -0,0 +1,288 @@
+#include "externalLibs.h"
+
+#include "cocoa/renderer/fonts/TextLayout.h"
+#include "cocoa/renderer/fonts/GlyphCache.h"
+#include "cocoa/renderer/fonts/Font.h"
+#include "cocoa/core/AssetManager.h"
+#include "cocoa/util/Utf8.h"
+
+namespace Cocoa
+{
+	namespace TextLayout
+	{
+		struct CachedLayout
+		{
+			// The parameters the layout was made with, compared on lookup so a hash collision never returns the wrong text
+			std::string Text;
+			uint32 FontId;
+			int FontSize;
+			float WrapWidth;
+			TextAlignment Alignment;
+			float LineSpacing;
+
+			TextLayoutData Layout;
+			uint64 LastUsedFrame;
+			// False if the metrics of a glyph couldn't be read, its advance isn't known so the layout gets redone
+			bool Complete;
+		};
+
+		struct PendingGlyph
+		{
+			uint32 Codepoint;
+			float X;
+			float Advance;
+		};
+
+		struct PendingLine
+		{
+			int Start;
+			int End;
+		};
+
+		// Internal Variables
+		// Layouts that go unused for this many frames get dropped
+		static const uint64 m_FramesToKeep = 120;
+
+		static std::unordered_map<uint64, CachedLayout> m_Layouts;
+		static uint64 m_Frame = 0;
+
+		// Scratch buffers reused between layouts
+		static std::vector<PendingGlyph> m_PendingGlyphs;
+		static std::vector<PendingLine> m_PendingLines;
+
+		// Forward Declarations
+		static uint64 HashBytes(uint64 hash, const void* bytes, size_t size);
+		static uint64 HashLayout(const FontRenderer& fontRenderer);
+		static bool Matches(const CachedLayout& cached, const FontRenderer& fontRenderer);
+		static bool LayOut(const FontRenderer& fontRenderer, TextLayoutData& outLayout);
+		static bool GetAdvance(const Font& font, Handle<Font> fontHandle, uint32 codepoint, float& outAdvance);
+		static float LineWidth(const PendingLine& line);
+
+		const TextLayoutData& Get(const FontRenderer& fontRenderer)
+		{
+			uint64 hash = HashLayout(fontRenderer);
+			auto iter = m_Layouts.find(hash);
+			if (iter != m_Layouts.end() && iter->second.Complete && Matches(iter->second, fontRenderer))
+			{
+				iter->second.LastUsedFrame = m_Frame;
+				return iter->second.Layout;
+			}
+
+			CachedLayout& cached = m_Layouts[hash];
+			cached.Text = fontRenderer.text;
+			cached.FontId = fontRenderer.m_Font.m_AssetId;
+			cached.FontSize = fontRenderer.fontSize;
+			cached.WrapWidth = fontRenderer.m_WrapWidth;
+			cached.Alignment = fontRenderer.m_Alignment;
+			cached.LineSpacing = fontRenderer.m_LineSpacing;
+			cached.LastUsedFrame = m_Frame;
+			cached.Complete = LayOut(fontRenderer, cached.Layout);
+			return cached.Layout;
+		}
+
+		void Update()
+		{
+			m_Frame++;
+			for (auto iter = m_Layouts.begin(); iter != m_Layouts.end();)
+			{
+				if (iter->second.LastUsedFrame + m_FramesToKeep < m_Frame)
+				{
+					iter = m_Layouts.erase(iter);
+				}
+				else
+				{
+					iter++;
+				}
+			}
+		}
+
+		void Clear()
+		{
+			m_Layouts.clear();
+		}
+
+		// Internal Functions
+		static uint64 HashBytes(uint64 hash, const void* bytes, size_t size)
+		{
+			// 64 bit FNV-1a
+			const uint8* data = (const uint8*)bytes;
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= data[i];
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		static uint64 HashLayout(const FontRenderer& fontRenderer)
+		{
+			uint64 hash = 14695981039346656037ull;
+			hash = HashBytes(hash, &fontRenderer.m_Font.m_AssetId, sizeof(uint32));
+			hash = HashBytes(hash, &fontRenderer.fontSize, sizeof(int));
+			hash = HashBytes(hash, &fontRenderer.m_WrapWidth, sizeof(float));
+			hash = HashBytes(hash, &fontRenderer.m_Alignment, sizeof(TextAlignment));
+			hash = HashBytes(hash, &fontRenderer.m_LineSpacing, sizeof(float));
+			return HashBytes(hash, fontRenderer.text.c_str(), fontRenderer.text.size());
+		}
+
+		static bool Matches(const CachedLayout& cached, const FontRenderer& fontRenderer)
+		{
+			return cached.FontId == fontRenderer.m_Font.m_AssetId &&
+				cached.FontSize == fontRenderer.fontSize &&
+				cached.WrapWidth == fontRenderer.m_WrapWidth &&
+				cached.Alignment == fontRenderer.m_Alignment &&
+				cached.LineSpacing == fontRenderer.m_LineSpacing &&
+				cached.Text == fontRenderer.text;
+		}
+
+		static bool GetAdvance(const Font& font, Handle<Font> fontHandle, uint32 codepoint, float& outAdvance)
+		{
+			if (codepoint >= (uint32)font.m_GlyphRangeStart && codepoint < (uint32)font.m_GlyphRangeEnd)
+			{
+				outAdvance = font.GetCharacterInfo(codepoint).advance;
+				return true;
+			}
+
+			// Glyphs the cache is still rasterizing already have their metrics, only their quads have to wait
+			CharInfo charInfo;
+			if (GlyphCache::GetGlyphMetrics(fontHandle, codepoint, charInfo))
+			{
+				outAdvance = charInfo.advance;
+				return true;
+			}
+
+			outAdvance = 0.0f;
+			return false;
+		}
+
+		static float LineWidth(const PendingLine& line)
+		{
+			// Trailing spaces don't count towards the width, otherwise right and center aligned text looks shifted
+			for (int i = line.End - 1; i >= line.Start; i--)
+			{
+				if (m_PendingGlyphs[i].Codepoint != ' ')
+				{
+					return m_PendingGlyphs[i].X + m_PendingGlyphs[i].Advance;
+				}
+			}
+			return 0.0f;
+		}
+
+		static bool LayOut(const FontRenderer& fontRenderer, TextLayoutData& outLayout)
+		{
+			const Font& font = AssetManager::GetFont(fontRenderer.m_Font.m_AssetId);
+			bool complete = true;
+
+			// Everything is laid out in the font's units, where 1 is the font size, and scaled at the end
+			float fontSize = (float)fontRenderer.fontSize;
+			float wrapLimit = fontRenderer.m_WrapWidth > 0.0f && fontSize > 0.0f
+				? fontRenderer.m_WrapWidth / fontSize
+				: 0.0f;
+
+			m_PendingGlyphs.clear();
+			m_PendingLines.clear();
+
+			const std::string& str = fontRenderer.text;
+			int strLength = str.size();
+			int i = 0;
+			int lineStart = 0;
+			int lastSpace = -1;
+			float penX = 0.0f;
+			uint32 previous = 0;
+			while (i < strLength)
+			{
+				uint32 codepoint = Utf8::DecodeNext(str.c_str(), strLength, i);
+				if (codepoint == '\r')
+				{
+					continue;
+				}
+
+				if (codepoint == '\n')
+				{
+					m_PendingLines.push_back({ lineStart, (int)m_PendingGlyphs.size() });
+					lineStart = m_PendingGlyphs.size();
+					lastSpace = -1;
+					penX = 0.0f;
+					previous = 0;
+					continue;
+				}
+
+				float advance;
+				complete &= GetAdvance(font, fontRenderer.m_Font, codepoint, advance);
+				float x = penX + (previous != 0 ? font.GetKerning(previous, codepoint) : 0.0f);
+
+				int numGlyphs = m_PendingGlyphs.size();
+				if (wrapLimit > 0.0f && codepoint != ' ' && x + advance > wrapLimit && numGlyphs > lineStart)
+				{
+					if (lastSpace >= lineStart)
+					{
+						// Break after the last space and carry the partial word over to the next line
+						int wordStart = lastSpace + 1;
+						float shift = wordStart < numGlyphs ? m_PendingGlyphs[wordStart].X : x;
+						for (int g = wordStart; g < numGlyphs; g++)
+						{
+							m_PendingGlyphs[g].X -= shift;
+						}
+						m_PendingLines.push_back({ lineStart, wordStart });
+						lineStart = wordStart;
+						x -= shift;
+					}
+					else
+					{
+						// A single word is wider than the line, so it has to be split wherever it overflows
+						m_PendingLines.push_back({ lineStart, numGlyphs });
+						lineStart = numGlyphs;
+						x = 0.0f;
+					}
+					lastSpace = -1;
+				}
+
+				if (codepoint == ' ')
+				{
+					lastSpace = m_PendingGlyphs.size();
+				}
+
+				m_PendingGlyphs.push_back({ codepoint, x, advance });
+				penX = x + advance;
+				previous = codepoint;
+			}
+			m_PendingLines.push_back({ lineStart, (int)m_PendingGlyphs.size() });
+
+			float alignment = 0.0f;
+			switch (fontRenderer.m_Alignment)
+			{
+			case TextAlignment::Center:
+				alignment = 0.5f;
+				break;
+			case TextAlignment::Right:
+				alignment = 1.0f;
+				break;
+			default:
+				break;
+			}
+
+			// Without a wrap width the text is aligned around its origin
+			float lineAdvance = font.m_LineHeight * fontRenderer.m_LineSpacing * fontSize;
+			float maxWidth = 0.0f;
+			outLayout.Glyphs.clear();
+			outLayout.Glyphs.reserve(m_PendingGlyphs.size());
+			for (int line = 0; line < m_PendingLines.size(); line++)
+			{
+				const PendingLine& pendingLine = m_PendingLines[line];
+				float width = LineWidth(pendingLine);
+				maxWidth = std::max(maxWidth, width);
+				float offset = (wrapLimit - width) * alignment;
+				float y = -line * lineAdvance;
+				for (int g = pendingLine.Start; g < pendingLine.End; g++)
+				{
+					const PendingGlyph& glyph = m_PendingGlyphs[g];
+					outLayout.Glyphs.push_back({ glyph.Codepoint, glm::vec2((glyph.X + offset) * fontSize, y) });
+				}
+			}
+
+			outLayout.NumLines = m_PendingLines.size();
+			outLayout.Size = glm::vec2(maxWidth * fontSize, outLayout.NumLines * lineAdvance);
+			return complete;
+		}
+	}
+}
@@ -124,6 +124,18 @@ namespace Cocoa
 			return pixel;
 		}
 
+		void DrawToAttachment(const Framebuffer& framebuffer, int colorAttachment)
+		{
+			Log::Assert(colorAttachment >= 0 && colorAttachment < framebuffer.ColorAttachments.size(), "Index out of bounds. Color attachment does not exist '%d'.", colorAttachment);
+
+			static GLenum drawBuffers[8];
+			for (int i = 0; i < framebuffer.ColorAttachments.size(); i++)
+			{
+				drawBuffers[i] = i == colorAttachment ? GL_COLOR_ATTACHMENT0 + i : GL_NONE;
+			}
+			glDrawBuffers(framebuffer.ColorAttachments.size(), drawBuffers);
+		}
+
 		void Bind(const Framebuffer& framebuffer)
 		{
 			Log::Assert(framebuffer.Fbo != (uint32)-1, "Tried to bind invalid framebuffer.");
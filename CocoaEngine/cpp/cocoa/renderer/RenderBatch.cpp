@@ -5,6 +5,8 @@
 #include "cocoa/core/Application.h"
 #include "cocoa/core/AssetManager.h"
 #include "cocoa/core/Memory.h"
+#include "cocoa/renderer/fonts/GlyphCache.h"
+#include "cocoa/renderer/fonts/TextLayout.h"
 #include "cocoa/util/CMath.h"
 
 namespace Cocoa
@@ -150,42 +152,59 @@ namespace Cocoa
 		void Add(RenderBatchData& data, const TransformData& transform, const FontRenderer& fontRenderer)
 		{
 			const Font& font = AssetManager::GetFont(fontRenderer.m_Font.m_AssetId);
-			Handle<Texture> tex = font.m_FontTexture;
-			const Texture& texture = AssetManager::GetTexture(tex.m_AssetId);
+			Handle<Texture> fontTexture = font.m_FontTexture;
 
-			if (!tex.IsNull())
+			Entity res = NEntity::FromComponent<TransformData>(transform);
+			uint32 entityId = NEntity::GetID(res);
+
+			const TextLayoutData& layout = TextLayout::Get(fontRenderer);
+			for (const LaidOutGlyph& glyph : layout.Glyphs)
 			{
-				if (!HasTexture(data, tex))
+				uint32 codepoint = glyph.Codepoint;
+
+				// Glyphs outside of the baked range come from the glyph cache, which may still be rasterizing them
+				CharInfo charInfo;
+				Handle<Texture> tex = fontTexture;
+				if (codepoint >= (uint32)font.m_GlyphRangeStart && codepoint < (uint32)font.m_GlyphRangeEnd)
 				{
-					data.Textures[data.NumTextures] = tex;
-					data.NumTextures++;
+					charInfo = font.GetCharacterInfo(codepoint);
+				}
+				else if (!GlyphCache::GetGlyph(fontRenderer.m_Font, codepoint, charInfo, tex))
+				{
+					continue;
 				}
-			}
 
-			int texId = 0;
-			for (int i = 0; i < data.Textures.size(); i++)
-			{
-				if (data.Textures[i] == tex)
+				// Whitespace doesn't need a quad
+				if (charInfo.chScaleX <= 0.0f || charInfo.chScaleY <= 0.0f)
 				{
-					texId = i + 1;
-					break;
+					continue;
 				}
-			}
 
-			Entity res = NEntity::FromComponent<TransformData>(transform);
-			uint32 entityId = NEntity::GetID(res);
+				int texId = 0;
+				if (!tex.IsNull())
+				{
+					if (!HasTexture(data, tex))
+					{
+						data.Textures[data.NumTextures] = tex;
+						data.NumTextures++;
+					}
+
+					for (int texIndex = 0; texIndex < data.NumTextures; texIndex++)
+					{
+						if (data.Textures[texIndex] == tex)
+						{
+							texId = texIndex + 1;
+							break;
+						}
+					}
+				}
 
-			const std::string& str = fontRenderer.text;
-			float x = transform.Position.x;
-			float y = transform.Position.y;
-			int strLength = str.size();
-			for (int i = 0; i < strLength; i++)
-			{
 				// 6 elements per sprite
 				data.NumUsedElements += 6;
-				const CharInfo& charInfo = font.GetCharacterInfo(str[i]);
 				float scaleX = transform.Scale.x * fontRenderer.fontSize;
 				float scaleY = transform.Scale.y * fontRenderer.fontSize;
+				float x = transform.Position.x + glyph.Position.x * transform.Scale.x;
+				float y = transform.Position.y + glyph.Position.y * transform.Scale.y;
 				float x0 = x + (charInfo.bearingX * scaleX);
 				float y0 = y + charInfo.bearingY * scaleY;
 				float x1 = x + (charInfo.bearingX * scaleX) + (charInfo.chScaleX * scaleX);
@@ -204,12 +223,8 @@ namespace Cocoa
 					{charInfo.ux0, charInfo.uy0},
 					{charInfo.ux0, charInfo.uy1}
 				};
-				glm::vec2 quadSize = { charInfo.chScaleX * fontRenderer.fontSize, charInfo.chScaleY * fontRenderer.fontSize };
-				//glm::vec3 pos = { xPos, yPos, 0.0f };
 
 				LoadVertexProperties(data, vertices, texCoords, fontRenderer.m_Color, { 0.0f, 0.0f }, texId, 4, entityId);
-
-				x += charInfo.advance * fontRenderer.fontSize * transform.Scale.x;
 			}
 		}
 
@@ -459,6 +474,27 @@ namespace Cocoa
 			return data.NumTextures < data.Textures.size();
 		}
 
+		bool HasTextureRoom(const RenderBatchData& data, const FontRenderer& fontRenderer)
+		{
+			// Which pages the text ends up on isn't known until it's added, so make room for all of them
+			int texturesNeeded = GlyphCache::MaxPages() + 1;
+			int texturesPresent = 0;
+			const Font& font = AssetManager::GetFont(fontRenderer.m_Font.m_AssetId);
+			if (!font.m_FontTexture.IsNull() && HasTexture(data, font.m_FontTexture))
+			{
+				texturesPresent++;
+			}
+			for (int i = 0; i < GlyphCache::NumPages(); i++)
+			{
+				if (HasTexture(data, GlyphCache::GetPage(i)))
+				{
+					texturesPresent++;
+				}
+			}
+
+			return data.NumTextures + texturesNeeded - texturesPresent <= data.Textures.size();
+		}
+
 		bool HasTexture(const RenderBatchData& data, Handle<Texture> texture)
 		{
 			for (int i = 0; i < data.NumTextures; i++)
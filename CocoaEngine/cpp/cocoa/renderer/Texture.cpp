@@ -36,6 +36,10 @@ namespace Cocoa
 				return GL_LINEAR;
 			case FilterMode::Nearest:
 				return GL_NEAREST;
+			case FilterMode::LinearMipmapLinear:
+				return GL_LINEAR_MIPMAP_LINEAR;
+			case FilterMode::NearestMipmapNearest:
+				return GL_NEAREST_MIPMAP_NEAREST;
 			case FilterMode::None:
 				return GL_NONE;
 			default:
@@ -57,6 +61,10 @@ namespace Cocoa
 				return GL_RGBA;
 			case ByteFormat::RGB:
 				return GL_RGB;
+			case ByteFormat::R8:
+				return GL_R8;
+			case ByteFormat::RED:
+				return GL_RED;
 			case ByteFormat::R32UI:
 				return GL_R32UI;
 			case ByteFormat::RED_INTEGER:
@@ -84,6 +92,10 @@ namespace Cocoa
 				return GL_FLOAT;
 			case ByteFormat::RGB:
 				return GL_FLOAT;
+			case ByteFormat::R8:
+				return GL_FLOAT;
+			case ByteFormat::RED:
+				return GL_FLOAT;
 			case ByteFormat::R32UI:
 				return GL_UNSIGNED_INT;
 			case ByteFormat::RED_INTEGER:
@@ -109,6 +121,10 @@ namespace Cocoa
 				return false;
 			case ByteFormat::RGB:
 				return false;
+			case ByteFormat::R8:
+				return false;
+			case ByteFormat::RED:
+				return false;
 			case ByteFormat::R32UI:
 				return true;
 			case ByteFormat::RED_INTEGER:
@@ -138,31 +154,59 @@ namespace Cocoa
 			}
 			if (texture.MagFilter != FilterMode::None)
 			{
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, ToGl(texture.MagFilter));
+				// Magnification never samples mipmaps, so fall back to the equivalent non mipmapped filter
+				FilterMode magFilter = texture.MagFilter;
+				if (magFilter == FilterMode::LinearMipmapLinear)
+				{
+					magFilter = FilterMode::Linear;
+				}
+				else if (magFilter == FilterMode::NearestMipmapNearest)
+				{
+					magFilter = FilterMode::Nearest;
+				}
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, ToGl(magFilter));
+			}
+
+			// Single channel textures would show up red anywhere they're sampled as color, like the editor previews
+			if (texture.InternalFormat == ByteFormat::R8)
+			{
+				GLint swizzle[] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+				glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
 			}
 		}
 
-		void Generate(Texture& texture, const CPath& path)
+		bool SetFormatFromChannels(Texture& texture, int channels)
 		{
-			int channels;
-
-			unsigned char* pixels = stbi_load(path.Path.c_str(), &texture.Width, &texture.Height, &channels, 0);
-			Log::Assert((pixels != nullptr), "STB failed to load image: %s\n-> STB Failure Reason: %s", path.Path.c_str(), stbi_failure_reason());
-
-			int bytesPerPixel = channels;
-			if (bytesPerPixel == 4)
+			switch (channels)
 			{
+			case 4:
 				texture.InternalFormat = ByteFormat::RGBA8;
 				texture.ExternalFormat = ByteFormat::RGBA;
-			}
-			else if (bytesPerPixel == 3)
-			{
+				return true;
+			case 3:
 				texture.InternalFormat = ByteFormat::RGB8;
 				texture.ExternalFormat = ByteFormat::RGB;
+				return true;
+			case 1:
+				texture.InternalFormat = ByteFormat::R8;
+				texture.ExternalFormat = ByteFormat::RED;
+				return true;
 			}
-			else
+
+			return false;
+		}
+
+		void Generate(Texture& texture, const CPath& path)
+		{
+			int channels;
+
+			unsigned char* pixels = stbi_load(path.Path.c_str(), &texture.Width, &texture.Height, &channels, 0);
+			Log::Assert((pixels != nullptr), "STB failed to load image: %s\n-> STB Failure Reason: %s", path.Path.c_str(), stbi_failure_reason());
+
+			if (!SetFormatFromChannels(texture, channels))
 			{
-				Log::Warning("Unknown number of channels '%d' in image '%s'.", path.Path.c_str(), channels);
+				Log::Warning("Unknown number of channels '%d' in image '%s'.", channels, path.Path.c_str());
+				stbi_image_free(pixels);
 				return;
 			}
 
@@ -174,7 +218,11 @@ namespace Cocoa
 			uint32 internalFormat = ToGl(texture.InternalFormat);
 			uint32 externalFormat = ToGl(texture.ExternalFormat);
 			Log::Assert(internalFormat != GL_NONE && externalFormat != GL_NONE, "Tried to load image from file, but failed to identify internal format for image '%s'", texture.Path.Path.c_str());
+			// Rows of one and three channel images aren't 4 byte aligned
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 			glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, texture.Width, texture.Height, 0, externalFormat, GL_UNSIGNED_BYTE, pixels);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+			GenerateMipmaps(texture);
 
 			stbi_image_free(pixels);
 		}
@@ -200,6 +248,19 @@ namespace Cocoa
 			return texture.GraphicsId == NullTexture.GraphicsId;
 		}
 
+		bool UsesMipmaps(const Texture& texture)
+		{
+			return texture.MinFilter == FilterMode::LinearMipmapLinear || texture.MinFilter == FilterMode::NearestMipmapNearest;
+		}
+
+		void GenerateMipmaps(const Texture& texture)
+		{
+			if (UsesMipmaps(texture))
+			{
+				glGenerateMipmap(GL_TEXTURE_2D);
+			}
+		}
+
 		void Bind(const Texture& texture)
 		{
 			glBindTexture(GL_TEXTURE_2D, texture.GraphicsId);
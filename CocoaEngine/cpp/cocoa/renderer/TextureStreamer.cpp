@@ -0,0 +1,233 @@
+#include "externalLibs.h"
+
+#include "cocoa/renderer/TextureStreamer.h"
+#include "cocoa/core/AssetManager.h"
+#include "cocoa/core/JobSystem.h"
+#include "cocoa/util/Log.h"
+
+#include <stb_image.h>
+#include <mutex>
+#include <deque>
+
+namespace Cocoa
+{
+	namespace TextureStreamer
+	{
+		struct DecodeRequest
+		{
+			uint32 ResourceId;
+			uint32 Generation;
+			std::string Filepath;
+		};
+
+		struct DecodedImage
+		{
+			uint32 ResourceId;
+			uint32 Generation;
+			unsigned char* Pixels;
+			int Width;
+			int Height;
+			int Channels;
+		};
+
+		// Internal Variables
+		static bool m_Running = false;
+
+		// Every queued request kicks off one decode job, which decodes whichever request is next in line
+		static std::mutex m_RequestMutex;
+		static std::deque<DecodeRequest> m_Requests;
+		static JobCounter m_DecodeJobs;
+
+		static std::mutex m_DecodedMutex;
+		static std::deque<DecodedImage> m_Decoded;
+
+		// Bumped every time the asset manager is cleared, so images decoded for an old scene never land in the new one
+		static uint32 m_Generation = 0;
+
+		// Uploads cycle through a few buffers so a new upload doesn't have to wait on the previous transfer
+		static const int m_NumPixelBuffers = 3;
+		static uint32 m_PixelBuffers[m_NumPixelBuffers];
+		static int m_NextPixelBuffer = 0;
+
+		static Texture m_Placeholder;
+
+		// Forward Declarations
+		static void DecodeJob(void* data, int workerIndex);
+		static int Upload(const DecodedImage& image);
+
+		void Init()
+		{
+			// Placeholder is a single opaque grey pixel
+			m_Placeholder = Texture();
+			m_Placeholder.Width = 1;
+			m_Placeholder.Height = 1;
+			m_Placeholder.MagFilter = FilterMode::Nearest;
+			m_Placeholder.MinFilter = FilterMode::Nearest;
+			m_Placeholder.WrapS = WrapMode::Repeat;
+			m_Placeholder.WrapT = WrapMode::Repeat;
+			m_Placeholder.InternalFormat = ByteFormat::RGBA8;
+			m_Placeholder.ExternalFormat = ByteFormat::RGBA;
+			m_Placeholder.IsDefault = true;
+			TextureUtil::Generate(m_Placeholder);
+			static const unsigned char placeholderPixel[4] = { 128, 128, 128, 255 };
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, placeholderPixel);
+
+			glGenBuffers(m_NumPixelBuffers, m_PixelBuffers);
+			m_NextPixelBuffer = 0;
+			m_Running = true;
+		}
+
+		void Destroy()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_RequestMutex);
+				m_Running = false;
+				m_Requests.clear();
+			}
+			// Jobs that haven't started yet find the queue empty and return right away
+			JobSystem::Wait(m_DecodeJobs);
+
+			for (auto& image : m_Decoded)
+			{
+				stbi_image_free(image.Pixels);
+			}
+			m_Decoded.clear();
+
+			glDeleteBuffers(m_NumPixelBuffers, m_PixelBuffers);
+			TextureUtil::Delete(m_Placeholder);
+		}
+
+		void Queue(uint32 resourceId, const CPath& path)
+		{
+			Log::Assert(m_Running, "Texture streamer must be initialized before queueing textures.");
+			{
+				std::lock_guard<std::mutex> lock(m_RequestMutex);
+				m_Requests.push_back({ resourceId, m_Generation, path.Path });
+			}
+			JobSystem::RunInBackground(DecodeJob, nullptr, &m_DecodeJobs);
+		}
+
+		void Update(int byteBudget)
+		{
+			int bytesUploaded = 0;
+			while (bytesUploaded < byteBudget)
+			{
+				DecodedImage image;
+				{
+					std::lock_guard<std::mutex> lock(m_DecodedMutex);
+					if (m_Decoded.empty())
+					{
+						break;
+					}
+					image = m_Decoded.front();
+					m_Decoded.pop_front();
+				}
+
+				if (image.Generation == m_Generation)
+				{
+					bytesUploaded += Upload(image);
+				}
+				stbi_image_free(image.Pixels);
+			}
+		}
+
+		void CancelAll()
+		{
+			m_Generation++;
+			std::lock_guard<std::mutex> lock(m_RequestMutex);
+			m_Requests.clear();
+		}
+
+		const Texture& GetPlaceholder()
+		{
+			return m_Placeholder;
+		}
+
+		static void DecodeJob(void* data, int workerIndex)
+		{
+			DecodeRequest request;
+			{
+				std::lock_guard<std::mutex> lock(m_RequestMutex);
+				if (!m_Running || m_Requests.empty())
+				{
+					return;
+				}
+				request = m_Requests.front();
+				m_Requests.pop_front();
+			}
+
+			DecodedImage image;
+			image.ResourceId = request.ResourceId;
+			image.Generation = request.Generation;
+			image.Pixels = stbi_load(request.Filepath.c_str(), &image.Width, &image.Height, &image.Channels, 0);
+			if (image.Pixels == nullptr)
+			{
+				Log::Warning("STB failed to load image: %s", request.Filepath.c_str());
+			}
+
+			std::lock_guard<std::mutex> lock(m_DecodedMutex);
+			m_Decoded.push_back(image);
+		}
+
+		static int Upload(const DecodedImage& image)
+		{
+			if (image.ResourceId >= AssetManager::s_Textures.size())
+			{
+				return 0;
+			}
+
+			Texture& texture = AssetManager::s_Textures[image.ResourceId];
+			if (!texture.IsStreaming)
+			{
+				return 0;
+			}
+			// If decoding failed the texture stays null, same as a failed synchronous load
+			texture.IsStreaming = false;
+			if (image.Pixels == nullptr)
+			{
+				return 0;
+			}
+
+			if (!TextureUtil::SetFormatFromChannels(texture, image.Channels))
+			{
+				Log::Warning("Unknown number of channels '%d' in image '%s'.", image.Channels, texture.Path.Path.c_str());
+				return 0;
+			}
+			texture.Width = image.Width;
+			texture.Height = image.Height;
+
+			int numBytes = image.Width * image.Height * image.Channels;
+			uint32 pixelBuffer = m_PixelBuffers[m_NextPixelBuffer];
+			m_NextPixelBuffer = (m_NextPixelBuffer + 1) % m_NumPixelBuffers;
+
+			// Rows of one and three channel images aren't 4 byte aligned
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+			// Orphan the old storage so the driver can hand back fresh memory instead of waiting on the last transfer
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, numBytes, nullptr, GL_STREAM_DRAW);
+			void* bufferMemory = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, numBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+			if (bufferMemory != nullptr)
+			{
+				memcpy(bufferMemory, image.Pixels, numBytes);
+				glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+				// While a pixel unpack buffer is bound, the null data pointer Generate passes to glTexImage2D
+				// is an offset into the buffer, so the pixels are sourced from the buffer we just filled
+				TextureUtil::Generate(texture);
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			}
+			else
+			{
+				Log::Warning("Failed to map pixel buffer, uploading '%s' directly.", texture.Path.Path.c_str());
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				TextureUtil::Generate(texture);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.Width, image.Height, TextureUtil::ToGl(texture.ExternalFormat), GL_UNSIGNED_BYTE, image.Pixels);
+			}
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+			TextureUtil::GenerateMipmaps(texture);
+
+			return numBytes;
+		}
+	}
+}
@@ -1,4 +1,5 @@
 #include "cocoa/scenes/Scene.h"
+#include "cocoa/scenes/ComponentGroups.h"
 
 #include "cocoa/file/OutputArchive.h"
 #include "cocoa/file/File.h"
@@ -8,9 +9,13 @@
 #include "cocoa/components/Tag.h"
 #include "cocoa/systems/ScriptSystem.h"
 #include "cocoa/systems/TransformSystem.h"
+#include "cocoa/systems/SystemScheduler.h"
 #include "cocoa/scenes/SceneInitializer.h"
 #include "cocoa/core/AssetManager.h"
 #include "cocoa/renderer/DebugDraw.h"
+#include "cocoa/renderer/TextureStreamer.h"
+#include "cocoa/renderer/fonts/GlyphCache.h"
+#include "cocoa/renderer/fonts/TextLayout.h"
 
 #include <nlohmann/json.hpp>
 
@@ -21,6 +26,9 @@ namespace Cocoa
 		// Forward Declarations
 		static void LoadDefaultAssets();
 		static Entity FindOrCreateEntity(int id, SceneData& scene, entt::registry& registry);
+		static void RegisterSystems();
+		static Entity DuplicateComponents(SceneData& data, Entity entity);
+		static void UpdateCamera(SceneData& scene, float dt);
 
 		SceneData Create(SceneInitializer* sceneInitializer)
 		{
@@ -46,6 +54,7 @@ namespace Cocoa
 
 			RenderSystem::Init(data);
 			Physics2D::Init({ 0, -10.0f });
+			RegisterSystems();
 			ScriptSystem::Init(data);
 
 			data.CurrentSceneInitializer->Init(data);
@@ -54,6 +63,7 @@ namespace Cocoa
 		static void InitComponentIds(SceneData& scene)
 		{
 			NEntity::RegisterComponentType<TransformData>();
+			NEntity::RegisterComponentType<TransformHierarchy>();
 			NEntity::RegisterComponentType<Tag>();
 			NEntity::RegisterComponentType<SpriteRenderer>();
 			NEntity::RegisterComponentType<FontRenderer>();
@@ -61,6 +71,7 @@ namespace Cocoa
 			NEntity::RegisterComponentType<Box2D>();
 			NEntity::RegisterComponentType<Circle>();
 			NEntity::RegisterComponentType<AABB>();
+			ComponentGroups::Init(scene);
 		}
 
 		void Start(SceneData& data)
@@ -68,21 +79,39 @@ namespace Cocoa
 			data.CurrentSceneInitializer->Start(data);
 		}
 
+		static void RegisterSystems()
+		{
+			// There are certain systems that use the same update loop for the editor and the actual game, so there's no 
+			// sense in creating a unique update loop if the logic is the same (TransformSystem, and NCamera are examples of this)
+			SystemScheduler::Clear();
+
+			SystemDefinition transformSystem = { "Transforms", SystemOrder::Transform, TransformSystem::Update, TransformSystem::Update };
+			transformSystem.Access.Read<TransformHierarchy>().Write<TransformData>();
+			SystemScheduler::Register(transformSystem);
+
+			SystemDefinition physicsSystem = { "Physics 2D", SystemOrder::Physics, Physics2D::Update, nullptr };
+			// Bodies are stepped in place, so anything reading a rigidbody has to wait for the step as well
+			physicsSystem.Access.Write<TransformData, Rigidbody2D>();
+			SystemScheduler::Register(physicsSystem);
+
+			SystemDefinition cameraSystem = { "Camera", SystemOrder::Camera, UpdateCamera, UpdateCamera };
+			cameraSystem.Access.Write<Camera>();
+			SystemScheduler::Register(cameraSystem);
+		}
+
+		static void UpdateCamera(SceneData& scene, float dt)
+		{
+			NCamera::Update(scene.SceneCamera);
+		}
+
 		void Update(SceneData& data, float dt)
 		{
-			TransformSystem::Update(data, dt);
-			Physics2D::Update(data, dt);
-			ScriptSystem::Update(data, dt);
-			NCamera::Update(data.SceneCamera);
+			SystemScheduler::Update(data, dt);
 		}
 
 		void EditorUpdate(SceneData& data, float dt)
 		{
-			// There are certain systems that use the same update loop for the editor and the actual game, so there's no 
-			// sense in creating a unique update loop if the logic is the same (TransformSystem, and NCamera are examples of this)
-			TransformSystem::Update(data, dt);
-			ScriptSystem::EditorUpdate(data, dt);
-			NCamera::Update(data.SceneCamera);
+			SystemScheduler::EditorUpdate(data, dt);
 		}
 
 		void OnEvent(SceneData& data, const Event& e)
@@ -92,13 +121,18 @@ namespace Cocoa
 
 		void Render(SceneData& data)
 		{
+			TextureStreamer::Update();
+			GlyphCache::Update();
+			TextLayout::Update();
+
+			// The entity id attachment is only written on demand by RenderSystem::PickEntityId
 			NFramebuffer::Bind(RenderSystem::GetMainFramebuffer());
+			NFramebuffer::DrawToAttachment(RenderSystem::GetMainFramebuffer(), 0);
 
 			glEnable(GL_BLEND);
 			glViewport(0, 0, 3840, 2160);
 			glClearColor(0.45f, 0.55f, 0.6f, 1.0f);
 			glClear(GL_COLOR_BUFFER_BIT);
-			NFramebuffer::ClearColorAttachmentUint32(RenderSystem::GetMainFramebuffer(), 1, (uint32)-1);
 			//RenderSystem::UploadUniform1ui("uActiveEntityID", InspectorWindow::GetActiveEntity().GetID() + 1);
 
 			DebugDraw::DrawBottomBatches(data.SceneCamera);
@@ -286,6 +320,35 @@ namespace Cocoa
 		}
 
 		Entity DuplicateEntity(SceneData& data, Entity entity)
+		{
+			// Children get duplicated along with the entity
+			std::vector<Entity> subtree;
+			Transform::GetSubtree(entity, subtree);
+			std::unordered_map<entt::entity, Entity> duplicates;
+			for (Entity original : subtree)
+			{
+				duplicates[original.Handle] = DuplicateComponents(data, original);
+			}
+
+			// The subtree lists parents before their children, so every parent is linked up before its children
+			for (int i = 0; i < subtree.size(); i++)
+			{
+				Entity parent = Transform::GetParent(subtree[i]);
+				if (i > 0)
+				{
+					parent = duplicates[parent.Handle];
+				}
+
+				if (!NEntity::IsNull(parent))
+				{
+					Transform::SetParent(duplicates[subtree[i].Handle], parent);
+				}
+			}
+
+			return duplicates[entity.Handle];
+		}
+
+		static Entity DuplicateComponents(SceneData& data, Entity entity)
 		{
 			entt::entity newEntEntity = data.Registry.create();
 			Entity newEntity = Entity{ newEntEntity };
@@ -311,10 +374,8 @@ namespace Cocoa
 
 			if (NEntity::HasComponent<Tag>(entity))
 			{
-				Tag& tag = NEntity::GetComponent<Tag>(entity);
-				char* newTagName = (char*)AllocMem((tag.Size + 1) * sizeof(char));
-				memcpy(newTagName, tag.Name, (tag.Size + 1) * sizeof(char));
-				NEntity::AddComponent<Tag>(newEntity, NTag::CreateTag(newTagName, true));
+				Tag newTag = NTag::CreateTag(NEntity::GetComponent<Tag>(entity).Name, true);
+				NEntity::AddComponent<Tag>(newEntity, newTag);
 			}
 
 			return newEntity;
@@ -342,21 +403,16 @@ namespace Cocoa
 
 		void DeleteEntity(SceneData& scene, Entity entity)
 		{
-			// Recursively delete entity and all children
-			auto view = scene.Registry.view<TransformData>();
-			for (entt::entity rawEntity : view)
+			// Delete the entity and all of its children, detaching it first keeps the parent's child list intact
+			std::vector<Entity> subtree;
+			Transform::GetSubtree(entity, subtree);
+			Transform::SetParent(entity, NEntity::CreateNull());
+			for (Entity toDelete : subtree)
 			{
-				Entity potentialChild = NEntity::CreateEntity(rawEntity);
-				TransformData& transformData = NEntity::GetComponent<TransformData>(potentialChild);
-				if (transformData.Parent == entity)
-				{
-					DeleteEntity(scene, potentialChild);
-				}
+				Physics2D::DeleteEntity(toDelete);
+				TransformSystem::DeleteEntity(toDelete);
+				scene.Registry.destroy(toDelete.Handle);
 			}
-
-			Physics2D::DeleteEntity(entity);
-			TransformSystem::DeleteEntity(entity);
-			scene.Registry.destroy(entity.Handle);
 		}
 
 		static void LoadDefaultAssets()
@@ -2,6 +2,7 @@
 
 #include "cocoa/util/Log.h"
 #include "cocoa/systems/RenderSystem.h"
+#include "cocoa/scenes/ComponentGroups.h"
 #include "cocoa/core/Application.h"
 #include "cocoa/core/AssetManager.h"
 #include "cocoa/commands/ICommand.h"
@@ -17,6 +18,7 @@ namespace Cocoa
 		// Internal Variables
 		static Handle<Shader> m_SpriteShader = Handle<Shader>();
 		static Handle<Shader> m_FontShader = Handle<Shader>();
+		static Handle<Shader> m_PickingShader = Handle<Shader>();
 		static Framebuffer m_MainFramebuffer = Framebuffer();
 
 		static int m_TexSlots[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
@@ -25,6 +27,9 @@ namespace Cocoa
 		static DynamicArray<RenderBatchData> m_Batches;
 		static Camera* m_Camera;
 
+		// Forward Declarations
+		static void RenderBatches(SceneData& scene, Handle<Shader> overrideShader);
+
 		void Init(SceneData& scene)
 		{
 			m_Camera = &scene.SceneCamera;
@@ -57,7 +62,10 @@ namespace Cocoa
 			m_FontShader = AssetManager::LoadShaderFromFile(fontShaderPath, true);
 			CPath pickingShaderPath = Settings::General::s_EngineAssetsPath;
 			NCPath::Join(pickingShaderPath, NCPath::CreatePath("shaders/Picking.glsl"));
-			AssetManager::LoadShaderFromFile(pickingShaderPath, true);
+			m_PickingShader = AssetManager::LoadShaderFromFile(pickingShaderPath, true);
+			CPath gridShaderPath = Settings::General::s_EngineAssetsPath;
+			NCPath::Join(gridShaderPath, NCPath::CreatePath("shaders/Grid2D.glsl"));
+			AssetManager::LoadShaderFromFile(gridShaderPath, true);
 		}
 
 		void Destroy()
@@ -102,15 +110,13 @@ namespace Cocoa
 
 		void AddEntity(const TransformData& transform, const FontRenderer& fontRenderer)
 		{
-			const Font& font = AssetManager::GetFont(fontRenderer.m_Font.m_AssetId);
 			bool wasAdded = false;
 			for (int i=0; i < m_Batches.m_NumElements; i++)
 			{
 				RenderBatchData& batch = NDynamicArray::Get<RenderBatchData>(m_Batches, i);
 				if (RenderBatch::HasRoom(batch, fontRenderer) && fontRenderer.m_ZIndex == batch.ZIndex && batch.BatchShader == m_FontShader)
 				{
-					Handle<Texture> tex = font.m_FontTexture;
-					if (!tex || RenderBatch::HasTexture(batch, tex) || RenderBatch::HasTextureRoom(batch))
+					if (RenderBatch::HasTextureRoom(batch, fontRenderer))
 					{
 						RenderBatch::Add(batch, transform, fontRenderer);
 						wasAdded = true;
@@ -129,14 +135,47 @@ namespace Cocoa
 			}
 		}
 
-		void Render(const SceneData& scene)
+		void Render(SceneData& scene)
+		{
+			RenderBatches(scene, Handle<Shader>());
+		}
+
+		uint32 PickEntityId(SceneData& scene, int x, int y)
+		{
+			if (x < 0 || y < 0 || x >= m_MainFramebuffer.Width || y >= m_MainFramebuffer.Height)
+			{
+				return (uint32)-1;
+			}
+
+			GLint oldViewport[4];
+			glGetIntegerv(GL_VIEWPORT, oldViewport);
+
+			NFramebuffer::Bind(m_MainFramebuffer);
+			NFramebuffer::DrawToAttachment(m_MainFramebuffer, 1);
+			glViewport(0, 0, m_MainFramebuffer.Width, m_MainFramebuffer.Height);
+
+			// Only the pixel under the cursor gets cleared and rasterized
+			glEnable(GL_SCISSOR_TEST);
+			glScissor(x, y, 1, 1);
+			static const uint32 clearId = (uint32)-1;
+			glClearBufferuiv(GL_COLOR, 1, &clearId);
+			RenderBatches(scene, m_PickingShader);
+			glDisable(GL_SCISSOR_TEST);
+
+			NFramebuffer::DrawToAttachment(m_MainFramebuffer, 0);
+			glViewport(oldViewport[0], oldViewport[1], oldViewport[2], oldViewport[3]);
+
+			return NFramebuffer::ReadPixelUint32(m_MainFramebuffer, 1, x, y);
+		}
+
+		static void RenderBatches(SceneData& scene, Handle<Shader> overrideShader)
 		{
-			scene.Registry.view<const SpriteRenderer, const TransformData>().each([](auto entity, const auto& spriteRenderer, const auto& transform)
+			ComponentGroups::Sprites(scene).each([](auto entity, const auto& transform, const auto& spriteRenderer)
 				{
 					AddEntity(transform, spriteRenderer);
 				});
 
-			scene.Registry.view<const FontRenderer, const TransformData>().each([](auto entity, const auto& fontRenderer, const auto& transform)
+			ComponentGroups::Fonts(scene).each([](auto entity, const auto& fontRenderer, const auto& transform)
 				{
 					AddEntity(transform, fontRenderer);
 				});
@@ -144,8 +183,9 @@ namespace Cocoa
 			for (int i=0; i < m_Batches.m_NumElements; i++)
 			{
 				RenderBatchData& batch = NDynamicArray::Get<RenderBatchData>(m_Batches, i);
-				Log::Assert(!batch.BatchShader.IsNull(), "Cannot render with a null shader.");
-				const Shader& shader = AssetManager::GetShader(batch.BatchShader.m_AssetId);
+				Handle<Shader> shaderHandle = overrideShader.IsNull() ? batch.BatchShader : overrideShader;
+				Log::Assert(!shaderHandle.IsNull(), "Cannot render with a null shader.");
+				const Shader& shader = AssetManager::GetShader(shaderHandle.m_AssetId);
 				NShader::Bind(shader);
 				NShader::UploadMat4(shader, "uProjection", m_Camera->ProjectionMatrix);
 				NShader::UploadMat4(shader, "uView", m_Camera->ViewMatrix);
@@ -208,6 +248,9 @@ namespace Cocoa
 			json zIndex = { "ZIndex", fontRenderer.m_ZIndex };
 			json text = { "Text", fontRenderer.text };
 			json fontSize = { "FontSize", fontRenderer.fontSize };
+			json wrapWidth = { "WrapWidth", fontRenderer.m_WrapWidth };
+			json alignment = { "Alignment", (int)fontRenderer.m_Alignment };
+			json lineSpacing = { "LineSpacing", fontRenderer.m_LineSpacing };
 			if (fontRenderer.m_Font)
 			{
 				assetId = { "AssetId", fontRenderer.m_Font.m_AssetId };
@@ -221,7 +264,10 @@ namespace Cocoa
 					zIndex,
 					color,
 					text,
-					fontSize
+					fontSize,
+					wrapWidth,
+					alignment,
+					lineSpacing
 				}}
 			};
 		}
@@ -252,6 +298,21 @@ namespace Cocoa
 			{
 				fontRenderer.fontSize = j["FontRenderer"]["FontSize"];
 			}
+
+			if (j["FontRenderer"].contains("WrapWidth"))
+			{
+				fontRenderer.m_WrapWidth = j["FontRenderer"]["WrapWidth"];
+			}
+
+			if (j["FontRenderer"].contains("Alignment"))
+			{
+				fontRenderer.m_Alignment = (TextAlignment)j["FontRenderer"]["Alignment"].get<int>();
+			}
+
+			if (j["FontRenderer"].contains("LineSpacing"))
+			{
+				fontRenderer.m_LineSpacing = j["FontRenderer"]["LineSpacing"];
+			}
 			NEntity::AddComponent<FontRenderer>(entity, fontRenderer);
 		}
 	}
@@ -21,10 +21,14 @@ namespace Cocoa
 		static InitImGuiFn m_InitImGui = nullptr;
 		static ImGuiFn m_ImGui = nullptr;
 		static DeleteScriptsFn m_DeleteScripts = nullptr;
+		static RegisterScriptSystemsFn m_RegisterScriptSystems = nullptr;
 		
 		static bool m_IsLoaded = false;
 		static HMODULE m_Module;
 
+		// The systems point into the script module, so they have to be unregistered before it gets freed
+		static std::vector<uint32> m_ScriptSystems;
+
 		// Forward Declarations
 		static void AddComponentStub(entt::registry&, std::string, entt::entity) { Log::Warning("Adding component from STUB"); }
 		static void UpdateScriptStub(entt::registry&, float) {}
@@ -35,6 +39,8 @@ namespace Cocoa
 		static void InitImGuiStub(void*) {}
 		static void ImGuiStub(entt::registry&, Entity) {}
 		static void DeleteScriptsStub() {}
+		static void RegisterScriptSystemsStub(std::vector<SystemDefinition>&) {}
+		static void RegisterSystems();
 
 		static FARPROC __stdcall TryLoadFunction(HMODULE module, const char* functionName)
 		{
@@ -92,12 +98,14 @@ namespace Cocoa
 					m_InitImGui = (InitImGuiFn)TryLoadFunction(m_Module, "InitImGui");
 					m_ImGui = (ImGuiFn)TryLoadFunction(m_Module, "ImGui");
 					m_DeleteScripts = (DeleteScriptsFn)TryLoadFunction(m_Module, "DeleteScripts");
+					m_RegisterScriptSystems = (RegisterScriptSystemsFn)TryLoadFunction(m_Module, "RegisterScriptSystems");
 					m_IsLoaded = true;
 
 					if (m_InitScripts)
 					{
 						m_InitScripts(&scene);
 					}
+					RegisterSystems();
 				}
 			}
 		}
@@ -116,6 +124,12 @@ namespace Cocoa
 				m_DeleteScripts();
 			}
 
+			for (uint32 systemId : m_ScriptSystems)
+			{
+				SystemScheduler::Unregister(systemId);
+			}
+			m_ScriptSystems.clear();
+
 			m_SaveScripts = SaveScriptsStub;
 			m_LoadScript = LoadScriptStub;
 			m_UpdateScripts = UpdateScriptStub;
@@ -125,6 +139,7 @@ namespace Cocoa
 			m_InitImGui = InitImGuiStub;
 			m_ImGui = ImGuiStub;
 			m_DeleteScripts = DeleteScriptsStub;
+			m_RegisterScriptSystems = RegisterScriptSystemsStub;
 
 			if (!FreeLibrary(m_Module))
 			{
@@ -178,5 +193,27 @@ namespace Cocoa
 				m_LoadScript(scene.Registry, j, entity);
 			}
 		}
+
+		static void RegisterSystems()
+		{
+			std::vector<SystemDefinition> systems;
+			if (m_RegisterScriptSystems)
+			{
+				m_RegisterScriptSystems(systems);
+			}
+			else
+			{
+				// Modules generated before the scheduler existed update every script from one function
+				SystemDefinition allScripts = { "Scripts", SystemOrder::Scripts, Update, EditorUpdate };
+				allScripts.Access.Exclusive = true;
+				systems.push_back(allScripts);
+			}
+
+			for (SystemDefinition& system : systems)
+			{
+				system.Order = SystemOrder::Scripts;
+				m_ScriptSystems.push_back(SystemScheduler::Register(system));
+			}
+		}
 	}
 }
\ No newline at end of file
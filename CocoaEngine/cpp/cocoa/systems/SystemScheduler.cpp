@@ -0,0 +1,260 @@
+#include "cocoa/systems/SystemScheduler.h"
+#include "cocoa/core/JobSystem.h"
+#include "cocoa/util/Log.h"
+
+#include <chrono>
+#include <memory>
+
+namespace Cocoa
+{
+	namespace SystemScheduler
+	{
+		struct RegisteredSystem
+		{
+			uint32 Id;
+			SystemDefinition Definition;
+		};
+
+		struct ScheduledSystem
+		{
+			SystemFn Function;
+			const RegisteredSystem* System;
+			std::vector<int> Dependents;
+			int NumDependencies;
+			float Milliseconds;
+		};
+
+		// Runs of systems that may overlap. Exclusive systems conflict with everything, so they always get a segment of their own
+		struct Segment
+		{
+			int Start;
+			int End;
+			bool Exclusive;
+		};
+
+		struct FrameGraph
+		{
+			std::vector<ScheduledSystem> Systems;
+			std::vector<Segment> Segments;
+			std::unique_ptr<std::atomic<int>[]> PendingDependencies;
+			std::vector<SystemTiming> Timings;
+			bool Dirty = true;
+		};
+
+		// Internal Variables
+		static std::vector<RegisteredSystem> m_Systems;
+		static uint32 m_NextSystemId = 0;
+
+		static FrameGraph m_UpdateGraph;
+		static FrameGraph m_EditorUpdateGraph;
+		static const std::vector<SystemTiming>* m_LastTimings = nullptr;
+
+		// State of the graph that is currently running, read by the system jobs
+		static FrameGraph* m_CurrentGraph = nullptr;
+		static SceneData* m_CurrentScene = nullptr;
+		static float m_CurrentDt = 0.0f;
+		static JobCounter* m_CurrentSegment = nullptr;
+
+		// Forward Declarations
+		static void Build(FrameGraph& graph, bool editor);
+		static void Run(FrameGraph& graph, SceneData& scene, float dt, bool editor);
+		static bool Conflicts(const SystemAccess& a, const SystemAccess& b);
+		static void RunSystem(FrameGraph& graph, int index);
+		static void SystemJob(void* data, int workerIndex);
+
+		uint32 Register(const SystemDefinition& system)
+		{
+			uint32 id = m_NextSystemId++;
+			m_Systems.push_back({ id, system });
+			m_UpdateGraph.Dirty = true;
+			m_EditorUpdateGraph.Dirty = true;
+			return id;
+		}
+
+		void Unregister(uint32 systemId)
+		{
+			for (auto iter = m_Systems.begin(); iter != m_Systems.end(); iter++)
+			{
+				if (iter->Id == systemId)
+				{
+					m_Systems.erase(iter);
+					m_UpdateGraph.Dirty = true;
+					m_EditorUpdateGraph.Dirty = true;
+					return;
+				}
+			}
+		}
+
+		void Clear()
+		{
+			m_Systems.clear();
+			m_UpdateGraph.Dirty = true;
+			m_EditorUpdateGraph.Dirty = true;
+		}
+
+		void Update(SceneData& scene, float dt)
+		{
+			Run(m_UpdateGraph, scene, dt, false);
+		}
+
+		void EditorUpdate(SceneData& scene, float dt)
+		{
+			Run(m_EditorUpdateGraph, scene, dt, true);
+		}
+
+		const std::vector<SystemTiming>& GetTimings()
+		{
+			static const std::vector<SystemTiming> noTimings;
+			return m_LastTimings ? *m_LastTimings : noTimings;
+		}
+
+		// Internal Functions
+		static bool Conflicts(const SystemAccess& a, const SystemAccess& b)
+		{
+			if (a.Exclusive || b.Exclusive)
+			{
+				return true;
+			}
+
+			for (uint32 write : a.Writes)
+			{
+				if (std::find(b.Writes.begin(), b.Writes.end(), write) != b.Writes.end() ||
+					std::find(b.Reads.begin(), b.Reads.end(), write) != b.Reads.end())
+				{
+					return true;
+				}
+			}
+
+			for (uint32 write : b.Writes)
+			{
+				if (std::find(a.Reads.begin(), a.Reads.end(), write) != a.Reads.end())
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		static void Build(FrameGraph& graph, bool editor)
+		{
+			// Systems are stored in the order they were registered, so a stable sort keeps that order among equals
+			std::vector<const RegisteredSystem*> sorted;
+			for (const RegisteredSystem& system : m_Systems)
+			{
+				if ((editor ? system.Definition.EditorUpdate : system.Definition.Update) != nullptr)
+				{
+					sorted.push_back(&system);
+				}
+			}
+			std::stable_sort(sorted.begin(), sorted.end(), [](const RegisteredSystem* a, const RegisteredSystem* b)
+			{
+				return a->Definition.Order < b->Definition.Order;
+			});
+
+			graph.Systems.clear();
+			graph.Segments.clear();
+			graph.Timings.clear();
+			for (const RegisteredSystem* system : sorted)
+			{
+				int index = graph.Systems.size();
+				graph.Systems.push_back({ editor ? system->Definition.EditorUpdate : system->Definition.Update, system, {}, 0, 0.0f });
+				graph.Timings.push_back({ system->Definition.Name, 0.0f, 0.0f, system->Definition.Access.Exclusive });
+
+				const SystemAccess& access = system->Definition.Access;
+				if (access.Exclusive || graph.Segments.empty() || graph.Segments.back().Exclusive)
+				{
+					graph.Segments.push_back({ index, index + 1, access.Exclusive });
+					continue;
+				}
+
+				// Every earlier system in the segment that conflicts has to finish first
+				Segment& segment = graph.Segments.back();
+				for (int other = segment.Start; other < index; other++)
+				{
+					if (Conflicts(graph.Systems[other].System->Definition.Access, access))
+					{
+						graph.Systems[other].Dependents.push_back(index);
+						graph.Systems[index].NumDependencies++;
+					}
+				}
+				segment.End = index + 1;
+			}
+
+			graph.PendingDependencies.reset(new std::atomic<int>[graph.Systems.size()]);
+			graph.Dirty = false;
+		}
+
+		static void Run(FrameGraph& graph, SceneData& scene, float dt, bool editor)
+		{
+			if (graph.Dirty)
+			{
+				Build(graph, editor);
+			}
+
+			m_CurrentGraph = &graph;
+			m_CurrentScene = &scene;
+			m_CurrentDt = dt;
+			for (const Segment& segment : graph.Segments)
+			{
+				// Nothing to overlap with, skip the trip through the job system
+				if (segment.Exclusive || segment.End - segment.Start == 1)
+				{
+					RunSystem(graph, segment.Start);
+					continue;
+				}
+
+				JobCounter counter;
+				m_CurrentSegment = &counter;
+				for (int i = segment.Start; i < segment.End; i++)
+				{
+					graph.PendingDependencies[i] = graph.Systems[i].NumDependencies;
+				}
+				for (int i = segment.Start; i < segment.End; i++)
+				{
+					if (graph.Systems[i].NumDependencies == 0)
+					{
+						JobSystem::Run(SystemJob, (void*)(intptr_t)i, &counter);
+					}
+				}
+				JobSystem::Wait(counter);
+				m_CurrentSegment = nullptr;
+			}
+
+			for (int i = 0; i < graph.Systems.size(); i++)
+			{
+				SystemTiming& timing = graph.Timings[i];
+				timing.Milliseconds = graph.Systems[i].Milliseconds;
+				timing.AverageMilliseconds = timing.AverageMilliseconds == 0.0f
+					? timing.Milliseconds
+					: timing.AverageMilliseconds * 0.95f + timing.Milliseconds * 0.05f;
+			}
+			m_LastTimings = &graph.Timings;
+			m_CurrentGraph = nullptr;
+		}
+
+		static void RunSystem(FrameGraph& graph, int index)
+		{
+			ScheduledSystem& system = graph.Systems[index];
+			auto start = std::chrono::high_resolution_clock::now();
+			system.Function(*m_CurrentScene, m_CurrentDt);
+			auto end = std::chrono::high_resolution_clock::now();
+			system.Milliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+		}
+
+		static void SystemJob(void* data, int workerIndex)
+		{
+			int index = (int)(intptr_t)data;
+			FrameGraph& graph = *m_CurrentGraph;
+			RunSystem(graph, index);
+
+			for (int dependent : graph.Systems[index].Dependents)
+			{
+				if (graph.PendingDependencies[dependent].fetch_sub(1) == 1)
+				{
+					JobSystem::Run(SystemJob, (void*)(intptr_t)dependent, m_CurrentSegment);
+				}
+			}
+		}
+	}
+}
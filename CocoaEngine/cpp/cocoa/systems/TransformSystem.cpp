@@ -1,19 +1,55 @@
 #include "cocoa/systems/TransformSystem.h"
 #include "cocoa/components/Transform.h"
 #include "cocoa/components/Tag.h"
+#include "cocoa/util/HashMap.h"
 
 namespace Cocoa
 {
 	namespace TransformSystem
 	{
+		// Internal Variables
+		// Hierarchy the order below was built for. Every change to a parent goes through Transform::SetParent and bumps
+		// the version, entities destroyed along with their hierarchy component shrink the pool. Either one moves
+		// entities around in the pool, so nothing needs to be compared entity by entity to notice it
+		static uint32 m_BuiltVersion = 0;
+		static int m_BuiltSize = -1;
+		// Parent of every entity in the pool, indexed the same way as the pool
+		static std::vector<entt::entity> m_Parents;
+		// Set for children that were cut loose to break a parent cycle
+		static std::vector<bool> m_Detached;
+
+		// Pool indices sorted so every parent comes before its children
+		static std::vector<int> m_Order;
+
+		// Forward Declarations
+		static bool HierarchyChanged(int size);
+		static void BuildOrder(const entt::entity* entities, const TransformHierarchy* hierarchies, int size);
+		static void UnlinkChild(std::vector<int>& firstChild, std::vector<int>& nextSibling, int parent, int child);
+
 		void Update(SceneData& scene, float dt)
 		{
-			auto view = scene.Registry.view<TransformData>();
-			for (entt::entity rawEntity : view)
+			// Only entities in a hierarchy have the component, and roots already hold their world position
+			int size = (int)scene.Registry.size<TransformHierarchy>();
+			const TransformHierarchy* hierarchies = scene.Registry.raw<TransformHierarchy>();
+			const entt::entity* entities = scene.Registry.data<TransformHierarchy>();
+			if (HierarchyChanged(size))
 			{
-				Entity entity = NEntity::CreateEntity(rawEntity);
-				TransformData& transform = NEntity::GetComponent<TransformData>(entity);
-				Transform::Update(transform, dt);
+				BuildOrder(entities, hierarchies, size);
+			}
+
+			for (int index : m_Order)
+			{
+				if (m_Detached[index] || m_Parents[index] == entt::null)
+				{
+					continue;
+				}
+
+				entt::entity parent = m_Parents[index];
+				if (scene.Registry.valid(parent) && scene.Registry.has<TransformData>(parent))
+				{
+					TransformData& transform = scene.Registry.get<TransformData>(entities[index]);
+					transform.Position = scene.Registry.get<TransformData>(parent).Position + hierarchies[index].LocalPosition;
+				}
 			}
 		}
 
@@ -26,6 +62,11 @@ namespace Cocoa
 				Tag& tag = NEntity::GetComponent<Tag>(entity);
 				NTag::Destroy(tag);
 			}
+
+			m_BuiltSize = -1;
+			m_Parents.clear();
+			m_Detached.clear();
+			m_Order.clear();
 		}
 
 		void DeleteEntity(Entity entity)
@@ -36,5 +77,116 @@ namespace Cocoa
 				NTag::Destroy(tag);
 			}
 		}
+
+		// Internal Functions
+		static bool HierarchyChanged(int size)
+		{
+			return size != m_BuiltSize || Transform::GetHierarchyVersion() != m_BuiltVersion;
+		}
+
+		static void UnlinkChild(std::vector<int>& firstChild, std::vector<int>& nextSibling, int parent, int child)
+		{
+			if (firstChild[parent] == child)
+			{
+				firstChild[parent] = nextSibling[child];
+			}
+			else
+			{
+				for (int sibling = firstChild[parent]; sibling != -1; sibling = nextSibling[sibling])
+				{
+					if (nextSibling[sibling] == child)
+					{
+						nextSibling[sibling] = nextSibling[child];
+						break;
+					}
+				}
+			}
+			nextSibling[child] = -1;
+		}
+
+		static void BuildOrder(const entt::entity* entities, const TransformHierarchy* hierarchies, int size)
+		{
+			m_BuiltVersion = Transform::GetHierarchyVersion();
+			m_BuiltSize = size;
+			m_Parents.resize(size);
+			m_Detached.assign(size, false);
+			m_Order.clear();
+			m_Order.reserve(size);
+
+			// Only needed while the order gets built, so it can live on the frame arena
+			HashMap<entt::entity, int> poolIndices = NHashMap::Create<entt::entity, int>(size, AllocatorType::Frame);
+			for (int i = 0; i < size; i++)
+			{
+				NHashMap::Put(poolIndices, entities[i], i);
+			}
+
+			// Children are linked into a list per parent, so the order can be built breadth first starting at the roots
+			std::vector<int> parentIndices(size, -1);
+			std::vector<int> firstChild(size, -1);
+			std::vector<int> nextSibling(size, -1);
+			std::vector<bool> reached(size, false);
+			for (int i = size - 1; i >= 0; i--)
+			{
+				m_Parents[i] = hierarchies[i].Parent.Handle;
+				const int* parentEntry = NHashMap::Get(poolIndices, hierarchies[i].Parent.Handle);
+				int parentIndex = parentEntry ? *parentEntry : -1;
+				if (parentIndex == i)
+				{
+					Log::Warning("Entity %d is its own parent, detaching it.", entt::to_integral(entities[i]));
+					m_Detached[i] = true;
+					parentIndex = -1;
+				}
+
+				parentIndices[i] = parentIndex;
+				if (parentIndex >= 0)
+				{
+					nextSibling[i] = firstChild[parentIndex];
+					firstChild[parentIndex] = i;
+				}
+				else
+				{
+					reached[i] = true;
+					m_Order.push_back(i);
+				}
+			}
+			std::reverse(m_Order.begin(), m_Order.end());
+
+			int next = 0;
+			while (true)
+			{
+				for (; next < m_Order.size(); next++)
+				{
+					for (int child = firstChild[m_Order[next]]; child != -1; child = nextSibling[child])
+					{
+						// Every entity is in exactly one child list, this only guards against walking around a cycle
+						if (!reached[child])
+						{
+							reached[child] = true;
+							m_Order.push_back(child);
+						}
+					}
+				}
+
+				if (m_Order.size() == size)
+				{
+					break;
+				}
+
+				// Anything that wasn't reached is part of a parent cycle, cut it at one entity and keep going from there
+				Log::Warning("Transform hierarchy contains a cycle, detaching one of the entities involved.");
+				for (int i = 0; i < size; i++)
+				{
+					if (!reached[i])
+					{
+						UnlinkChild(firstChild, nextSibling, parentIndices[i], i);
+						parentIndices[i] = -1;
+						m_Detached[i] = true;
+						reached[i] = true;
+						m_Order.push_back(i);
+						break;
+					}
+				}
+			}
+		}
 	}
-}
\ No newline at end of file
+}
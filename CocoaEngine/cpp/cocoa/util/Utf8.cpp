@@ -0,0 +1,65 @@
+#include "externalLibs.h"
+
+#include "cocoa/util/Utf8.h"
+
+namespace Cocoa
+{
+	namespace Utf8
+	{
+		uint32 DecodeNext(const char* str, int length, int& index)
+		{
+			uint8 lead = (uint8)str[index];
+			index++;
+			if (lead < 0x80)
+			{
+				return lead;
+			}
+
+			int numContinuationBytes;
+			uint32 codepoint;
+			uint32 minCodepoint;
+			if ((lead & 0xE0) == 0xC0)
+			{
+				numContinuationBytes = 1;
+				codepoint = lead & 0x1F;
+				minCodepoint = 0x80;
+			}
+			else if ((lead & 0xF0) == 0xE0)
+			{
+				numContinuationBytes = 2;
+				codepoint = lead & 0x0F;
+				minCodepoint = 0x800;
+			}
+			else if ((lead & 0xF8) == 0xF0)
+			{
+				numContinuationBytes = 3;
+				codepoint = lead & 0x07;
+				minCodepoint = 0x10000;
+			}
+			else
+			{
+				// Stray continuation byte or invalid lead byte
+				return ReplacementCharacter;
+			}
+
+			for (int i = 0; i < numContinuationBytes; i++)
+			{
+				if (index >= length || ((uint8)str[index] & 0xC0) != 0x80)
+				{
+					// Truncated sequence, resume decoding at the byte that broke it
+					return ReplacementCharacter;
+				}
+				codepoint = (codepoint << 6) | ((uint8)str[index] & 0x3F);
+				index++;
+			}
+
+			// Overlong encodings, surrogates and anything past the last unicode plane are all invalid
+			if (codepoint < minCodepoint || (codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > 0x10FFFF)
+			{
+				return ReplacementCharacter;
+			}
+
+			return codepoint;
+		}
+	}
+}
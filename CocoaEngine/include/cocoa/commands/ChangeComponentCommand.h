@@ -0,0 +1,70 @@
+#pragma once
+#include "cocoa/commands/ICommand.h"
+#include "cocoa/core/Entity.h"
+
+namespace Cocoa
+{
+    // Changes one field of an entity's component. entt moves components around in their pool when entities enter or leave
+    // a group or get destroyed, so this keeps the entity and the field instead of a reference and looks the component up
+    // every time it runs. Does nothing once the entity or the component is gone
+    template<typename Component, typename T>
+    class ChangeComponentCommand : public ICommand
+    {
+    public:
+        ChangeComponentCommand(Entity entity, T Component::* field, const T& newValue)
+            : m_Entity(entity), m_Field(field), m_NewValue(newValue), m_OldValue()
+        {
+        }
+
+        virtual void execute() override
+        {
+            Component* component = GetComponent();
+            if (component != nullptr)
+            {
+                m_OldValue = component->*m_Field;
+                component->*m_Field = m_NewValue;
+            }
+        }
+
+        virtual void undo() override
+        {
+            Component* component = GetComponent();
+            if (component != nullptr)
+            {
+                component->*m_Field = m_OldValue;
+            }
+        }
+
+        virtual bool mergeWith(ICommand* other) override
+        {
+            ChangeComponentCommand<Component, T>* changeComponentCommand = dynamic_cast<ChangeComponentCommand<Component, T>*>(other);
+            if (changeComponentCommand != nullptr)
+            {
+                if (changeComponentCommand->m_Entity == this->m_Entity && changeComponentCommand->m_Field == this->m_Field)
+                {
+                    changeComponentCommand->m_NewValue = this->m_NewValue;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+
+    private:
+        Component* GetComponent()
+        {
+            SceneData* scene = NEntity::GetScene();
+            if (!scene->Registry.valid(m_Entity.Handle) || !NEntity::HasComponent<Component>(m_Entity))
+            {
+                return nullptr;
+            }
+            return &NEntity::GetComponent<Component>(m_Entity);
+        }
+
+        Entity m_Entity;
+        T Component::* m_Field;
+        T m_NewValue;
+        T m_OldValue;
+    };
+}
@@ -11,6 +11,10 @@ namespace Cocoa {
         virtual void undo() = 0;
         virtual bool mergeWith(ICommand* other) = 0;
 
+        // A command gets created for every edit, so they come out of block pools owned by the engine instead of the heap
+        static void* operator new(size_t size);
+        static void operator delete(void* memory, size_t size);
+
         void SetNoMerge() { m_CanMerge = false; }
         bool CanMerge() const { return m_CanMerge; }
 
@@ -5,6 +5,13 @@
 
 namespace Cocoa
 {
+	enum class TextAlignment : uint8
+	{
+		Left = 0,
+		Center = 1,
+		Right = 2
+	};
+
 	struct FontRenderer
 	{
 		glm::vec4 m_Color = glm::vec4(1, 1, 1, 1);
@@ -12,5 +19,10 @@ namespace Cocoa
 		Handle<Font> m_Font;
 		std::string text;
 		int fontSize;
+
+		// Lines longer than this get wrapped at the last space, 0 disables wrapping. Measured before the transform's scale
+		float m_WrapWidth = 0.0f;
+		TextAlignment m_Alignment = TextAlignment::Left;
+		float m_LineSpacing = 1.0f;
 	};
 }
\ No newline at end of file
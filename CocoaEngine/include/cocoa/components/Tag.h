@@ -14,7 +14,9 @@ namespace Cocoa
 
 	namespace NTag
 	{
-		COCOA Tag CreateTag(const char* name, bool isHeapAllocated = false);
+		// Names that don't outlive the tag have to be copied, copies come from a string block allocator shared by all tags
+		COCOA Tag CreateTag(const char* name, bool copyName = false);
+		COCOA void SetName(Tag& tag, const char* name);
 		COCOA void Destroy(Tag& tag);
 
 		COCOA void Serialize(json& j, Entity entity, const Tag& transform);
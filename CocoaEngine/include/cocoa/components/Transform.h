@@ -10,7 +10,25 @@ namespace Cocoa
 		COCOA TransformData CreateTransform();
 		COCOA TransformData CreateTransform(glm::vec3 position, glm::vec3 scale, glm::vec3 eulerRotation);
 
-		COCOA void Update(TransformData& data, float dt);
+		// Computed from the world position, rotation and scale whenever they're asked for, nothing in the engine needs them every frame
+		COCOA glm::quat GetOrientation(const TransformData& data);
+		COCOA glm::mat4 GetModelMatrix(const TransformData& data);
+		COCOA glm::mat4 GetInverseModelMatrix(const TransformData& data);
+
+		// Returns a null entity for entities without a parent
+		COCOA Entity GetParent(Entity entity);
+		// Keeps the entity's world position and makes it relative to the new parent. Pass a null entity to unparent it.
+		// Parenting an entity to one of its own descendants is refused
+		COCOA void SetParent(Entity entity, Entity parent);
+		// Both return a null entity once there are no more children
+		COCOA Entity GetFirstChild(Entity entity);
+		COCOA Entity GetNextSibling(Entity entity);
+		// Walks up from entity, so this costs the depth of the hierarchy. An entity counts as its own descendant
+		COCOA bool IsDescendantOf(Entity entity, Entity ancestor);
+		// Appends root and everything below it, every parent comes before its children
+		COCOA void GetSubtree(Entity root, std::vector<Entity>& outEntities);
+		// Changes whenever an entity gets or loses a parent, so anything caching the hierarchy knows when to rebuild it
+		COCOA uint32 GetHierarchyVersion();
 
 		COCOA void Serialize(json& j, Entity entity, const TransformData& transform);
 		COCOA void Deserialize(const json& j, Entity entity, Entity parent = NEntity::CreateNull());
@@ -4,16 +4,23 @@
 
 namespace Cocoa
 {
+	// Everything physics and rendering touch every frame, kept small so iterating it doesn't drag matrices through the cache.
+	// Position is the world position, for children the transform system derives it from the parent every update
 	struct TransformData
 	{
 		glm::vec3 Position;
 		glm::vec3 Scale;
 		glm::vec3 EulerRotation;
-		glm::quat Orientation;
+	};
 
-		glm::mat4 ModelMatrix;
-		glm::mat4 InverseModelMatrix;
-		glm::vec3 LocalPosition;
+	// Only entities that have a parent or children get this component. Children of an entity form a doubly linked list,
+	// so walking a subtree only touches the entities in it. Use Transform::SetParent to change it, never the links directly
+	struct TransformHierarchy
+	{
 		Entity Parent;
+		Entity FirstChild;
+		Entity NextSibling;
+		Entity PrevSibling;
+		glm::vec3 LocalPosition;
 	};
 }
\ No newline at end of file
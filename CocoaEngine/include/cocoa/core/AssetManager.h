@@ -23,9 +23,16 @@ namespace Cocoa
 		static Handle<Texture> LoadTextureFromFile(Texture& texture, const CPath& path, int id = -1);
 		static Handle<Texture> GetTexture(const CPath& path);
 		static const Texture& GetTexture(uint32 resourceId);
+		// The path of the texture in the slot, even while GetTexture still resolves it to the streaming placeholder
+		static const CPath& GetTexturePath(uint32 resourceId);
+		// Registers a texture that was generated at runtime and has no file behind it. It can't be looked up by path,
+		// never gets serialized and is deleted with the rest of the textures on Clear
+		static Handle<Texture> AddRuntimeTexture(Texture& texture);
 
 		static Handle<Font> LoadFontFromJson(const CPath& path, const json& j, bool isDefault = false, int id = -1);
 		static Handle<Font> LoadFontFromTtfFile(const CPath& fontFile, int fontSize, const CPath& outputFile, int glyphRangeStart, int glyphRangeEnd, int padding, int upscaleResolution);
+		// Registers a font whose sdf was already generated with Font::GenerateSdf, for example on a background thread
+		static Handle<Font> LoadGeneratedFont(Font& font, const CPath& fontTextureFile);
 		static Handle<Font> GetFont(const CPath& path);
 		static const Font& GetFont(uint32 resourceId);
 
@@ -39,6 +46,8 @@ namespace Cocoa
 
 		static void Clear();
 		static void Init(uint32 scene);
+		// Frees the asset indices. Clear the assets first, nothing may use the asset manager after this
+		static void Destroy();
 
 		static const std::vector<Texture>& GetAllTextures() { return s_Textures; }
 		static const std::vector<Font>& GetAllFonts() { return s_Fonts; }
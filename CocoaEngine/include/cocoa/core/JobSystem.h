@@ -0,0 +1,51 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+#include <atomic>
+
+namespace Cocoa
+{
+	typedef void (*JobFunction)(void* data, int workerIndex);
+
+	// Counts the jobs that still have to finish. Jobs that other work depends on share a counter,
+	// and the dependent work waits for it to reach zero
+	struct JobCounter
+	{
+		std::atomic<int> Value{ 0 };
+	};
+
+	// Every worker owns a work stealing deque. Jobs get pushed onto the deque of the thread that kicks them off,
+	// the owner pops from the bottom so it keeps working on the data it just touched and idle workers steal from the top.
+	// Threads that aren't part of the pool push their jobs onto a shared queue instead
+	namespace JobSystem
+	{
+		// Starts the shared worker threads. Pass -1 to size the pool from the number of cores.
+		// The calling thread becomes the main thread and gets its own deque as well
+		COCOA void Init(int numWorkers = -1);
+		COCOA void Destroy();
+
+		COCOA int NumWorkers();
+
+		// Queues function(data, workerIndex) and increments counter, which gets decremented once the job finished.
+		// data has to stay alive until then. Counter may be null for jobs nothing waits on
+		COCOA void Run(JobFunction function, void* data, JobCounter* counter = nullptr);
+
+		// Same as Run, but the job never lands on the caller's deque. It goes onto a queue that only the workers take from,
+		// and only once they ran out of other work, so the main thread never picks it up while it waits on frame work.
+		// Meant for jobs that block for a long time, like reading and decoding files
+		COCOA void RunInBackground(JobFunction function, void* data, JobCounter* counter = nullptr);
+
+		// Blocks until counter reaches zero. Workers and the main thread run other jobs while they wait, so it's
+		// fine to wait from inside a job. Any other thread just sleeps
+		COCOA void Wait(JobCounter& counter);
+
+		// Runs task(taskIndex, workerIndex) for every taskIndex in [0, numTasks) and waits until all of them finished.
+		// Tasks are handed out grainSize at a time, idle workers grab the next ones as soon as they are done with theirs,
+		// so uneven task costs balance out. workerIndex is in [0, NumWorkers()] and is unique among the threads running
+		// at the same time, which makes it usable to index per thread scratch data. NumWorkers() is the main thread.
+		// NOTE: A task that waits on other jobs can end up running another task with the same workerIndex in the meantime,
+		//       so don't hold on to per thread scratch data across a nested ParallelFor or Wait
+		COCOA void ParallelFor(int numTasks, const std::function<void(int taskIndex, int workerIndex)>& task, int grainSize = 1);
+	};
+}
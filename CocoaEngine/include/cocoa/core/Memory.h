@@ -1,12 +1,38 @@
 #pragma once
 #include "cocoa/core/Core.h"
 
+#include <cstddef>
+#include <vector>
+
 #define AllocMem(numBytes) Cocoa::Memory::_Allocate(__FILE__, __LINE__, numBytes)
 #define ReallocMem(memory, newSize) Cocoa::Memory::_Realloc(__FILE__, __LINE__, memory, newSize)
 #define FreeMem(memory) Cocoa::Memory::_Free(__FILE__, __LINE__, memory)
 
 namespace Cocoa
 {
+	struct ArenaStats
+	{
+		size_t Capacity;
+		size_t Used;
+		// The most memory that was in use at once, including allocations that didn't fit into the capacity
+		size_t HighWaterMark;
+	};
+
+	// Everything allocated through AllocMem and ReallocMem at one file and line. Only tracked in debug builds
+	struct AllocationCallsite
+	{
+		const char* Filename;
+		int Line;
+		size_t LiveBytes;
+		size_t PeakBytes;
+		int LiveAllocations;
+		uint64 TotalAllocations;
+		// How many blocks were allocated and freed during the last frame, callsites that churn a lot every frame
+		// are good candidates for FrameAlloc or a ScratchScope
+		int AllocationsLastFrame;
+		int FreesLastFrame;
+	};
+
 	namespace Memory
 	{
 		COCOA void* _Allocate(const char* filename, int line, size_t numBytes);
@@ -14,5 +40,61 @@ namespace Cocoa
 		COCOA void _Free(const char* filename, int line, void* memory);
 		COCOA void Init();
 		COCOA void Destroy();
+
+		// Bump allocates out of an arena that gets reset after Application::EndFrame, so the memory is valid until the end
+		// of the current frame and never has to be freed. Safe to call from any thread. When a frame needs more than the
+		// arena holds, the rest comes from the heap and the arena grows to fit it on the next reset
+		COCOA void* FrameAlloc(size_t numBytes, size_t alignment = 16);
+		// Same as FrameAlloc, but the memory stays valid until the end of the next frame
+		COCOA void* DoubleBufferedFrameAlloc(size_t numBytes, size_t alignment = 16);
+		COCOA void EndFrame();
+
+		template<typename T>
+		T* FrameAlloc(int count)
+		{
+			return (T*)FrameAlloc(sizeof(T) * count, alignof(T));
+		}
+
+		template<typename T>
+		T* DoubleBufferedFrameAlloc(int count)
+		{
+			return (T*)DoubleBufferedFrameAlloc(sizeof(T) * count, alignof(T));
+		}
+
+		COCOA ArenaStats GetFrameArenaStats();
+		COCOA ArenaStats GetDoubleBufferedArenaStats();
+		// Capacity is summed up over the scratch stacks of all threads and the high water mark is the deepest any of them
+		// got. Used is only for the calling thread
+		COCOA ArenaStats GetScratchStats();
+
+		// Fills outCallsites with every callsite that allocated memory so far, the ones holding on to the most memory come
+		// first. Always empty in release builds
+		COCOA void GetAllocationCallsites(std::vector<AllocationCallsite>& outCallsites);
 	}
+
+	// Allocates function local temporaries from a stack owned by the calling thread, everything allocated through the
+	// scope is released at once when it goes out of scope. Scopes nest, so functions called inside a scope can open
+	// their own. Don't hand the memory to other threads or keep it around after the scope ended
+	class COCOA ScratchScope
+	{
+	public:
+		ScratchScope();
+		~ScratchScope();
+
+		ScratchScope(const ScratchScope&) = delete;
+		ScratchScope& operator=(const ScratchScope&) = delete;
+
+		void* Alloc(size_t numBytes, size_t alignment = 16);
+
+		template<typename T>
+		T* Alloc(int count)
+		{
+			return (T*)Alloc(sizeof(T) * count, alignof(T));
+		}
+
+	private:
+		size_t m_Marker;
+		// Allocations that didn't fit on the stack, chained through a pointer at the start of each block
+		void* m_Overflow;
+	};
 }
\ No newline at end of file
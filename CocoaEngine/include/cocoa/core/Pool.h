@@ -0,0 +1,73 @@
+#pragma once
+#include "cocoa/core/Core.h"
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace Cocoa
+{
+	// Fixed size blocks carved out of chunks that are only given back when the pool is freed. Freed blocks go onto a
+	// free list and get reused first, so small objects that come and go all the time neither hit the heap nor fragment it.
+	// In debug builds freed blocks are filled with a pattern that gets checked when they're handed out again, which
+	// catches writes through dangling pointers. Not thread safe
+	struct BlockPool
+	{
+		void* FreeList;
+		void* Chunks;
+		uint32 BlockSize;
+		int BlocksPerChunk;
+		int NumAllocated;
+		int NumBlocks;
+		bool PoisonFreedBlocks;
+	};
+
+	namespace NBlockPool
+	{
+		// Doesn't allocate anything until the first block is needed, so it's fine to create pools during static initialization
+		COCOA BlockPool Create(size_t blockSize, int blocksPerChunk = 64, bool poisonFreedBlocks = true);
+		COCOA void Free(BlockPool& pool);
+
+		COCOA void* AllocateBlock(BlockPool& pool);
+		COCOA void FreeBlock(BlockPool& pool, void* block);
+	}
+
+	template<typename T>
+	struct Pool
+	{
+		BlockPool Blocks;
+	};
+
+	namespace NPool
+	{
+		template<typename T>
+		Pool<T> Create(int objectsPerChunk = 64, bool poisonFreedBlocks = true)
+		{
+			static_assert(alignof(T) <= 16, "Pools only align objects to 16 bytes.");
+			return { NBlockPool::Create(sizeof(T), objectsPerChunk, poisonFreedBlocks) };
+		}
+
+		// Objects that are still alive don't get destructed, only their memory goes away
+		template<typename T>
+		void Free(Pool<T>& pool)
+		{
+			NBlockPool::Free(pool.Blocks);
+		}
+
+		template<typename T, typename... Args>
+		T* New(Pool<T>& pool, Args&&... args)
+		{
+			return new (NBlockPool::AllocateBlock(pool.Blocks)) T(std::forward<Args>(args)...);
+		}
+
+		template<typename T>
+		void Delete(Pool<T>& pool, T* object)
+		{
+			if (object)
+			{
+				object->~T();
+				NBlockPool::FreeBlock(pool.Blocks, object);
+			}
+		}
+	}
+}
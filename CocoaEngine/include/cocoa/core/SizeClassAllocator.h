@@ -0,0 +1,45 @@
+#pragma once
+#include "cocoa/core/Core.h"
+
+#include <cstddef>
+
+namespace Cocoa
+{
+	struct SizeClassAllocatorStats
+	{
+		// Memory taken from the OS for slabs and for allocations too large for any size class
+		size_t SlabBytes;
+		size_t LargeBytes;
+		// Freed large allocations that are kept around to be reused
+		size_t CachedSpanBytes;
+		// Size of the slab blocks currently handed out, the rest of SlabBytes sits in free lists
+		size_t UsedBlockBytes;
+		// What callers asked for compared to the blocks they got, the difference is lost to rounding up to a size class
+		uint64 TotalRequestedBytes;
+		uint64 TotalBlockBytes;
+		uint64 NumAllocations;
+		uint64 NumFrees;
+		uint64 NumLargeAllocations;
+		// How often a thread cache went to the shared pools, every trip moves a whole batch of blocks
+		uint64 NumBatchTransfers;
+	};
+
+	// General purpose allocator that AllocMem uses when the engine is built with --engine-allocator. Small sizes get
+	// rounded up to one of a few size classes and are carved out of 64KB slabs. Every thread keeps a cache of free blocks
+	// per size class, so most allocations and frees never take a lock, and moves blocks to and from the shared pools
+	// in batches. Anything larger than the biggest size class gets its own pages from the OS, the smaller ones of those are
+	// kept around for reuse once they're freed
+	namespace SizeClassAllocator
+	{
+		COCOA void* Allocate(size_t numBytes);
+		COCOA void* Reallocate(void* memory, size_t numBytes);
+		COCOA void Free(void* memory);
+
+		// Gives the slabs back to the OS, but only if nothing allocated from them is still alive
+		COCOA void Destroy();
+
+		// Every thread flushes its counters when it trades a batch with the shared pools, so the numbers can lag behind
+		// by a batch per thread
+		COCOA SizeClassAllocatorStats GetStats();
+	};
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "cocoa/core/Core.h"
+#include "cocoa/core/Pool.h"
+
+namespace Cocoa
+{
+	// Owns copies of short strings like entity names. Every string is rounded up to one of a few block sizes and comes
+	// out of the block pool for that size, anything longer than the largest block goes to AllocMem. Not thread safe
+	struct StringBlockAllocator
+	{
+		static const int NumBlockSizes = 5;
+		BlockPool Pools[NumBlockSizes];
+	};
+
+	namespace NStringBlockAllocator
+	{
+		COCOA StringBlockAllocator Create();
+		COCOA void Free(StringBlockAllocator& allocator);
+
+		// length doesn't include the null terminator, which the copy always gets
+		COCOA char* CopyString(StringBlockAllocator& allocator, const char* str, int length);
+		// Needs the same length the string was copied with, that's how the block size is found
+		COCOA void FreeString(StringBlockAllocator& allocator, const char* str, int length);
+	}
+}
@@ -3,6 +3,7 @@
 #include "externalLibs.h"
 #include "cocoa/core/Core.h"
 #include "CPath.h"
+#include "cocoa/file/PathId.h"
 
 #include <thread>
 #ifdef _WIN32
@@ -36,10 +37,11 @@ namespace Cocoa
 		void Stop();
 
 	public:
-		typedef void (*OnChanged)(const CPath& file);
-		typedef void (*OnRenamed)(const CPath& file);
-		typedef void (*OnDeleted)(const CPath& file);
-		typedef void (*OnCreated)(const CPath& file);
+		// Called from the watcher thread with the absolute path of the file
+		typedef void (*OnChanged)(PathId file);
+		typedef void (*OnRenamed)(PathId file);
+		typedef void (*OnDeleted)(PathId file);
+		typedef void (*OnCreated)(PathId file);
 
 		OnChanged m_OnChanged = nullptr;
 		OnRenamed m_OnRenamed = nullptr;
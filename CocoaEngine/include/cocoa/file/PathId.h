@@ -0,0 +1,63 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+#include "cocoa/file/CPath.h"
+
+namespace Cocoa
+{
+	// Refers to a path in the path table. Paths get normalized to absolute paths and are stored exactly once, so two
+	// PathIds point to the same path exactly when their ids match. Ids stay valid until NPathId::Destroy, 0 is the null id
+	struct PathId
+	{
+		uint32 Id;
+	};
+
+	inline bool operator==(PathId a, PathId b)
+	{
+		return a.Id == b.Id;
+	}
+
+	inline bool operator!=(PathId a, PathId b)
+	{
+		return a.Id != b.Id;
+	}
+
+	// Interning and lookups are thread safe. Looking at an interned path never locks or allocates
+	namespace NPathId
+	{
+		inline PathId CreateNull()
+		{
+			return { 0 };
+		}
+
+		inline bool IsNull(PathId path)
+		{
+			return path.Id == 0;
+		}
+
+		// Adds the path to the table if it isn't in there yet. Relative paths are resolved against the current working
+		// directory, '.' and '..' get collapsed and separators are unified. Empty paths return the null id
+		COCOA PathId Intern(const CPath& path);
+		COCOA PathId Intern(const char* path, int length);
+		// Same as Intern, but returns the null id for paths that were never interned instead of adding them
+		COCOA PathId Find(const CPath& path);
+		// Appends relativePath to directory, so this never has to go through the current working directory
+		COCOA PathId Join(PathId directory, const char* relativePath, int length);
+		COCOA PathId Join(PathId directory, const char* relativePath);
+		// The null id for roots like 'C:\'
+		COCOA PathId Parent(PathId path);
+
+		// These point into the table and stay valid as long as the id does. They are null terminated
+		COCOA const char* Filepath(PathId path);
+		COCOA int Size(PathId path);
+		COCOA const char* Filename(PathId path);
+		COCOA int FilenameSize(PathId path);
+		COCOA const char* FileExt(PathId path);
+		COCOA int FileExtSize(PathId path);
+
+		COCOA CPath ToCPath(PathId path);
+
+		// Frees the table, nothing may use a PathId after this
+		COCOA void Destroy();
+	}
+}
@@ -17,6 +17,15 @@ namespace Cocoa
 		COCOA void DrawBottomBatches(const Camera& camera);
 		COCOA void DrawTopBatches(const Camera& camera);
 
+		// Draws an infinite grid behind everything else this frame. Grid lines sit halfway between
+		// cells, and every majorLineEvery'th line stays visible after the minor lines fade out when zoomed out
+		COCOA void AddGrid2D(
+			const glm::vec2& gridSize,
+			float strokeWidth = 1.0f,
+			const glm::vec3& color = { 0.0f, 0.0f, 0.0f },
+			int majorLineEvery = 10
+		);
+
 		COCOA void AddLine2D(
 			glm::vec2& from,
 			glm::vec2& to,
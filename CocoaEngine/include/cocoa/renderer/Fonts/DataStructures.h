@@ -1,7 +1,15 @@
 #pragma once
+#include "cocoa/core/Core.h"
 
 namespace Cocoa
 {
+	// Msdf atlases store three distances per texel, the median of them keeps sharp corners at much smaller glyph sizes
+	enum class DistanceFieldType
+	{
+		Sdf = 0,
+		Msdf
+	};
+
 	struct CharInfo
 	{
 		float ux0, uy0;
@@ -11,6 +19,14 @@ namespace Cocoa
 		float chScaleX, chScaleY;
 	};
 
+	// Amount is in the same units as CharInfo::advance
+	struct KerningPair
+	{
+		uint32 Left;
+		uint32 Right;
+		float Amount;
+	};
+
 	struct SdfBitmapContainer
 	{
 		int width, height;
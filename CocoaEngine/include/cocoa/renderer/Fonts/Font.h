@@ -4,6 +4,8 @@
 #include "cocoa/core/Handle.h"
 #include "cocoa/renderer/Texture.h"
 
+#include <atomic>
+
 namespace Cocoa
 {
 	class COCOA Font
@@ -13,7 +15,9 @@ namespace Cocoa
 		Font();
 
 		const CharInfo& GetCharacterInfo(int codepoint) const;
-		void GenerateSdf(const CPath& fontFile, int fontSize, const CPath& outputFile, int glyphRangeStart = 0, int glyphRangeEnd = 'z' + 1, int padding = 5, int upscaleResolution = 4096);
+		float GetKerning(uint32 left, uint32 right) const;
+		void GenerateSdf(const CPath& fontFile, int fontSize, const CPath& outputFile, int glyphRangeStart = 0, int glyphRangeEnd = 'z' + 1, int padding = 5, int upscaleResolution = 4096,
+			std::atomic<int>* glyphsCompleted = nullptr, DistanceFieldType fieldType = DistanceFieldType::Sdf);
 		void Free();
 
 		inline bool IsNull() const { return m_IsNull; }
@@ -22,16 +26,34 @@ namespace Cocoa
 		json Serialize() const;
 		void Deserialize(const json& j);
 
+		// The glyph metrics live in a binary file next to the font texture instead of the scene json,
+		// so a font loads with one file read no matter how many glyphs it has
+		bool WriteMetrics(const CPath& metricsFile) const;
+		bool ReadMetrics(const CPath& metricsFile);
+
+		static CPath GetMetricsPath(const CPath& fontTextureFile);
+
 	public:
 		static Font nullFont;
 		static CharInfo nullCharacter;
 
 		CPath m_Path;
+		CPath m_MetricsPath;
 		Handle<Texture> m_FontTexture;
 		CharInfo* m_CharacterMap = nullptr;
 		int m_CharacterMapSize = 0;
 		int m_GlyphRangeStart = 0;
 		int m_GlyphRangeEnd = 0;
+
+		// Generation settings, glyphs outside of the baked range get rasterized with these by the glyph cache
+		int m_FontSize = 32;
+		int m_Padding = 5;
+		int m_UpscaleResolution = 4096;
+		DistanceFieldType m_FieldType = DistanceFieldType::Sdf;
+
+		// Layout metrics, in the same units as CharInfo::advance
+		float m_LineHeight = 1.2f;
+		std::unordered_map<uint64, float> m_Kerning;
 		bool m_IsDefault;
 		bool m_IsNull = false;
 	};
@@ -5,6 +5,7 @@
 #include "DataStructures.h"
 #include "cocoa/file/CPath.h"
 
+#include <atomic>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
@@ -18,7 +19,21 @@ namespace Cocoa
 
 		COCOA SdfBitmapContainer GenerateSdfCodepointBitmap(int codepoint, FT_Face font, int fontSize, int padding = 5, int upscaleResolution = 4096, bool flipVertically = false);
 
+		// Same layout and metrics as GenerateSdfCodepointBitmap, but the bitmap has three channels per pixel and the distances
+		// are computed from the glyph outline instead of a rasterized upscaled bitmap
+		COCOA SdfBitmapContainer GenerateMsdfCodepointBitmap(int codepoint, FT_Face font, int fontSize, int padding = 5, int upscaleResolution = 4096);
+
+		// Fills in the advance, bearing and size of a glyph the same way GenerateSdfCodepointBitmap measures them, without
+		// rendering anything. The texture coordinates are left at 0. Returns false if the font has no such glyph
+		COCOA bool GetGlyphMetrics(int codepoint, FT_Face font, CharInfo& outCharInfo);
+
+		// Reads the line height and the kerning between every pair of glyphs in [glyphRangeStart, glyphRangeEnd). Only pairs
+		// with a non zero kerning are returned
+		COCOA void GetLayoutMetrics(const CPath& fontFile, int glyphRangeStart, int glyphRangeEnd, float& outLineHeight, std::vector<KerningPair>& outKerningPairs);
+
+		// Generates the glyphs [glyphOffset, glyphOffset + characterMapSize) on the job system. If glyphsCompleted is set, it gets
+		// incremented after every finished glyph so another thread can report progress
 		COCOA void CreateSdfFontTexture(const CPath& fontFile, int fontSize, CharInfo* characterMap, int characterMapSize, const CPath& outputFile, 
-			int padding = 5, int upscaleResolution = 4096, int glyphOffset = 0);
+			int padding = 5, int upscaleResolution = 4096, int glyphOffset = 0, std::atomic<int>* glyphsCompleted = nullptr, DistanceFieldType fieldType = DistanceFieldType::Sdf);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+#include "cocoa/core/Handle.h"
+#include "cocoa/renderer/Texture.h"
+#include "cocoa/renderer/fonts/DataStructures.h"
+
+namespace Cocoa
+{
+	class Font;
+
+	// Glyphs outside of a font's baked range are rasterized on demand into a set of shared single channel atlas pages.
+	// Every page is split into fixed size cells, one glyph per cell, and once memoryBudget bytes of pages exist the
+	// least recently used glyph gets evicted to make room for a new one
+	namespace GlyphCache
+	{
+		COCOA void Init(int memoryBudget = 4 * 1024 * 1024);
+		COCOA void Destroy();
+
+		// Moves glyphs that finished rasterizing into the atlas pages. This must be called from the thread that owns
+		// the GL context, before any text is batched for the frame, so no glyph is evicted while a batch still uses it
+		COCOA void Update();
+
+		// Forgets every glyph and page. Called when the asset manager clears its textures, which deletes the pages
+		COCOA void Clear();
+
+		// Fills in the glyph and the page it lives on if it's resident and marks it as recently used. Otherwise the glyph
+		// gets queued for rasterization and this returns false until an Update after it has finished
+		COCOA bool GetGlyph(Handle<Font> font, uint32 codepoint, CharInfo& outCharInfo, Handle<Texture>& outPage);
+
+		// Fills in the glyph's advance, bearing and size even while it's still being rasterized, so text can be laid out
+		// before its quads can be drawn. Returns false if the font file can't be read
+		COCOA bool GetGlyphMetrics(Handle<Font> font, uint32 codepoint, CharInfo& outCharInfo);
+
+		// Upper bound on how many pages text can reference, the batches make sure they have a texture slot for each
+		COCOA int MaxPages();
+		COCOA int NumPages();
+		COCOA Handle<Texture> GetPage(int index);
+	};
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+#include "cocoa/components/FontRenderer.h"
+
+namespace Cocoa
+{
+	struct LaidOutGlyph
+	{
+		uint32 Codepoint;
+		// Pen position on the baseline, relative to the text's origin and before the transform's scale
+		glm::vec2 Position;
+	};
+
+	struct TextLayoutData
+	{
+		std::vector<LaidOutGlyph> Glyphs;
+		int NumLines;
+		glm::vec2 Size;
+	};
+
+	// Breaks text into lines and positions every glyph, applying kerning, wrapping and alignment. Layouts are cached by
+	// the text and the layout parameters, so text that doesn't change is only laid out once
+	namespace TextLayout
+	{
+		// Returns the cached layout if there is one, otherwise lays the text out. The reference is valid until the next Update
+		COCOA const TextLayoutData& Get(const FontRenderer& fontRenderer);
+
+		// Drops layouts that haven't been used for a while. Called once per frame, before any text is batched
+		COCOA void Update();
+
+		COCOA void Clear();
+	};
+}
@@ -31,6 +31,10 @@ namespace Cocoa
 		COCOA void ClearColorAttachmentUint32(const Framebuffer& framebuffer, int colorAttachment, uint32 clearColor);
 		COCOA uint32 ReadPixelUint32(const Framebuffer& framebuffer, int colorAttachment, int x, int y);
 
+		// Routes fragment output n to attachment n for the given attachment only, outputs to every other attachment
+		// get dropped. The framebuffer must be bound
+		COCOA void DrawToAttachment(const Framebuffer& framebuffer, int colorAttachment);
+
 		COCOA void Bind(const Framebuffer& framebuffer);
 		COCOA void Unbind(const Framebuffer& framebuffer);
 	};
@@ -62,6 +62,8 @@ namespace Cocoa
         COCOA bool HasRoom(const RenderBatchData& data, int numVertices=4);
         COCOA bool HasRoom(const RenderBatchData& data, const FontRenderer& fontRenderer);
         COCOA bool HasTextureRoom(const RenderBatchData& data);
+        // Text can reference the font texture and any of the glyph cache pages
+        COCOA bool HasTextureRoom(const RenderBatchData& data, const FontRenderer& fontRenderer);
 
         COCOA bool Compare(const RenderBatchData& b1, const RenderBatchData& b2);
 
@@ -8,7 +8,12 @@ namespace Cocoa
 	{
 		None=0,
 		Linear,
-		Nearest
+		Nearest,
+
+		// Mipmapped filters are only valid for the min filter. Textures using them get a full mip chain
+		// generated when their pixels are uploaded
+		LinearMipmapLinear,
+		NearestMipmapNearest
 	};
 
 	enum class WrapMode
@@ -30,7 +35,11 @@ namespace Cocoa
 		RED_INTEGER,
 
 		// Depth/Stencil formats
-		DEPTH24_STENCIL8
+		DEPTH24_STENCIL8,
+
+		// Single channel formats are appended so serialized textures keep their existing integer values
+		RED,
+		R8
 	};
 
 	struct COCOA Texture
@@ -49,6 +58,9 @@ namespace Cocoa
 
 		CPath Path = CPath();
 		bool IsDefault = false;
+
+		// Set while the image is still being decoded/uploaded by the TextureStreamer
+		bool IsStreaming = false;
 	};
 
 	namespace TextureUtil
@@ -72,7 +84,14 @@ namespace Cocoa
 		// Allocates memory space on the GPU according to the texture specifications listed here
 		COCOA void Generate(Texture& texture);
 
+		// Picks the 8 bit internal/external format for an image with 1, 3 or 4 channels. Returns false for anything else
+		COCOA bool SetFormatFromChannels(Texture& texture, int channels);
+
 		COCOA bool IsNull(const Texture& texture);
+		COCOA bool UsesMipmaps(const Texture& texture);
+
+		// Builds the mip chain for the currently bound texture if its min filter samples mipmaps
+		COCOA void GenerateMipmaps(const Texture& texture);
 
 		COCOA uint32 ToGl(ByteFormat format);
 		COCOA uint32 ToGl(WrapMode wrapMode);
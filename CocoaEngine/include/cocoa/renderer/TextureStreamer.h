@@ -0,0 +1,28 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+#include "cocoa/file/CPath.h"
+#include "cocoa/renderer/Texture.h"
+
+namespace Cocoa
+{
+	namespace TextureStreamer
+	{
+		COCOA void Init();
+		COCOA void Destroy();
+
+		// Decodes the image as a job on the job system. Until the pixels have been uploaded, the texture at resourceId
+		// is flagged as streaming and AssetManager::GetTexture resolves it to the placeholder texture
+		COCOA void Queue(uint32 resourceId, const CPath& path);
+
+		// Uploads decoded images through pixel buffer objects until byteBudget bytes have been uploaded this frame.
+		// At least one image is uploaded per call, so images larger than the budget still make progress.
+		// This must be called from the thread that owns the GL context
+		COCOA void Update(int byteBudget = 8 * 1024 * 1024);
+
+		// Drops every request that hasn't been uploaded yet. Called when the asset manager clears its textures
+		COCOA void CancelAll();
+
+		COCOA const Texture& GetPlaceholder();
+	};
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/scenes/SceneData.h"
+#include "cocoa/components/TransformStruct.h"
+#include "cocoa/components/SpriteRenderer.h"
+#include "cocoa/components/FontRenderer.h"
+#include "cocoa/physics2d/PhysicsComponents.h"
+
+namespace Cocoa
+{
+	// entt groups keep the pools they own packed in the same order, so the hot loops walk those pools front to back instead of
+	// looking up every entity in the other pool. A pool can only be owned by one group, TransformData goes to the sprites since
+	// there are the most of them. Fonts and rigidbodies only own their own pool and still look up the transform.
+	// Owned pools get reordered whenever an entity enters or leaves a group, so editor undo commands for these components
+	// keep the entity instead of a reference, see ChangeComponentCommand.
+	// Always get the groups through these functions, asking entt for a group over the same types with different
+	// template arguments asserts
+	namespace ComponentGroups
+	{
+		inline auto Sprites(SceneData& scene)
+		{
+			return scene.Registry.group<TransformData, SpriteRenderer>();
+		}
+
+		inline auto Fonts(SceneData& scene)
+		{
+			return scene.Registry.group<FontRenderer>(entt::get<TransformData>);
+		}
+
+		inline auto Rigidbodies(SceneData& scene)
+		{
+			return scene.Registry.group<Rigidbody2D>(entt::get<TransformData>);
+		}
+
+		// Creating a group has to rearrange the pools it owns, so create them while the registry is still empty.
+		// Owned pools get reordered whenever an entity enters or leaves the group, don't keep references across that
+		inline void Init(SceneData& scene)
+		{
+			Sprites(scene);
+			Fonts(scene);
+			Rigidbodies(scene);
+		}
+	}
+}
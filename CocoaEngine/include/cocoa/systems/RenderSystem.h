@@ -21,7 +21,11 @@ namespace Cocoa
 
 		COCOA void AddEntity(const TransformData& transform, const FontRenderer& fontRenderer);
 		COCOA void AddEntity(const TransformData& transform, const SpriteRenderer& spr);
-		COCOA void Render(const SceneData& scene);
+		COCOA void Render(SceneData& scene);
+
+		// The main pass only writes color. This renders the entity ids into the main framebuffer's id attachment, restricted to the
+		// pixel at x, y, and returns the id found there. x and y are in main framebuffer pixels
+		COCOA uint32 PickEntityId(SceneData& scene, int x, int y);
 		COCOA const Framebuffer& GetMainFramebuffer();
 
 		COCOA void Serialize(json& j, Entity entity, const SpriteRenderer& spriteRenderer);
@@ -5,6 +5,7 @@
 #include "cocoa/scenes/Scene.h"
 #include "cocoa/core/Entity.h"
 #include "cocoa/scenes/SceneData.h"
+#include "cocoa/systems/SystemScheduler.h"
 
 namespace Cocoa
 {
@@ -17,6 +18,7 @@ namespace Cocoa
     typedef void (*InitImGuiFn)(void*);
     typedef void (*ImGuiFn)(entt::registry&, Entity);
     typedef void (*DeleteScriptsFn)();
+    typedef void (*RegisterScriptSystemsFn)(std::vector<SystemDefinition>&);
 
     namespace ScriptSystem
     {
@@ -0,0 +1,108 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+#include "cocoa/scenes/SceneData.h"
+#include "cocoa/util/CMath.h"
+
+namespace Cocoa
+{
+	typedef void (*SystemFn)(SceneData& scene, float dt);
+
+	// The component types a system touches. Two systems conflict if one of them writes a type the other one reads or
+	// writes. Conflicting systems run one after the other in their registered order, everything else may run at the same
+	// time on the job system. Systems that can't tell what they touch are exclusive, they run on the calling thread while
+	// nothing else is running
+	struct SystemAccess
+	{
+		std::vector<uint32> Reads;
+		std::vector<uint32> Writes;
+		bool Exclusive = false;
+
+		// Types are identified by name so the ids match between the engine and the script module
+		template<typename Type>
+		static uint32 TypeId()
+		{
+			return CMath::HashString(typeid(Type).name());
+		}
+
+		template<typename... Components>
+		SystemAccess& Read()
+		{
+			(Reads.push_back(TypeId<Components>()), ...);
+			return *this;
+		}
+
+		template<typename... Components>
+		SystemAccess& Write()
+		{
+			(Writes.push_back(TypeId<Components>()), ...);
+			return *this;
+		}
+	};
+
+	struct SystemDefinition
+	{
+		std::string Name;
+		// Systems run in ascending order, ties are broken by the order they were registered in
+		int Order;
+		SystemFn Update;
+		// Runs instead of Update while the scene isn't playing, null if the system doesn't run in the editor
+		SystemFn EditorUpdate;
+		SystemAccess Access;
+	};
+
+	struct SystemTiming
+	{
+		std::string Name;
+		float Milliseconds;
+		float AverageMilliseconds;
+		bool Exclusive;
+	};
+
+	namespace SystemOrder
+	{
+		constexpr int Transform = 0;
+		constexpr int Physics = 100;
+		constexpr int Scripts = 200;
+		constexpr int Camera = 300;
+	}
+
+	namespace SystemScheduler
+	{
+		// Systems that aren't exclusive must not create or destroy entities or add or remove components, other systems
+		// may be iterating the registry at the same time. Don't register or unregister systems during an update
+		COCOA uint32 Register(const SystemDefinition& system);
+		COCOA void Unregister(uint32 systemId);
+		COCOA void Clear();
+
+		COCOA void Update(SceneData& scene, float dt);
+		COCOA void EditorUpdate(SceneData& scene, float dt);
+
+		// How long every system took during the last Update or EditorUpdate, in the order they were scheduled in
+		COCOA const std::vector<SystemTiming>& GetTimings();
+
+		template<typename T, typename = void>
+		struct DeclaresAccess : std::false_type {};
+
+		template<typename T>
+		struct DeclaresAccess<T, std::void_t<decltype(T::DeclareAccess(std::declval<SystemAccess&>()))>> : std::true_type {};
+
+		// Script classes opt into running in parallel by adding a static void DeclareAccess(SystemAccess& access) that
+		// lists every component their Update touches. Write access to the script component itself is implied
+		template<typename Script>
+		SystemAccess GetScriptAccess()
+		{
+			SystemAccess access;
+			if constexpr (DeclaresAccess<Script>::value)
+			{
+				Script::DeclareAccess(access);
+				access.Write<Script>();
+			}
+			else
+			{
+				access.Exclusive = true;
+			}
+			return access;
+		}
+	};
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Memory.h"
+
+namespace Cocoa
+{
+	// Where a container gets its memory from. Containers on one of the frame arenas never free anything, their memory goes
+	// away when the arena resets, so they must not be used past the end of the frame (or the next one for
+	// DoubleBufferedFrame). Handy for temporary lookups that get rebuilt every frame anyways
+	enum class AllocatorType : uint8
+	{
+		Heap = 0,
+		Frame,
+		DoubleBufferedFrame
+	};
+
+	namespace NContainerMemory
+	{
+		inline void* Allocate(AllocatorType allocator, size_t numBytes)
+		{
+			switch (allocator)
+			{
+			case AllocatorType::Frame:
+				return Memory::FrameAlloc(numBytes);
+			case AllocatorType::DoubleBufferedFrame:
+				return Memory::DoubleBufferedFrameAlloc(numBytes);
+			default:
+				return AllocMem(numBytes);
+			}
+		}
+
+		inline void* Reallocate(AllocatorType allocator, void* memory, size_t oldSize, size_t newSize)
+		{
+			if (allocator == AllocatorType::Heap)
+			{
+				return ReallocMem(memory, newSize);
+			}
+
+			// Arenas can't grow a block in place, copy it over and leave the old one for the reset
+			void* newMemory = Allocate(allocator, newSize);
+			if (memory)
+			{
+				memcpy(newMemory, memory, oldSize < newSize ? oldSize : newSize);
+			}
+			return newMemory;
+		}
+
+		inline void Free(AllocatorType allocator, void* memory)
+		{
+			if (allocator == AllocatorType::Heap && memory)
+			{
+				FreeMem(memory);
+			}
+		}
+	}
+}
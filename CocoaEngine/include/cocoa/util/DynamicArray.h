@@ -2,6 +2,7 @@
 #include "externalLibs.h"
 #include "cocoa/util/Log.h"
 #include "cocoa/core/Memory.h"
+#include "cocoa/util/ContainerMemory.h"
 
 namespace Cocoa
 {
@@ -14,23 +15,46 @@ namespace Cocoa
 		return memcmp(&e1, &e2, sizeof(T)) == 0;
 	}
 
+	// Elements get moved around with memcpy, so only use it for plain data
 	template<typename T>
 	struct DynamicArray
 	{
 		T* m_Data;
 		int m_NumElements;
 		int m_MaxSize;
+		AllocatorType m_Allocator;
 	};
 
 	namespace NDynamicArrayPrivate
 	{
+		// Arrays never shrink below this, small arrays going back and forth around a power of two would otherwise
+		// realloc on every other add or remove
+		constexpr int m_MinShrinkSize = 16;
+
+		template<typename T>
+		void Resize(DynamicArray<T>& data, int newMaxSize)
+		{
+			data.m_Data = (T*)NContainerMemory::Reallocate(data.m_Allocator, data.m_Data, sizeof(T) * data.m_MaxSize, sizeof(T) * newMaxSize);
+			data.m_MaxSize = newMaxSize;
+		}
+
 		template<typename T>
 		void CheckResize(DynamicArray<T>& data, int numElementsToAdd)
 		{
 			if (data.m_NumElements + numElementsToAdd > data.m_MaxSize)
 			{
-				data.m_MaxSize = (data.m_NumElements + numElementsToAdd) * 2;
-				data.m_Data = (T*)ReallocMem(data.m_Data, sizeof(T) * data.m_MaxSize);
+				Resize<T>(data, (data.m_NumElements + numElementsToAdd) * 2);
+			}
+		}
+
+		template<typename T>
+		void CheckShrink(DynamicArray<T>& data)
+		{
+			// Growing doubles the size, so only shrink once a quarter is left. An array that just grew has to lose half its
+			// elements before it shrinks again, which keeps adds and removes around the boundary from thrashing the allocator
+			if (data.m_Allocator == AllocatorType::Heap && data.m_MaxSize > m_MinShrinkSize && data.m_NumElements < data.m_MaxSize / 4)
+			{
+				Resize<T>(data, std::max(data.m_MaxSize / 2, m_MinShrinkSize));
 			}
 		}
 	}
@@ -38,7 +62,7 @@ namespace Cocoa
 	namespace NDynamicArray
 	{
 		template<typename T>
-		DynamicArray<T> Create(int size = 0)
+		DynamicArray<T> Create(int size = 0, AllocatorType allocator = AllocatorType::Heap)
 		{
 			DynamicArray<T> data;
 			Log::Assert(size >= 0, "Cannot initalize a dynamic array of with a negative size.");
@@ -48,7 +72,8 @@ namespace Cocoa
 				size = 1;
 			}
 
-			data.m_Data = (T*)AllocMem(sizeof(T) * size);
+			data.m_Allocator = allocator;
+			data.m_Data = (T*)NContainerMemory::Allocate(allocator, sizeof(T) * size);
 			data.m_NumElements = 0;
 			data.m_MaxSize = size;
 			return data;
@@ -59,29 +84,41 @@ namespace Cocoa
 		{
 			if (data.m_Data && data.m_MaxSize > 0)
 			{
-				FreeMem(data.m_Data);
+				NContainerMemory::Free(data.m_Allocator, data.m_Data);
 				data.m_Data = nullptr;
 			}
 		}
 
+		// Makes sure the array can hold capacity elements without growing
+		template<typename T>
+		void Reserve(DynamicArray<T>& data, int capacity)
+		{
+			if (capacity > data.m_MaxSize)
+			{
+				NDynamicArrayPrivate::Resize<T>(data, capacity);
+			}
+		}
+
 		template<typename T>
 		void Add(DynamicArray<T>& data, const T& element)
 		{
+			// Copy the element first, it might live in the buffer that's about to move
+			T copy = element;
 			NDynamicArrayPrivate::CheckResize<T>(data, 1);
-			data.m_Data[data.m_NumElements] = element;
+			data.m_Data[data.m_NumElements] = copy;
 			data.m_NumElements++;
 		}
 
+		// Shifts everything from index on back by one, index may be the size of the array to append
 		template<typename T>
 		void Insert(DynamicArray<T>& data, const T& element, int index)
 		{
-			Log::Assert(index >= 0 && index < data.m_NumElements, "Index out of bounds exception. Cannot insert element at '%d' in array of size '%d'.", index, data.m_NumElements);
+			Log::Assert(index >= 0 && index <= data.m_NumElements, "Index out of bounds exception. Cannot insert element at '%d' in array of size '%d'.", index, data.m_NumElements);
+			// Same as Add, the element might live in the array and get moved by the resize or the shift
+			T copy = element;
 			NDynamicArrayPrivate::CheckResize<T>(data, 1);
-			for (int i = data.m_NumElements + 1; i >= index; i--)
-			{
-				data.m_Data[i] = data.m_Data[i - 1];
-			}
-			data.m_Data[index] = element;
+			memmove(&data.m_Data[index + 1], &data.m_Data[index], sizeof(T) * (data.m_NumElements - index));
+			data.m_Data[index] = copy;
 			data.m_NumElements++;
 		}
 
@@ -91,7 +128,7 @@ namespace Cocoa
 		void Place(DynamicArray<T>& data, int index, const T* dataToAdd, uint32 numElementsToOverwrite)
 		{
 			Log::Assert(index >= 0 && index <= data.m_NumElements, "Index out of bounds exception. Cannot place data outside of array bounds, tried to place data at '%d' in array size '%d'", index, data.m_NumElements);
-			NDynamicArrayPrivate::CheckResize<T>(data, (index + numElementsToOverwrite) - data.m_MaxSize);
+			NDynamicArrayPrivate::CheckResize<T>(data, (index + numElementsToOverwrite) - data.m_NumElements);
 			memcpy(&data.m_Data[index], dataToAdd, sizeof(T) * numElementsToOverwrite);
 			if (index + numElementsToOverwrite > data.m_NumElements)
 			{
@@ -99,20 +136,28 @@ namespace Cocoa
 			}
 		}
 
+		// Keeps the order of the remaining elements, which means shifting everything after index. Use RemoveSwap if the
+		// order doesn't matter
 		template<typename T>
 		void Remove(DynamicArray<T>& data, int index)
 		{
-			for (int i = index; i < data.m_NumElements - 1; i++)
-			{
-				data.m_Data[i] = data.m_Data[i + 1];
-			}
+			Log::Assert(index >= 0 && index < data.m_NumElements, "Index out of bounds exception. Cannot remove element at '%d' in array of size '%d'.", index, data.m_NumElements);
+			memmove(&data.m_Data[index], &data.m_Data[index + 1], sizeof(T) * (data.m_NumElements - index - 1));
+			data.m_NumElements--;
+			NDynamicArrayPrivate::CheckShrink<T>(data);
+		}
 
+		// Moves the last element into the hole, so it's constant time but doesn't keep the order
+		template<typename T>
+		void RemoveSwap(DynamicArray<T>& data, int index)
+		{
+			Log::Assert(index >= 0 && index < data.m_NumElements, "Index out of bounds exception. Cannot remove element at '%d' in array of size '%d'.", index, data.m_NumElements);
 			data.m_NumElements--;
-			if (data.m_NumElements < (data.m_MaxSize / 2))
+			if (index != data.m_NumElements)
 			{
-				data.m_MaxSize /= 2;
-				data.m_Data = (T*)ReallocMem(data.m_Data, sizeof(T) * data.m_MaxSize);
+				data.m_Data[index] = data.m_Data[data.m_NumElements];
 			}
+			NDynamicArrayPrivate::CheckShrink<T>(data);
 		}
 
 		template<typename T>
@@ -168,10 +213,9 @@ namespace Cocoa
 			data.m_NumElements = 0;
 			if (freeMemory)
 			{
-				if (data.m_MaxSize != 1)
+				if (data.m_MaxSize != 1 && data.m_Allocator == AllocatorType::Heap)
 				{
-					data.m_MaxSize = 1;
-					data.m_Data = (T*)ReallocMem(data.m_Data, sizeof(T) * data.m_MaxSize);
+					NDynamicArrayPrivate::Resize<T>(data, 1);
 				}
 			}
 		}
@@ -179,7 +223,7 @@ namespace Cocoa
 		template<typename T>
 		int FindIndexOf(DynamicArray<T>& data, T& element)
 		{
-			// TODO: Horrible search, linear complexity can probably be improved
+			// Linear, arrays that get searched a lot should be a HashMap or HashSet instead
 			for (int i = 0; i < data.m_NumElements; i++)
 			{
 				if (memcmp(&data.m_Data[i], &element, sizeof(T)) == 0)
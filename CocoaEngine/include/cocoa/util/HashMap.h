@@ -0,0 +1,396 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/util/Log.h"
+#include "cocoa/util/ContainerMemory.h"
+
+#include <type_traits>
+
+namespace Cocoa
+{
+	// Open addressing hash map with linear probing. Keys and values live in flat arrays, so a lookup touches one or two
+	// cache lines instead of chasing a node per entry like std::unordered_map does. Keys are hashed and compared by their
+	// bytes, the same way DynamicArray compares elements, which means keys must not contain padding or pointers to the
+	// data that actually identifies them (hash the string, not the char*). Keys and values have to be plain data.
+	// Removing an element or growing the map moves other elements around, don't hold on to pointers into the map
+	template<typename K, typename V>
+	struct HashMap
+	{
+		K* m_Keys;
+		V* m_Values;
+		uint8* m_Occupied;
+		int m_NumElements;
+		// Always a power of two, zero until the first element is added
+		int m_Capacity;
+		AllocatorType m_Allocator;
+	};
+
+	namespace NHashMapPrivate
+	{
+		// Stands in for the value type of a HashSet, no memory gets allocated for it
+		struct NoValue {};
+
+		template<typename K>
+		uint64 Hash(const K& key)
+		{
+			uint64 hash;
+			if constexpr (sizeof(K) <= sizeof(uint64))
+			{
+				hash = 0;
+				memcpy(&hash, &key, sizeof(K));
+			}
+			else
+			{
+				// FNV-1a
+				hash = 14695981039346656037ull;
+				const uint8* bytes = (const uint8*)&key;
+				for (size_t i = 0; i < sizeof(K); i++)
+				{
+					hash = (hash ^ bytes[i]) * 1099511628211ull;
+				}
+			}
+
+			// Mix the bits, the slot comes from the low bits and sequential ids or aligned pointers would all collide
+			hash ^= hash >> 33;
+			hash *= 0xff51afd7ed558ccdull;
+			hash ^= hash >> 33;
+			hash *= 0xc4ceb9fe1a85ec53ull;
+			hash ^= hash >> 33;
+			return hash;
+		}
+
+		template<typename K>
+		bool KeysEqual(const K& a, const K& b)
+		{
+			return memcmp(&a, &b, sizeof(K)) == 0;
+		}
+
+		// Slot of the key, or of the empty slot it would go into
+		template<typename K, typename V>
+		int FindSlot(const HashMap<K, V>& map, const K& key)
+		{
+			int mask = map.m_Capacity - 1;
+			int slot = (int)(Hash(key) & mask);
+			while (map.m_Occupied[slot] && !KeysEqual(map.m_Keys[slot], key))
+			{
+				slot = (slot + 1) & mask;
+			}
+			return slot;
+		}
+
+		template<typename K, typename V>
+		void Rehash(HashMap<K, V>& map, int newCapacity)
+		{
+			K* oldKeys = map.m_Keys;
+			V* oldValues = map.m_Values;
+			uint8* oldOccupied = map.m_Occupied;
+			int oldCapacity = map.m_Capacity;
+
+			// One allocation for all three arrays, keys first so they get the alignment of the allocation
+			size_t keysSize = sizeof(K) * newCapacity;
+			size_t valuesOffset = (keysSize + alignof(V) - 1) & ~(alignof(V) - 1);
+			size_t valuesSize = std::is_same_v<V, NoValue> ? 0 : sizeof(V) * newCapacity;
+			uint8* memory = (uint8*)NContainerMemory::Allocate(map.m_Allocator, valuesOffset + valuesSize + newCapacity);
+			map.m_Keys = (K*)memory;
+			map.m_Values = std::is_same_v<V, NoValue> ? nullptr : (V*)(memory + valuesOffset);
+			map.m_Occupied = memory + valuesOffset + valuesSize;
+			map.m_Capacity = newCapacity;
+			memset(map.m_Occupied, 0, newCapacity);
+
+			for (int i = 0; i < oldCapacity; i++)
+			{
+				if (oldOccupied[i])
+				{
+					int slot = FindSlot(map, oldKeys[i]);
+					map.m_Keys[slot] = oldKeys[i];
+					if constexpr (!std::is_same_v<V, NoValue>)
+					{
+						map.m_Values[slot] = oldValues[i];
+					}
+					map.m_Occupied[slot] = 1;
+				}
+			}
+			NContainerMemory::Free(map.m_Allocator, oldKeys);
+		}
+
+		template<typename K, typename V>
+		void CheckResize(HashMap<K, V>& map, int numElementsToAdd)
+		{
+			// Probe sequences get long quickly past three quarters full
+			int numElements = map.m_NumElements + numElementsToAdd;
+			if (numElements * 4 > map.m_Capacity * 3)
+			{
+				int newCapacity = map.m_Capacity > 0 ? map.m_Capacity : 8;
+				while (numElements * 4 > newCapacity * 3)
+				{
+					newCapacity *= 2;
+				}
+				Rehash(map, newCapacity);
+			}
+		}
+
+		// Returns the slot of the key, adding it if it isn't in the map yet
+		template<typename K, typename V>
+		int Insert(HashMap<K, V>& map, const K& key, bool& outAdded)
+		{
+			// The key could live in the map, copy it before a rehash frees it
+			K copy = key;
+			CheckResize(map, 1);
+			int slot = FindSlot(map, copy);
+			outAdded = !map.m_Occupied[slot];
+			if (outAdded)
+			{
+				map.m_Keys[slot] = copy;
+				map.m_Occupied[slot] = 1;
+				map.m_NumElements++;
+			}
+			return slot;
+		}
+
+		template<typename K, typename V>
+		bool Remove(HashMap<K, V>& map, const K& key)
+		{
+			if (map.m_NumElements == 0)
+			{
+				return false;
+			}
+
+			int slot = FindSlot(map, key);
+			if (!map.m_Occupied[slot])
+			{
+				return false;
+			}
+
+			// Shift the following elements of the probe sequence back instead of leaving a tombstone, so lookups never
+			// have to walk over removed elements
+			int mask = map.m_Capacity - 1;
+			int hole = slot;
+			int next = (hole + 1) & mask;
+			while (map.m_Occupied[next])
+			{
+				int home = (int)(Hash(map.m_Keys[next]) & mask);
+				// Only move elements whose home slot doesn't lie between the hole and where they are now
+				if (((next - home) & mask) >= ((next - hole) & mask))
+				{
+					map.m_Keys[hole] = map.m_Keys[next];
+					if constexpr (!std::is_same_v<V, NoValue>)
+					{
+						map.m_Values[hole] = map.m_Values[next];
+					}
+					hole = next;
+				}
+				next = (next + 1) & mask;
+			}
+			map.m_Occupied[hole] = 0;
+			map.m_NumElements--;
+			return true;
+		}
+	}
+
+	namespace NHashMap
+	{
+		template<typename K, typename V>
+		HashMap<K, V> Create(int capacity = 0, AllocatorType allocator = AllocatorType::Heap)
+		{
+			static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>, "Hash maps only hold plain data.");
+			HashMap<K, V> map;
+			map.m_Keys = nullptr;
+			map.m_Values = nullptr;
+			map.m_Occupied = nullptr;
+			map.m_NumElements = 0;
+			map.m_Capacity = 0;
+			map.m_Allocator = allocator;
+			if (capacity > 0)
+			{
+				NHashMapPrivate::CheckResize(map, capacity);
+			}
+			return map;
+		}
+
+		template<typename K, typename V>
+		void Free(HashMap<K, V>& map)
+		{
+			NContainerMemory::Free(map.m_Allocator, map.m_Keys);
+			map.m_Keys = nullptr;
+			map.m_Values = nullptr;
+			map.m_Occupied = nullptr;
+			map.m_NumElements = 0;
+			map.m_Capacity = 0;
+		}
+
+		// Makes sure numElements fit without growing the map
+		template<typename K, typename V>
+		void Reserve(HashMap<K, V>& map, int numElements)
+		{
+			NHashMapPrivate::CheckResize(map, numElements - map.m_NumElements);
+		}
+
+		// Adds the key or overwrites its value if it's already in the map
+		template<typename K, typename V>
+		void Put(HashMap<K, V>& map, const K& key, const V& value)
+		{
+			// The value could live in the map, copy it before the map grows
+			V copy = value;
+			bool added;
+			int slot = NHashMapPrivate::Insert(map, key, added);
+			map.m_Values[slot] = copy;
+		}
+
+		// Returns the value of the key, adding it with defaultValue if it isn't in the map yet
+		template<typename K, typename V>
+		V& GetOrAdd(HashMap<K, V>& map, const K& key, const V& defaultValue = V())
+		{
+			V copy = defaultValue;
+			bool added;
+			int slot = NHashMapPrivate::Insert(map, key, added);
+			if (added)
+			{
+				map.m_Values[slot] = copy;
+			}
+			return map.m_Values[slot];
+		}
+
+		// Null if the key isn't in the map
+		template<typename K, typename V>
+		V* Get(HashMap<K, V>& map, const K& key)
+		{
+			if (map.m_NumElements == 0)
+			{
+				return nullptr;
+			}
+
+			int slot = NHashMapPrivate::FindSlot(map, key);
+			return map.m_Occupied[slot] ? &map.m_Values[slot] : nullptr;
+		}
+
+		template<typename K, typename V>
+		const V* Get(const HashMap<K, V>& map, const K& key)
+		{
+			if (map.m_NumElements == 0)
+			{
+				return nullptr;
+			}
+
+			int slot = NHashMapPrivate::FindSlot(map, key);
+			return map.m_Occupied[slot] ? &map.m_Values[slot] : nullptr;
+		}
+
+		template<typename K, typename V>
+		bool Contains(const HashMap<K, V>& map, const K& key)
+		{
+			return Get(map, key) != nullptr;
+		}
+
+		template<typename K, typename V>
+		bool Remove(HashMap<K, V>& map, const K& key)
+		{
+			return NHashMapPrivate::Remove(map, key);
+		}
+
+		// Keeps the memory around
+		template<typename K, typename V>
+		void Clear(HashMap<K, V>& map)
+		{
+			if (map.m_Capacity > 0)
+			{
+				memset(map.m_Occupied, 0, map.m_Capacity);
+			}
+			map.m_NumElements = 0;
+		}
+
+		template<typename K, typename V>
+		int Size(const HashMap<K, V>& map)
+		{
+			return map.m_NumElements;
+		}
+
+		// Calls func(key, value) for every element, in no particular order. Don't add or remove elements from inside func
+		template<typename K, typename V, typename Func>
+		void ForEach(HashMap<K, V>& map, Func func)
+		{
+			for (int i = 0; i < map.m_Capacity; i++)
+			{
+				if (map.m_Occupied[i])
+				{
+					func((const K&)map.m_Keys[i], map.m_Values[i]);
+				}
+			}
+		}
+	}
+
+	// Same as a HashMap, just without values
+	template<typename K>
+	struct HashSet
+	{
+		HashMap<K, NHashMapPrivate::NoValue> m_Table;
+	};
+
+	namespace NHashSet
+	{
+		template<typename K>
+		HashSet<K> Create(int capacity = 0, AllocatorType allocator = AllocatorType::Heap)
+		{
+			return { NHashMap::Create<K, NHashMapPrivate::NoValue>(capacity, allocator) };
+		}
+
+		template<typename K>
+		void Free(HashSet<K>& set)
+		{
+			NHashMap::Free(set.m_Table);
+		}
+
+		template<typename K>
+		void Reserve(HashSet<K>& set, int numElements)
+		{
+			NHashMap::Reserve(set.m_Table, numElements);
+		}
+
+		// Returns false if the key was in the set already
+		template<typename K>
+		bool Add(HashSet<K>& set, const K& key)
+		{
+			bool added;
+			NHashMapPrivate::Insert(set.m_Table, key, added);
+			return added;
+		}
+
+		template<typename K>
+		bool Contains(const HashSet<K>& set, const K& key)
+		{
+			if (set.m_Table.m_NumElements == 0)
+			{
+				return false;
+			}
+			return set.m_Table.m_Occupied[NHashMapPrivate::FindSlot(set.m_Table, key)] != 0;
+		}
+
+		template<typename K>
+		bool Remove(HashSet<K>& set, const K& key)
+		{
+			return NHashMapPrivate::Remove(set.m_Table, key);
+		}
+
+		template<typename K>
+		void Clear(HashSet<K>& set)
+		{
+			NHashMap::Clear(set.m_Table);
+		}
+
+		template<typename K>
+		int Size(const HashSet<K>& set)
+		{
+			return NHashMap::Size(set.m_Table);
+		}
+
+		template<typename K, typename Func>
+		void ForEach(const HashSet<K>& set, Func func)
+		{
+			for (int i = 0; i < set.m_Table.m_Capacity; i++)
+			{
+				if (set.m_Table.m_Occupied[i])
+				{
+					func((const K&)set.m_Table.m_Keys[i]);
+				}
+			}
+		}
+	}
+}
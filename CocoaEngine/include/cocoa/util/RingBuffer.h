@@ -0,0 +1,175 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/util/Log.h"
+#include "cocoa/util/ContainerMemory.h"
+
+namespace Cocoa
+{
+	// Double ended queue in one block of memory. Pushing and popping at either end is constant time and never moves
+	// the other elements, the buffer only reallocates once it's full. Elements get moved around with memcpy, so only
+	// use it for plain data
+	template<typename T>
+	struct RingBuffer
+	{
+		T* m_Data;
+		// Index of the front element in m_Data
+		int m_Head;
+		int m_NumElements;
+		// Always a power of two so wrapping around is a mask, zero until the first element is pushed
+		int m_Capacity;
+		AllocatorType m_Allocator;
+	};
+
+	namespace NRingBufferPrivate
+	{
+		template<typename T>
+		void Resize(RingBuffer<T>& buffer, int newCapacity)
+		{
+			// Unwrap the elements into the new block so the head starts at 0 again
+			T* newData = (T*)NContainerMemory::Allocate(buffer.m_Allocator, sizeof(T) * newCapacity);
+			if (buffer.m_NumElements > 0)
+			{
+				int firstPart = buffer.m_Capacity - buffer.m_Head;
+				if (firstPart > buffer.m_NumElements)
+				{
+					firstPart = buffer.m_NumElements;
+				}
+				memcpy(newData, &buffer.m_Data[buffer.m_Head], sizeof(T) * firstPart);
+				memcpy(&newData[firstPart], buffer.m_Data, sizeof(T) * (buffer.m_NumElements - firstPart));
+			}
+			NContainerMemory::Free(buffer.m_Allocator, buffer.m_Data);
+			buffer.m_Data = newData;
+			buffer.m_Head = 0;
+			buffer.m_Capacity = newCapacity;
+		}
+
+		template<typename T>
+		void CheckResize(RingBuffer<T>& buffer)
+		{
+			if (buffer.m_NumElements == buffer.m_Capacity)
+			{
+				Resize(buffer, buffer.m_Capacity > 0 ? buffer.m_Capacity * 2 : 8);
+			}
+		}
+	}
+
+	namespace NRingBuffer
+	{
+		template<typename T>
+		RingBuffer<T> Create(int capacity = 0, AllocatorType allocator = AllocatorType::Heap)
+		{
+			Log::Assert(capacity >= 0, "Cannot initalize a ring buffer with a negative capacity.");
+			RingBuffer<T> buffer;
+			buffer.m_Data = nullptr;
+			buffer.m_Head = 0;
+			buffer.m_NumElements = 0;
+			buffer.m_Capacity = 0;
+			buffer.m_Allocator = allocator;
+			if (capacity > 0)
+			{
+				int powerOfTwo = 8;
+				while (powerOfTwo < capacity)
+				{
+					powerOfTwo *= 2;
+				}
+				NRingBufferPrivate::Resize(buffer, powerOfTwo);
+			}
+			return buffer;
+		}
+
+		template<typename T>
+		void Free(RingBuffer<T>& buffer)
+		{
+			NContainerMemory::Free(buffer.m_Allocator, buffer.m_Data);
+			buffer.m_Data = nullptr;
+			buffer.m_Head = 0;
+			buffer.m_NumElements = 0;
+			buffer.m_Capacity = 0;
+		}
+
+		template<typename T>
+		void Reserve(RingBuffer<T>& buffer, int capacity)
+		{
+			if (capacity > buffer.m_Capacity)
+			{
+				int newCapacity = buffer.m_Capacity > 0 ? buffer.m_Capacity : 8;
+				while (newCapacity < capacity)
+				{
+					newCapacity *= 2;
+				}
+				NRingBufferPrivate::Resize(buffer, newCapacity);
+			}
+		}
+
+		template<typename T>
+		void PushBack(RingBuffer<T>& buffer, const T& element)
+		{
+			T copy = element;
+			NRingBufferPrivate::CheckResize(buffer);
+			buffer.m_Data[(buffer.m_Head + buffer.m_NumElements) & (buffer.m_Capacity - 1)] = copy;
+			buffer.m_NumElements++;
+		}
+
+		template<typename T>
+		void PushFront(RingBuffer<T>& buffer, const T& element)
+		{
+			T copy = element;
+			NRingBufferPrivate::CheckResize(buffer);
+			buffer.m_Head = (buffer.m_Head - 1) & (buffer.m_Capacity - 1);
+			buffer.m_Data[buffer.m_Head] = copy;
+			buffer.m_NumElements++;
+		}
+
+		template<typename T>
+		T PopFront(RingBuffer<T>& buffer)
+		{
+			Log::Assert(buffer.m_NumElements > 0, "Cannot pop empty ring buffer.");
+			T element = buffer.m_Data[buffer.m_Head];
+			buffer.m_Head = (buffer.m_Head + 1) & (buffer.m_Capacity - 1);
+			buffer.m_NumElements--;
+			return element;
+		}
+
+		template<typename T>
+		T PopBack(RingBuffer<T>& buffer)
+		{
+			Log::Assert(buffer.m_NumElements > 0, "Cannot pop empty ring buffer.");
+			buffer.m_NumElements--;
+			return buffer.m_Data[(buffer.m_Head + buffer.m_NumElements) & (buffer.m_Capacity - 1)];
+		}
+
+		// Index 0 is the front
+		template<typename T>
+		T& Get(RingBuffer<T>& buffer, int index)
+		{
+			Log::Assert(index >= 0 && index < buffer.m_NumElements, "Index out of bounds exception. '%d' in ring buffer size '%d'.", index, buffer.m_NumElements);
+			return buffer.m_Data[(buffer.m_Head + index) & (buffer.m_Capacity - 1)];
+		}
+
+		template<typename T>
+		T& Front(RingBuffer<T>& buffer)
+		{
+			return Get(buffer, 0);
+		}
+
+		template<typename T>
+		T& Back(RingBuffer<T>& buffer)
+		{
+			return Get(buffer, buffer.m_NumElements - 1);
+		}
+
+		template<typename T>
+		int Size(const RingBuffer<T>& buffer)
+		{
+			return buffer.m_NumElements;
+		}
+
+		// Keeps the memory
+		template<typename T>
+		void Clear(RingBuffer<T>& buffer)
+		{
+			buffer.m_Head = 0;
+			buffer.m_NumElements = 0;
+		}
+	}
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/util/Log.h"
+#include "cocoa/util/DynamicArray.h"
+
+namespace Cocoa
+{
+	// Stays valid until the element it points to is removed, after that lookups with it fail instead of returning
+	// whatever took the slot over. A generation of 0 is never handed out, so a zeroed handle is always null
+	struct SlotHandle
+	{
+		uint32 Index;
+		uint32 Generation;
+	};
+
+	namespace NSlotHandle
+	{
+		inline SlotHandle CreateNull()
+		{
+			return { 0, 0 };
+		}
+
+		inline bool IsNull(const SlotHandle& handle)
+		{
+			return handle.Generation == 0;
+		}
+	}
+
+	namespace NSlotMapPrivate
+	{
+		struct Slot
+		{
+			// Where the element lives in m_Values while the slot is in use
+			int DenseIndex;
+			uint32 Generation;
+			// Next free slot while the slot is unused, -1 ends the list
+			int NextFree;
+		};
+	}
+
+	// Elements are packed at the front of one array so iterating over them is as fast as iterating over a DynamicArray.
+	// Removing swaps the last element into the hole, handles go through a slot that keeps track of where the element
+	// went. Elements get moved around with memcpy, so only use it for plain data
+	template<typename T>
+	struct SlotMap
+	{
+		DynamicArray<T> m_Values;
+		// Slot of every element in m_Values, needed to fix up the slot of the element that gets swapped on remove
+		DynamicArray<int> m_DenseToSlot;
+		DynamicArray<NSlotMapPrivate::Slot> m_Slots;
+		int m_FreeList;
+	};
+
+	namespace NSlotMap
+	{
+		template<typename T>
+		SlotMap<T> Create(int capacity = 0, AllocatorType allocator = AllocatorType::Heap)
+		{
+			SlotMap<T> map;
+			map.m_Values = NDynamicArray::Create<T>(capacity, allocator);
+			map.m_DenseToSlot = NDynamicArray::Create<int>(capacity, allocator);
+			map.m_Slots = NDynamicArray::Create<NSlotMapPrivate::Slot>(capacity, allocator);
+			map.m_FreeList = -1;
+			return map;
+		}
+
+		template<typename T>
+		void Free(SlotMap<T>& map)
+		{
+			NDynamicArray::Free(map.m_Values);
+			NDynamicArray::Free(map.m_DenseToSlot);
+			NDynamicArray::Free(map.m_Slots);
+			map.m_FreeList = -1;
+		}
+
+		template<typename T>
+		SlotHandle Insert(SlotMap<T>& map, const T& element)
+		{
+			// The element might live in the map, copy it before anything grows
+			T copy = element;
+			int slotIndex = map.m_FreeList;
+			if (slotIndex >= 0)
+			{
+				map.m_FreeList = map.m_Slots.m_Data[slotIndex].NextFree;
+			}
+			else
+			{
+				slotIndex = map.m_Slots.m_NumElements;
+				NDynamicArray::Add<NSlotMapPrivate::Slot>(map.m_Slots, { 0, 1, -1 });
+			}
+
+			NSlotMapPrivate::Slot& slot = map.m_Slots.m_Data[slotIndex];
+			slot.DenseIndex = map.m_Values.m_NumElements;
+			NDynamicArray::Add<T>(map.m_Values, copy);
+			NDynamicArray::Add<int>(map.m_DenseToSlot, slotIndex);
+			return { (uint32)slotIndex, slot.Generation };
+		}
+
+		template<typename T>
+		bool Contains(const SlotMap<T>& map, SlotHandle handle)
+		{
+			return handle.Index < (uint32)map.m_Slots.m_NumElements && map.m_Slots.m_Data[handle.Index].Generation == handle.Generation
+				&& handle.Generation != 0;
+		}
+
+		// Null if the element was removed. The pointer is only good until the next insert or remove
+		template<typename T>
+		T* Get(SlotMap<T>& map, SlotHandle handle)
+		{
+			if (!Contains(map, handle))
+			{
+				return nullptr;
+			}
+			return &map.m_Values.m_Data[map.m_Slots.m_Data[handle.Index].DenseIndex];
+		}
+
+		template<typename T>
+		bool Remove(SlotMap<T>& map, SlotHandle handle)
+		{
+			if (!Contains(map, handle))
+			{
+				return false;
+			}
+
+			NSlotMapPrivate::Slot& slot = map.m_Slots.m_Data[handle.Index];
+			int denseIndex = slot.DenseIndex;
+			int lastIndex = map.m_Values.m_NumElements - 1;
+			if (denseIndex != lastIndex)
+			{
+				int movedSlot = map.m_DenseToSlot.m_Data[lastIndex];
+				map.m_Slots.m_Data[movedSlot].DenseIndex = denseIndex;
+			}
+			NDynamicArray::RemoveSwap(map.m_Values, denseIndex);
+			NDynamicArray::RemoveSwap(map.m_DenseToSlot, denseIndex);
+
+			// Skip 0 when the generation wraps around, it's reserved for null handles
+			slot.Generation++;
+			if (slot.Generation == 0)
+			{
+				slot.Generation = 1;
+			}
+			slot.NextFree = map.m_FreeList;
+			map.m_FreeList = (int)handle.Index;
+			return true;
+		}
+
+		template<typename T>
+		int Size(const SlotMap<T>& map)
+		{
+			return map.m_Values.m_NumElements;
+		}
+
+		// Invalidates every handle, the memory is kept
+		template<typename T>
+		void Clear(SlotMap<T>& map)
+		{
+			map.m_FreeList = -1;
+			for (int i = map.m_Slots.m_NumElements - 1; i >= 0; i--)
+			{
+				NSlotMapPrivate::Slot& slot = map.m_Slots.m_Data[i];
+				slot.Generation++;
+				if (slot.Generation == 0)
+				{
+					slot.Generation = 1;
+				}
+				slot.NextFree = map.m_FreeList;
+				map.m_FreeList = i;
+			}
+			NDynamicArray::Clear(map.m_Values, false);
+			NDynamicArray::Clear(map.m_DenseToSlot, false);
+		}
+
+		template<typename T>
+		T* Begin(SlotMap<T>& map)
+		{
+			return NDynamicArray::Begin(map.m_Values);
+		}
+
+		template<typename T>
+		T* End(SlotMap<T>& map)
+		{
+			return NDynamicArray::End(map.m_Values);
+		}
+	}
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/util/Log.h"
+#include "cocoa/util/ContainerMemory.h"
+
+namespace Cocoa
+{
+	// Array that keeps its first N elements inside the struct itself and only allocates once it grows past them. Meant
+	// for the many small lists that almost never hold more than a handful of elements. Elements get moved around with
+	// memcpy, so only use it for plain data
+	template<typename T, int N>
+	struct SmallVector
+	{
+		// Null as long as the elements fit into m_InlineData
+		T* m_HeapData;
+		int m_NumElements;
+		int m_MaxSize;
+		AllocatorType m_Allocator;
+		alignas(T) uint8 m_InlineData[sizeof(T) * N];
+	};
+
+	namespace NSmallVector
+	{
+		template<typename T, int N>
+		SmallVector<T, N> Create(AllocatorType allocator = AllocatorType::Heap)
+		{
+			static_assert(N > 0, "A small vector needs room for at least one element inline.");
+			SmallVector<T, N> data;
+			data.m_HeapData = nullptr;
+			data.m_NumElements = 0;
+			data.m_MaxSize = N;
+			data.m_Allocator = allocator;
+			return data;
+		}
+
+		template<typename T, int N>
+		void Free(SmallVector<T, N>& data)
+		{
+			NContainerMemory::Free(data.m_Allocator, data.m_HeapData);
+			data.m_HeapData = nullptr;
+			data.m_NumElements = 0;
+			data.m_MaxSize = N;
+		}
+
+		template<typename T, int N>
+		T* Data(SmallVector<T, N>& data)
+		{
+			return data.m_HeapData ? data.m_HeapData : (T*)data.m_InlineData;
+		}
+
+		template<typename T, int N>
+		const T* Data(const SmallVector<T, N>& data)
+		{
+			return data.m_HeapData ? data.m_HeapData : (const T*)data.m_InlineData;
+		}
+
+		template<typename T, int N>
+		void Reserve(SmallVector<T, N>& data, int capacity)
+		{
+			if (capacity <= data.m_MaxSize)
+			{
+				return;
+			}
+
+			if (data.m_HeapData)
+			{
+				data.m_HeapData = (T*)NContainerMemory::Reallocate(data.m_Allocator, data.m_HeapData, sizeof(T) * data.m_MaxSize, sizeof(T) * capacity);
+			}
+			else
+			{
+				data.m_HeapData = (T*)NContainerMemory::Allocate(data.m_Allocator, sizeof(T) * capacity);
+				memcpy(data.m_HeapData, data.m_InlineData, sizeof(T) * data.m_NumElements);
+			}
+			data.m_MaxSize = capacity;
+		}
+
+		template<typename T, int N>
+		void Add(SmallVector<T, N>& data, const T& element)
+		{
+			if (data.m_NumElements == data.m_MaxSize)
+			{
+				// Copy the element first, it might live in the buffer that's about to move
+				T copy = element;
+				Reserve(data, data.m_MaxSize * 2);
+				Data(data)[data.m_NumElements] = copy;
+			}
+			else
+			{
+				Data(data)[data.m_NumElements] = element;
+			}
+			data.m_NumElements++;
+		}
+
+		template<typename T, int N>
+		T& Get(SmallVector<T, N>& data, int index)
+		{
+			Log::Assert(index >= 0 && index < data.m_NumElements, "Index out of bounds exception. '%d' in small vector size '%d'.", index, data.m_NumElements);
+			return Data(data)[index];
+		}
+
+		template<typename T, int N>
+		const T& Get(const SmallVector<T, N>& data, int index)
+		{
+			Log::Assert(index >= 0 && index < data.m_NumElements, "Index out of bounds exception. '%d' in small vector size '%d'.", index, data.m_NumElements);
+			return Data(data)[index];
+		}
+
+		template<typename T, int N>
+		T Pop(SmallVector<T, N>& data)
+		{
+			Log::Assert(data.m_NumElements > 0, "Cannot pop empty small vector.");
+			data.m_NumElements--;
+			return Data(data)[data.m_NumElements];
+		}
+
+		template<typename T, int N>
+		void Remove(SmallVector<T, N>& data, int index)
+		{
+			Log::Assert(index >= 0 && index < data.m_NumElements, "Index out of bounds exception. Cannot remove element at '%d' in small vector size '%d'.", index, data.m_NumElements);
+			T* elements = Data(data);
+			memmove(&elements[index], &elements[index + 1], sizeof(T) * (data.m_NumElements - index - 1));
+			data.m_NumElements--;
+		}
+
+		template<typename T, int N>
+		void RemoveSwap(SmallVector<T, N>& data, int index)
+		{
+			Log::Assert(index >= 0 && index < data.m_NumElements, "Index out of bounds exception. Cannot remove element at '%d' in small vector size '%d'.", index, data.m_NumElements);
+			T* elements = Data(data);
+			data.m_NumElements--;
+			elements[index] = elements[data.m_NumElements];
+		}
+
+		// Keeps the memory, a small vector that spilled onto the heap once is likely to do it again
+		template<typename T, int N>
+		void Clear(SmallVector<T, N>& data)
+		{
+			data.m_NumElements = 0;
+		}
+
+		template<typename T, int N>
+		T* Begin(SmallVector<T, N>& data)
+		{
+			return Data(data);
+		}
+
+		template<typename T, int N>
+		T* End(SmallVector<T, N>& data)
+		{
+			return Data(data) + data.m_NumElements;
+		}
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include "externalLibs.h"
+#include "cocoa/core/Core.h"
+
+namespace Cocoa
+{
+	namespace Utf8
+	{
+		// Returned for malformed sequences, so bad input renders as a visible glyph instead of being dropped silently
+		static const uint32 ReplacementCharacter = 0xFFFD;
+
+		// Decodes the codepoint starting at str[index] and advances index past it. Never reads past length
+		COCOA uint32 DecodeNext(const char* str, int length, int& index);
+	}
+}
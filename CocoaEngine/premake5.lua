@@ -70,6 +70,9 @@ project "CocoaEngine"
 			"copy /y \"$(SolutionDir)CocoaEngine\\vendor\\GLFW\\bin\\%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}\\GLFW\\GLFW.dll\" \"$(OutDir)..\\CocoaEditor\\GLFW.dll\""
 		}
     
+	filter "options:engine-allocator"
+		defines "_COCOA_ENGINE_ALLOCATOR"
+
 	filter "configurations:Debug"
 		defines {
 			"_COCOA_DEBUG",